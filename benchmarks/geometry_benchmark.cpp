@@ -0,0 +1,126 @@
+// Benchmarks for the per-frame view geometry behind PlotView: grid lines
+// (createGridData), axis number anchors (renderAxisNumbers), data series
+// vertices (addDataSeries) and hover picking (findNearestOnScreen).
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "plot_geometry.h"
+#include "point_octree.h"
+
+namespace {
+
+// Zoom levels across the range the view allows, panned off the origin
+GridLayout layoutForZoom(float zoom)
+{
+    return computeGridLayout(10.0f * zoom, 0.37f * zoom, -1.21f * zoom, 2.05f * zoom, 0.8, 0.5);
+}
+
+void BM_GridLayout(benchmark::State& state)
+{
+    const float zoom = static_cast<float>(state.range(0)) / 100.0f;
+    for (auto _ : state) {
+        GridLayout layout = layoutForZoom(zoom);
+        benchmark::DoNotOptimize(layout);
+    }
+}
+BENCHMARK(BM_GridLayout)->Arg(10)->Arg(100)->Arg(1000);
+
+void BM_GridVertices(benchmark::State& state)
+{
+    const GridLayout layout = layoutForZoom(static_cast<float>(state.range(0)) / 100.0f);
+    std::vector<float> vertices;
+    for (auto _ : state) {
+        buildGridVertices(layout, vertices);
+        benchmark::DoNotOptimize(vertices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(vertices.size() / 6));
+}
+BENCHMARK(BM_GridVertices)->Arg(10)->Arg(100)->Arg(1000);
+
+// Full createGridData() math as run on every pan, zoom and rotation
+void BM_CreateGridData(benchmark::State& state)
+{
+    std::vector<float> vertices;
+    float pan = 0.0f;
+    for (auto _ : state) {
+        pan += 0.01f;
+        const GridLayout layout = computeGridLayout(10.0f, pan, pan * 0.5f, -pan, 0.8, 0.5);
+        buildGridVertices(layout, vertices);
+        benchmark::DoNotOptimize(vertices.data());
+    }
+}
+BENCHMARK(BM_CreateGridData);
+
+// renderAxisNumbers() math: layout plus tick anchors, projection excluded
+void BM_AxisTicks(benchmark::State& state)
+{
+    const bool includeZ = state.range(0) != 0;
+    std::vector<GridTick> ticks;
+    float pan = 0.0f;
+    for (auto _ : state) {
+        pan += 0.01f;
+        const GridLayout layout = computeGridLayout(10.0f, pan, pan * 0.5f, -pan, 0.8, 0.5);
+        buildGridTicks(layout, includeZ, ticks);
+        benchmark::DoNotOptimize(ticks.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(ticks.size()));
+}
+BENCHMARK(BM_AxisTicks)->Arg(0)->Arg(1);
+
+void BM_SeriesVertices(benchmark::State& state)
+{
+    const size_t count = static_cast<size_t>(state.range(0));
+    std::vector<float> xData(count), yData(count), zData(count);
+    for (size_t i = 0; i < count; ++i) {
+        xData[i] = i * 0.001f;
+        yData[i] = std::sin(i * 0.01f);
+        zData[i] = std::cos(i * 0.01f);
+    }
+
+    std::vector<float> vertices;
+    for (auto _ : state) {
+        buildSeriesVertices(xData, yData, zData, vertices);
+        benchmark::DoNotOptimize(vertices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(vertices.size() * sizeof(float)));
+}
+BENCHMARK(BM_SeriesVertices)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// Hover pick over a streamed 3D trajectory; picking has to stay under 1 ms
+// at 10M points
+void BM_OctreePick(benchmark::State& state)
+{
+    const size_t count = static_cast<size_t>(state.range(0));
+    PointOctree octree;
+    for (size_t i = 0; i < count; ++i) {
+        const float t = i * 1e-5f;
+        octree.insert({std::cos(t * 7.0f) * (1.0f + 0.1f * std::sin(t * 131.0f)),
+                       std::sin(t * 7.0f) * (1.0f + 0.1f * std::cos(t * 113.0f)),
+                       std::fmod(t, 2.0f) - 1.0f, static_cast<uint32_t>(i)});
+    }
+
+    // Orthographic view of the whole trajectory
+    constexpr float VIEWPORT = 1000.0f;
+    const float mvp[16] = {0.8f, 0, 0, 0, 0, 0.8f, 0, 0, 0, 0, 0.5f, 0, 0, 0, 0, 1};
+
+    // Cursor positions sweeping the viewport, both on and off the data
+    uint32_t seed = 12345;
+    size_t found = 0;
+    PointOctree::Point point;
+    for (auto _ : state) {
+        seed = seed * 1664525u + 1013904223u;
+        const float x = static_cast<float>(seed >> 8 & 0x3ff);
+        const float y = static_cast<float>(seed >> 18 & 0x3ff);
+        found += octree.findNearestOnScreen(mvp, VIEWPORT, VIEWPORT, x, y, 10.0f, nullptr, point);
+    }
+    state.counters["hitRate"] = static_cast<double>(found) / state.iterations();
+    state.SetLabel(std::to_string(octree.size()) + " points");
+}
+BENCHMARK(BM_OctreePick)->Arg(1000000)->Arg(10000000)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
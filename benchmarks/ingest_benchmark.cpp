@@ -0,0 +1,170 @@
+// Benchmarks for DataReceiver's ingest path: line parsing
+// (processIncomingData), text and binary framing of socket reads
+// (onDataReady) and lock contention between the receiver thread and the
+// render thread (addDataPoint / getLatestData).
+
+#include <benchmark/benchmark.h>
+#include <QCoreApplication>
+#include <QByteArray>
+#include <QtEndian>
+#include <cmath>
+#include <vector>
+#include "data_receiver.h"
+
+namespace {
+
+DataReceiver* g_sharedReceiver = nullptr;
+
+std::vector<QByteArray> makeCsvLines(int count)
+{
+    std::vector<QByteArray> lines;
+    lines.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        lines.push_back(QByteArray::number(i * 0.001, 'f', 6) + ',' +
+                        QByteArray::number(std::sin(i * 0.01), 'f', 6) + ',' +
+                        QByteArray::number(i % 4));
+    }
+    return lines;
+}
+
+std::vector<QByteArray> makeJsonLines(int count)
+{
+    std::vector<QByteArray> lines;
+    lines.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        lines.push_back("{\"timestamp\":" + QByteArray::number(i * 0.001, 'f', 6) +
+                        ",\"value\":" + QByteArray::number(std::sin(i * 0.01), 'f', 6) +
+                        ",\"channel\":" + QByteArray::number(i % 4) + "}");
+    }
+    return lines;
+}
+
+void parseLines(benchmark::State& state, const std::vector<QByteArray>& lines)
+{
+    int64_t bytes = 0;
+    for (const auto& line : lines) {
+        bytes += line.size();
+    }
+
+    DataPoint point;
+    for (auto _ : state) {
+        for (const auto& line : lines) {
+            benchmark::DoNotOptimize(DataReceiver::parseMessage(line, point));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(lines.size()));
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+void BM_ParseCsv(benchmark::State& state)
+{
+    parseLines(state, makeCsvLines(1000));
+}
+BENCHMARK(BM_ParseCsv);
+
+void BM_ParseJson(benchmark::State& state)
+{
+    parseLines(state, makeJsonLines(1000));
+}
+BENCHMARK(BM_ParseJson);
+
+// Socket reads split at arbitrary points, as onDataReady sees them
+void BM_FeedData(benchmark::State& state)
+{
+    const int chunkSize = static_cast<int>(state.range(0));
+    QByteArray stream;
+    for (const auto& line : makeCsvLines(10000)) {
+        stream += line + '\n';
+    }
+    std::vector<QByteArray> chunks;
+    for (int offset = 0; offset < stream.size(); offset += chunkSize) {
+        chunks.push_back(stream.mid(offset, chunkSize));
+    }
+
+    DataReceiver receiver;
+    double arrivalTime = 0.0;
+    for (auto _ : state) {
+        for (const auto& chunk : chunks) {
+            arrivalTime += 1e-3;
+            receiver.feedData(chunk, arrivalTime);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 10000);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(stream.size()));
+}
+BENCHMARK(BM_FeedData)->Arg(64)->Arg(1460)->Arg(65536);
+
+// The same samples as load_generator --format binary sends them
+void BM_FeedBinaryData(benchmark::State& state)
+{
+    const int chunkSize = static_cast<int>(state.range(0));
+    QByteArray stream(10000 * DataReceiver::BINARY_RECORD_SIZE, Qt::Uninitialized);
+    for (int i = 0; i < 10000; ++i) {
+        char* record = stream.data() + i * DataReceiver::BINARY_RECORD_SIZE;
+        qToLittleEndian(i * 0.001, record);
+        qToLittleEndian(static_cast<float>(std::sin(i * 0.01)), record + 8);
+        qToLittleEndian(static_cast<qint32>(i % 4), record + 12);
+    }
+    std::vector<QByteArray> chunks;
+    for (int offset = 0; offset < stream.size(); offset += chunkSize) {
+        chunks.push_back(stream.mid(offset, chunkSize));
+    }
+
+    DataReceiver receiver;
+    receiver.setInputFormat(DataReceiver::BINARY_INPUT);
+    double arrivalTime = 0.0;
+    for (auto _ : state) {
+        for (const auto& chunk : chunks) {
+            arrivalTime += 1e-3;
+            receiver.feedData(chunk, arrivalTime);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 10000);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(stream.size()));
+}
+BENCHMARK(BM_FeedBinaryData)->Arg(64)->Arg(1460)->Arg(65536);
+
+// Thread 0 copies the queue like the render thread does each frame, the
+// others insert samples like the receiver thread
+void BM_AddGetContention(benchmark::State& state)
+{
+    DataReceiver& receiver = *g_sharedReceiver;
+    const bool reader = state.thread_index() == 0;
+
+    double timestamp = 0.0;
+    size_t copied = 0;
+    for (auto _ : state) {
+        if (reader) {
+            const std::vector<DataPoint> data = receiver.getLatestData();
+            copied += data.size();
+        } else {
+            timestamp += 1e-3;
+            receiver.addDataPoint(DataPoint(timestamp, 1.0f, state.thread_index()));
+        }
+    }
+
+    if (reader) {
+        state.counters["copied_per_read"] =
+            benchmark::Counter(static_cast<double>(copied), benchmark::Counter::kAvgIterations);
+    }
+}
+BENCHMARK(BM_AddGetContention)->Threads(2)->Threads(4)->UseRealTime();
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    // DataReceiver owns QObjects and timers
+    QCoreApplication app(argc, argv);
+
+    DataReceiver sharedReceiver;
+    g_sharedReceiver = &sharedReceiver;
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,569 @@
+// Load generator for the data receiver.
+//
+// Streams synthetic multi-channel samples at a fixed rate, optionally in
+// on/off bursts, as CSV, JSON or binary records over TCP, UDP, a Unix
+// socket or a pseudo terminal, and reports the rate it actually achieved.
+//
+// Records:
+//   csv     "timestamp,value,channel\n"
+//   json    {"timestamp":t,"value":v,"channel":c}\n
+//   binary  16 bytes little endian: float64 timestamp, float32 value, int32 channel
+//           (DataReceiver::BINARY_INPUT, e.g. "source listen 8080 binary"
+//           on the debug port)
+//
+// The receiver reads only TCP so far; the other transports are for
+// inputs it does not have yet (UDP and serial are planned in TODO).
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+enum Format {
+    CSV_FORMAT,
+    JSON_FORMAT,
+    BINARY_FORMAT
+};
+
+enum Transport {
+    TCP_TRANSPORT,
+    UDP_TRANSPORT,
+    UNIX_TRANSPORT,
+    PTY_TRANSPORT
+};
+
+struct Options {
+    Format format = CSV_FORMAT;
+    Transport transport = TCP_TRANSPORT;
+    std::string host = "127.0.0.1";
+    int port = 8080;
+    std::string path;            // Unix socket path
+    int channels = 1;
+    double rate = 1000.0;        // Samples per second over all channels
+    double duration = 10.0;      // Seconds, 0 runs until interrupted
+    double burstOn = 0.0;        // Seconds sending per burst, 0 sends continuously
+    double burstOff = 0.0;       // Seconds idle between bursts
+    int batchSamples = 4096;     // Most samples per write
+    int packetSize = 1400;       // UDP datagram limit in bytes
+    double noise = 0.05;
+    bool quiet = false;
+};
+
+volatile sig_atomic_t g_stop = 0;
+
+void onSignal(int)
+{
+    g_stop = 1;
+}
+
+void printUsage(const char* program)
+{
+    std::fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  --format csv|json|binary   Record encoding (csv)\n"
+        "  --transport tcp|udp|unix|pty\n"
+        "                             Where to send (tcp)\n"
+        "  --host HOST                TCP/UDP destination (127.0.0.1)\n"
+        "  --port PORT                TCP/UDP port (8080)\n"
+        "  --path PATH                Unix socket path\n"
+        "  --channels N               Channels, sampled together (1)\n"
+        "  --rate N                   Samples per second over all channels (1000)\n"
+        "  --duration S               Seconds to run, 0 until Ctrl-C (10)\n"
+        "  --burst ON:OFF             Send for ON seconds, pause for OFF seconds\n"
+        "  --batch N                  Most samples per write (4096)\n"
+        "  --packet-size N            UDP datagram size limit in bytes (1400)\n"
+        "  --noise A                  Noise amplitude added to the sines (0.05)\n"
+        "  --quiet                    Only print the final summary\n",
+        program);
+}
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--quiet") {
+            options.quiet = true;
+            continue;
+        }
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        }
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+            return false;
+        }
+
+        const std::string value = argv[++i];
+        if (arg == "--format") {
+            if (value == "csv") options.format = CSV_FORMAT;
+            else if (value == "json") options.format = JSON_FORMAT;
+            else if (value == "binary") options.format = BINARY_FORMAT;
+            else {
+                std::fprintf(stderr, "Unknown format: %s\n", value.c_str());
+                return false;
+            }
+        } else if (arg == "--transport") {
+            if (value == "tcp") options.transport = TCP_TRANSPORT;
+            else if (value == "udp") options.transport = UDP_TRANSPORT;
+            else if (value == "unix") options.transport = UNIX_TRANSPORT;
+            else if (value == "pty") options.transport = PTY_TRANSPORT;
+            else {
+                std::fprintf(stderr, "Unknown transport: %s\n", value.c_str());
+                return false;
+            }
+        } else if (arg == "--host") {
+            options.host = value;
+        } else if (arg == "--port") {
+            options.port = std::atoi(value.c_str());
+        } else if (arg == "--path") {
+            options.path = value;
+        } else if (arg == "--channels") {
+            options.channels = std::atoi(value.c_str());
+        } else if (arg == "--rate") {
+            options.rate = std::atof(value.c_str());
+        } else if (arg == "--duration") {
+            options.duration = std::atof(value.c_str());
+        } else if (arg == "--burst") {
+            const size_t colon = value.find(':');
+            if (colon == std::string::npos) {
+                std::fprintf(stderr, "--burst expects ON:OFF seconds\n");
+                return false;
+            }
+            options.burstOn = std::atof(value.substr(0, colon).c_str());
+            options.burstOff = std::atof(value.substr(colon + 1).c_str());
+        } else if (arg == "--batch") {
+            options.batchSamples = std::atoi(value.c_str());
+        } else if (arg == "--packet-size") {
+            options.packetSize = std::atoi(value.c_str());
+        } else if (arg == "--noise") {
+            options.noise = std::atof(value.c_str());
+        } else {
+            std::fprintf(stderr, "Unknown option: %s\n", arg.c_str());
+            return false;
+        }
+    }
+
+    if (options.channels < 1 || options.rate <= 0.0 || options.duration < 0.0 || options.batchSamples < 1 ||
+        options.burstOn < 0.0 || options.burstOff < 0.0 || options.packetSize < 64) {
+        std::fprintf(stderr, "Invalid option value\n");
+        return false;
+    }
+    if (options.transport == UNIX_TRANSPORT && options.path.empty()) {
+        std::fprintf(stderr, "--transport unix needs --path\n");
+        return false;
+    }
+    return true;
+}
+
+// Transports
+
+int openInetSocket(const Options& options)
+{
+    const bool udp = options.transport == UDP_TRANSPORT;
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = udp ? SOCK_DGRAM : SOCK_STREAM;
+
+    addrinfo* addresses = nullptr;
+    const std::string port = std::to_string(options.port);
+    const int error = getaddrinfo(options.host.c_str(), port.c_str(), &hints, &addresses);
+    if (error != 0) {
+        std::fprintf(stderr, "Cannot resolve %s: %s\n", options.host.c_str(), gai_strerror(error));
+        return -1;
+    }
+
+    int fd = -1;
+    for (addrinfo* address = addresses; address; address = address->ai_next) {
+        fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+            break;
+        }
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(addresses);
+
+    if (fd < 0) {
+        std::fprintf(stderr, "Cannot connect to %s:%d: %s\n", options.host.c_str(), options.port, std::strerror(errno));
+        return -1;
+    }
+
+    if (udp) {
+        int bufferSize = 4 << 20;
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize));
+    } else {
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    }
+    return fd;
+}
+
+int openUnixSocket(const Options& options)
+{
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (options.path.size() >= sizeof(address.sun_path)) {
+        std::fprintf(stderr, "Socket path too long: %s\n", options.path.c_str());
+        return -1;
+    }
+    std::memcpy(address.sun_path, options.path.c_str(), options.path.size());
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::fprintf(stderr, "Cannot connect to %s: %s\n", options.path.c_str(), std::strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+int openPty()
+{
+    const int fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) {
+        std::fprintf(stderr, "Cannot open a pseudo terminal: %s\n", std::strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+        }
+        return -1;
+    }
+
+    // Raw mode so records arrive byte for byte, like a serial device
+    termios settings;
+    if (tcgetattr(fd, &settings) == 0) {
+        cfmakeraw(&settings);
+        tcsetattr(fd, TCSANOW, &settings);
+    }
+
+    std::printf("Serial device: %s\n", ptsname(fd));
+    std::fflush(stdout);
+    return fd;
+}
+
+bool writeAll(int fd, const char* data, size_t size)
+{
+    while (size > 0) {
+        const ssize_t written = write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                if (g_stop) {
+                    return false;
+                }
+                continue;
+            }
+            std::fprintf(stderr, "Write failed: %s\n", std::strerror(errno));
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool sendDatagram(int fd, const char* data, size_t size)
+{
+    for (;;) {
+        if (send(fd, data, size, 0) >= 0) {
+            return true;
+        }
+        if (errno == EINTR && !g_stop) {
+            continue;
+        }
+        // Nobody listening yet; the datagram is lost like on a real link
+        if (errno == ECONNREFUSED) {
+            return true;
+        }
+        std::fprintf(stderr, "Send failed: %s\n", std::strerror(errno));
+        return false;
+    }
+}
+
+// Encoders
+
+const size_t kMaxRecordSize = 96;
+
+inline char* appendText(char* out, const char* text, size_t size)
+{
+    std::memcpy(out, text, size);
+    return out + size;
+}
+
+inline char* appendRecord(char* out, Format format, double timestamp, float value, int channel)
+{
+    if (format == BINARY_FORMAT) {
+        // x86 and ARM Linux are little endian, like the record layout
+        const int32_t channel32 = channel;
+        std::memcpy(out, &timestamp, 8);
+        std::memcpy(out + 8, &value, 4);
+        std::memcpy(out + 12, &channel32, 4);
+        return out + 16;
+    }
+
+    char* const end = out + kMaxRecordSize;
+    if (format == JSON_FORMAT) {
+        out = appendText(out, "{\"timestamp\":", 13);
+        out = std::to_chars(out, end, timestamp, std::chars_format::fixed, 6).ptr;
+        out = appendText(out, ",\"value\":", 9);
+        out = std::to_chars(out, end, value, std::chars_format::fixed, 6).ptr;
+        out = appendText(out, ",\"channel\":", 11);
+        out = std::to_chars(out, end, channel).ptr;
+        *out++ = '}';
+    } else {
+        out = std::to_chars(out, end, timestamp, std::chars_format::fixed, 6).ptr;
+        *out++ = ',';
+        out = std::to_chars(out, end, value, std::chars_format::fixed, 6).ptr;
+        *out++ = ',';
+        out = std::to_chars(out, end, channel).ptr;
+    }
+    *out++ = '\n';
+    return out;
+}
+
+// Signals
+
+// Per-channel sine with channel-dependent frequency plus cheap noise
+class SignalSource
+{
+public:
+    SignalSource(int channels, double noise)
+        : m_frequencies(channels)
+        , m_noise(static_cast<float>(noise))
+        , m_state(0x9E3779B97F4A7C15ull)
+    {
+        for (int channel = 0; channel < channels; ++channel) {
+            m_frequencies[channel] = 2.0 * M_PI * (1.0 + 0.5 * channel);
+        }
+    }
+
+    float value(int channel, double timestamp)
+    {
+        // xorshift64, mapped to [-1, 1)
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 7;
+        m_state ^= m_state << 17;
+        const float uniform = static_cast<float>(m_state >> 40) * (2.0f / 16777216.0f) - 1.0f;
+        return static_cast<float>(std::sin(m_frequencies[channel] * timestamp)) + m_noise * uniform;
+    }
+
+private:
+    std::vector<double> m_frequencies;
+    float m_noise;
+    uint64_t m_state;
+};
+
+// Schedule
+
+// Maps frame indices to send times. With bursts, frames are only due in the
+// on-phase of each cycle and time keeps running through the off-phase.
+class Schedule
+{
+public:
+    Schedule(double frameRate, double burstOn, double burstOff)
+        : m_frameRate(frameRate)
+        , m_burstOn(burstOn)
+        , m_burstOff(burstOn > 0.0 ? burstOff : 0.0)
+    {
+    }
+
+    // Seconds after start at which frame is due
+    double timeOf(uint64_t frame) const
+    {
+        const double activeTime = frame / m_frameRate;
+        if (m_burstOn <= 0.0) {
+            return activeTime;
+        }
+        return activeTime + std::floor(activeTime / m_burstOn) * m_burstOff;
+    }
+
+    // Frames due by elapsed seconds after start
+    uint64_t framesDue(double elapsed) const
+    {
+        double activeTime = elapsed;
+        if (m_burstOn > 0.0) {
+            const double cycle = m_burstOn + m_burstOff;
+            const double cycles = std::floor(elapsed / cycle);
+            activeTime = cycles * m_burstOn + std::min(elapsed - cycles * cycle, m_burstOn);
+        }
+        return static_cast<uint64_t>(activeTime * m_frameRate) + 1;
+    }
+
+private:
+    double m_frameRate;
+    double m_burstOn;
+    double m_burstOff;
+};
+
+const char* formatName(Format format)
+{
+    switch (format) {
+        case JSON_FORMAT: return "json";
+        case BINARY_FORMAT: return "binary";
+        default: return "csv";
+    }
+}
+
+void printRate(FILE* stream, const char* label, uint64_t samples, uint64_t bytes, double seconds)
+{
+    const double safeSeconds = std::max(seconds, 1e-9);
+    std::fprintf(stream, "%s %.1f s: %llu samples, %.0f samples/s, %.2f MB/s\n",
+                 label, seconds, static_cast<unsigned long long>(samples),
+                 samples / safeSeconds, bytes / safeSeconds / 1e6);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = onSignal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    int fd = -1;
+    switch (options.transport) {
+        case TCP_TRANSPORT:
+        case UDP_TRANSPORT:
+            fd = openInetSocket(options);
+            break;
+        case UNIX_TRANSPORT:
+            fd = openUnixSocket(options);
+            break;
+        case PTY_TRANSPORT:
+            fd = openPty();
+            break;
+    }
+    if (fd < 0) {
+        return 1;
+    }
+
+    const bool datagrams = options.transport == UDP_TRANSPORT;
+    const int channels = options.channels;
+    const double frameRate = options.rate / channels;
+    const uint64_t batchFrames = std::max(1, options.batchSamples / channels);
+    const size_t recordSize = options.format == BINARY_FORMAT ? 16 : kMaxRecordSize;
+
+    if (!options.quiet) {
+        std::fprintf(stderr, "Sending %s, %d channel(s), %.0f samples/s", formatName(options.format), channels, options.rate);
+        if (options.burstOn > 0.0) {
+            std::fprintf(stderr, " in %.3f s bursts every %.3f s", options.burstOn, options.burstOn + options.burstOff);
+        }
+        std::fprintf(stderr, "\n");
+    }
+
+    SignalSource source(channels, options.noise);
+    Schedule schedule(frameRate, options.burstOn, options.burstOff);
+    std::vector<char> buffer(batchFrames * channels * recordSize + kMaxRecordSize);
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    Clock::time_point lastReport = start;
+    uint64_t framesSent = 0;
+    uint64_t bytesSent = 0;
+    uint64_t reportSamples = 0;
+    uint64_t reportBytes = 0;
+    bool ok = true;
+
+    while (ok && !g_stop) {
+        const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        if (options.duration > 0.0 && elapsed >= options.duration) {
+            break;
+        }
+
+        uint64_t due = schedule.framesDue(elapsed);
+        if (options.duration > 0.0) {
+            due = std::min(due, schedule.framesDue(options.duration));
+        }
+        if (due <= framesSent) {
+            // Ahead of schedule: sleep until the next frame, waking up for reports
+            const double wait = std::min(schedule.timeOf(framesSent) - elapsed, 0.1);
+            if (wait > 0.0) {
+                std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+            }
+        } else {
+            const uint64_t frames = std::min(due - framesSent, batchFrames);
+            char* const begin = buffer.data();
+            char* packet = begin;
+            char* out = begin;
+            for (uint64_t frame = framesSent; frame < framesSent + frames && ok; ++frame) {
+                const double timestamp = schedule.timeOf(frame);
+                for (int channel = 0; channel < channels; ++channel) {
+                    // Datagrams carry whole records only
+                    if (datagrams && static_cast<size_t>(out - packet) + recordSize > static_cast<size_t>(options.packetSize)) {
+                        ok = sendDatagram(fd, packet, out - packet);
+                        packet = out;
+                    }
+                    out = appendRecord(out, options.format, timestamp, source.value(channel, timestamp), channel);
+                }
+            }
+
+            if (ok && out > packet) {
+                ok = datagrams ? sendDatagram(fd, packet, out - packet) : writeAll(fd, packet, out - packet);
+            }
+            if (ok) {
+                framesSent += frames;
+                bytesSent += out - begin;
+                reportSamples += frames * channels;
+                reportBytes += out - begin;
+            }
+        }
+
+        const Clock::time_point now = Clock::now();
+        const double sinceReport = std::chrono::duration<double>(now - lastReport).count();
+        if (!options.quiet && sinceReport >= 1.0) {
+            printRate(stderr, "Sent", reportSamples, reportBytes, sinceReport);
+            lastReport = now;
+            reportSamples = 0;
+            reportBytes = 0;
+        }
+    }
+
+    const double total = std::chrono::duration<double>(Clock::now() - start).count();
+    printRate(stdout, "Total", framesSent * channels, bytesSent, total);
+
+    // Report how far behind the requested rate the run fell
+    const uint64_t requested = schedule.framesDue(options.duration > 0.0 ? std::min(total, options.duration) : total);
+    if (framesSent + batchFrames < requested) {
+        std::printf("Behind schedule by %llu samples\n",
+                    static_cast<unsigned long long>((requested - framesSent) * channels));
+    }
+
+    close(fd);
+    return ok ? 0 : 1;
+}
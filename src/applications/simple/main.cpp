@@ -29,8 +29,17 @@
 #include <QOpenGLVertexArrayObject>
 #include <QMatrix4x4>
 #include <QGridLayout>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
 #include "modules/plot_view.h"
 #include "modules/multi_plot_container.h"
+#include "modules/headless_renderer.h"
+#include "modules/trace.h"
+#ifdef ENABLE_DEBUG_PORT
+#include "modules/debug_port.h"
+#endif
 
 #include <vector>
 #include <string>
@@ -39,12 +48,191 @@
 #include <memory>
 #include <signal.h>
 #include <iostream>
+#include <cmath>
+#include <climits>
+#include <cstring>
 
 
+static void onDumpTraceSignal(int)
+{
+    Tracer::requestDump();
+}
+
+static bool hasArgument(int argc, char *argv[], const char *name)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// --headless: replays a recorded session (the raw newline-delimited records
+// a source sent, e.g. captured with `nc -l 8080 > session.csv`) into an
+// offscreen view and writes one PNG per frame of session time. Without
+// --output the frames are only rendered and read back, as a render
+// benchmark; without --session the empty scene is rendered.
+static int runHeadless(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Renders plot frames offscreen, without a window.");
+    parser.addHelpOption();
+    QCommandLineOption headlessOption("headless", "Render offscreen instead of opening a window.");
+    QCommandLineOption sessionOption("session", "Recorded stream to replay.", "file");
+    QCommandLineOption outputOption("output", "Directory for frame_NNNNNN.png images.", "dir");
+    QCommandLineOption sizeOption("size", "Frame size (1280x720).", "WxH", "1280x720");
+    QCommandLineOption fpsOption("fps", "Frames per second of session time (30).", "rate", "30");
+    QCommandLineOption framesOption("frames", "Stop after this many frames (300 without a session).", "count");
+    QCommandLineOption layoutOption("layout", "time, xy, xyz or histogram (time).", "layout", "time");
+    QCommandLineOption channelsOption("channels", "Channels mapped to x,y,z (0,1,2).", "x,y,z", "0,1,2");
+    QCommandLineOption cameraOption("camera", "Azimuth and elevation in degrees.", "az,el");
+    QCommandLineOption samplesOption("samples", "Multisampling samples, 0 disables (4).", "count", "4");
+    parser.addOptions({headlessOption, sessionOption, outputOption, sizeOption, fpsOption, framesOption,
+                       layoutOption, channelsOption, cameraOption, samplesOption});
+    parser.process(arguments);
+
+    const QStringList sizeParts = parser.value(sizeOption).split('x');
+    const QSize size(sizeParts.value(0).toInt(), sizeParts.value(1).toInt());
+    const double fps = parser.value(fpsOption).toDouble();
+    static const QStringList layouts = {"time", "xy", "xyz", "histogram"};
+    const int layout = layouts.indexOf(parser.value(layoutOption));
+    const QStringList channels = parser.value(channelsOption).split(',');
+    if (size.isEmpty() || fps <= 0.0 || layout < 0 || channels.size() != 3) {
+        qCritical() << "Invalid --size, --fps, --layout or --channels";
+        return 1;
+    }
+
+    const bool hasSession = parser.isSet(sessionOption);
+    const int maxFrames = parser.isSet(framesOption) ? parser.value(framesOption).toInt() : (hasSession ? INT_MAX : 300);
+
+    QByteArray session;
+    if (hasSession) {
+        QFile file(parser.value(sessionOption));
+        if (!file.open(QIODevice::ReadOnly)) {
+            qCritical() << "Cannot read session" << file.fileName() << ":" << file.errorString();
+            return 1;
+        }
+        session = file.readAll();
+        if (!session.endsWith('\n')) {
+            session.append('\n');
+        }
+    }
+
+    const bool writeImages = parser.isSet(outputOption);
+    const QDir outputDir(parser.value(outputOption));
+    if (writeImages && !outputDir.mkpath(".")) {
+        qCritical() << "Cannot create output directory" << outputDir.path();
+        return 1;
+    }
+
+    HeadlessRenderer renderer(size, parser.value(samplesOption).toInt());
+    if (!renderer.initialize()) {
+        qCritical().noquote() << renderer.errorString()
+                              << "(needs an OpenGL-capable platform, e.g. QT_QPA_PLATFORM=offscreen under Xvfb;"
+                              << "LIBGL_ALWAYS_SOFTWARE=1 selects Mesa llvmpipe)";
+        return 1;
+    }
+
+    PlotView *view = renderer.view();
+    view->setAxisLabels("Time", "Signal", "Amplitude");
+    view->setRealTimeLayout(static_cast<PlotView::RealTimeLayout>(layout),
+                            channels[0].toInt(), channels[1].toInt(), channels[2].toInt());
+    if (parser.isSet(cameraOption)) {
+        const QStringList angles = parser.value(cameraOption).split(',');
+        view->setViewAngles(angles.value(0).toDouble() * M_PI / 180.0, angles.value(1).toDouble() * M_PI / 180.0);
+    }
+
+    int frames = 0;
+    int images = 0;
+    auto saveImage = [&](const QImage &image) {
+        if (image.isNull() || !writeImages) {
+            return;
+        }
+        const QString path = outputDir.filePath(QString("frame_%1.png").arg(images++, 6, 10, QChar('0')));
+        if (!image.save(path)) {
+            qWarning() << "Failed to write" << path;
+        }
+    };
+    auto renderFrame = [&]() {
+        saveImage(renderer.renderFrame());
+        ++frames;
+    };
+
+    QElapsedTimer wallClock;
+    wallClock.start();
+
+    if (hasSession) {
+        // Cut the session into frames by record timestamp; every frame
+        // replays the records of one period, then renders
+        const double period = 1.0 / fps;
+        bool started = false;
+        double frameEnd = 0.0;
+        int chunkStart = 0;
+        int lineStart = 0;
+        while (lineStart < session.size() && frames < maxFrames) {
+            const int lineEnd = session.indexOf('\n', lineStart);
+            DataPoint point;
+            if (DataReceiver::parseMessage(session.mid(lineStart, lineEnd - lineStart), point)) {
+                if (!started) {
+                    frameEnd = point.timestamp + period;
+                    started = true;
+                } else if (point.timestamp >= frameEnd) {
+                    view->replayData(session.mid(chunkStart, lineStart - chunkStart), frameEnd);
+                    renderFrame();
+                    chunkStart = lineStart;
+
+                    // Skip idle stretches rather than render identical frames
+                    frameEnd += period * (std::floor((point.timestamp - frameEnd) / period) + 1.0);
+                }
+            }
+            lineStart = lineEnd + 1;
+        }
+        if (chunkStart < session.size() && frames < maxFrames) {
+            view->replayData(session.mid(chunkStart), frameEnd);
+            renderFrame();
+        }
+    } else {
+        while (frames < maxFrames) {
+            renderFrame();
+        }
+    }
+    saveImage(renderer.finish());
+
+    const double seconds = wallClock.nsecsElapsed() * 1e-9;
+    const FrameStats::Summary stats = view->getFrameStats();
+    qInfo().noquote() << QString("Rendered %1 frames of %2x%3 in %4 s (%5 frames/s), wrote %6 images")
+                             .arg(frames).arg(size.width()).arg(size.height())
+                             .arg(seconds, 0, 'f', 2).arg(seconds > 0.0 ? frames / seconds : 0.0, 0, 'f', 1)
+                             .arg(images);
+    qInfo().noquote() << QString("Last %1 frames: interval %2 ms, scene %3 ms, overlay %4 ms, %5 vertices")
+                             .arg(stats.frames).arg(stats.frameMs, 0, 'f', 2)
+                             .arg(stats.stageMs[FrameStats::SCENE_STAGE], 0, 'f', 2)
+                             .arg(stats.stageMs[FrameStats::OVERLAY_STAGE], 0, 'f', 2)
+                             .arg(stats.vertices, 0, 'f', 0);
+    return 0;
+}
+
 int main(int argc, char *argv[])
 {
+    // Headless runs default to a platform that needs no display
+    const bool headless = hasArgument(argc, argv, "--headless");
+    if (headless && !qEnvironmentVariableIsSet("QT_QPA_PLATFORM") &&
+        !qEnvironmentVariableIsSet("DISPLAY") && !qEnvironmentVariableIsSet("WAYLAND_DISPLAY")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    
     QApplication app(argc, argv);
     
+    if (headless) {
+        Tracer::setThreadName("Headless");
+        return runHeadless(app.arguments());
+    }
+    
+    // `kill -USR1 <pid>` dumps the trace like the D key
+    Tracer::setThreadName("GUI");
+    signal(SIGUSR1, onDumpTraceSignal);
+    
     QMainWindow window;
     window.setWindowTitle("LumosCalibView - Hardware Calibration Tool");
     window.resize(800, 600);
@@ -72,6 +260,14 @@ int main(int argc, char *argv[])
     statusLabel->move(10, 10);  // Top-left overlay
     statusLabel->adjustSize();
     
+#ifdef ENABLE_DEBUG_PORT
+    // Control socket for scripted runs; CALIBVIEW_DEBUG_PORT overrides the port
+    bool portSet = false;
+    const int debugPortNumber = qEnvironmentVariableIntValue("CALIBVIEW_DEBUG_PORT", &portSet);
+    DebugPort debugPort(multiPlotContainer);
+    debugPort.start(portSet ? static_cast<quint16>(debugPortNumber) : 8081);
+#endif
+    
     window.show();
     
     return app.exec();
@@ -0,0 +1,121 @@
+#include "clock_model.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Huber threshold in units of the residual scale
+const double kHuberThreshold = 2.0;
+// Smallest residual scale, so a perfectly regular clock does not reject everything
+const double kMinResidualScale = 1e-6;
+// Adaptation rate of the residual scale
+const double kScaleAdaptation = 0.01;
+}
+
+ClockModel::ClockModel()
+    : m_lambda(0.9999)
+{
+    reset();
+}
+
+void ClockModel::setForgettingFactor(double lambda)
+{
+    m_lambda = std::clamp(lambda, 0.0, 1.0);
+}
+
+void ClockModel::reset()
+{
+    m_deviceReference = 0.0;
+    m_hostReference = 0.0;
+    m_sumW = 0.0;
+    m_sumX = 0.0;
+    m_sumY = 0.0;
+    m_sumXX = 0.0;
+    m_sumXY = 0.0;
+    m_residualScale = 0.0;
+    m_intercept = 0.0;
+    m_rate = 1.0;
+    m_hasFit = false;
+    m_observationCount = 0;
+    m_batchPending = false;
+    m_batchNewest = 0.0;
+}
+
+void ClockModel::addSample(double deviceTime)
+{
+    if (!m_batchPending || deviceTime > m_batchNewest) {
+        m_batchNewest = deviceTime;
+    }
+    m_batchPending = true;
+}
+
+void ClockModel::endBatch(double hostArrivalTime)
+{
+    if (m_batchPending) {
+        addObservation(m_batchNewest, hostArrivalTime);
+        m_batchPending = false;
+    }
+}
+
+void ClockModel::addObservation(double deviceTime, double hostTime)
+{
+    if (m_observationCount == 0) {
+        m_deviceReference = deviceTime;
+        m_hostReference = hostTime;
+    }
+
+    const double x = deviceTime - m_deviceReference;
+    const double y = hostTime - m_hostReference;
+
+    // Weight by how well the observation fits the current model
+    double weight = 1.0;
+    if (m_observationCount > 0) {
+        const double residual = std::fabs(y - (m_intercept + m_rate * x));
+        const double scale = std::max(m_residualScale, kMinResidualScale);
+        if (residual > kHuberThreshold * scale) {
+            weight = kHuberThreshold * scale / residual;
+        }
+        m_residualScale += kScaleAdaptation * (std::min(residual, 10.0 * scale) - m_residualScale);
+    }
+
+    m_sumW = m_lambda * m_sumW + weight;
+    m_sumX = m_lambda * m_sumX + weight * x;
+    m_sumY = m_lambda * m_sumY + weight * y;
+    m_sumXX = m_lambda * m_sumXX + weight * x * x;
+    m_sumXY = m_lambda * m_sumXY + weight * x * y;
+    ++m_observationCount;
+
+    solve();
+}
+
+void ClockModel::solve()
+{
+    const double meanX = m_sumX / m_sumW;
+    const double meanY = m_sumY / m_sumW;
+    const double varianceX = m_sumXX / m_sumW - meanX * meanX;
+    const double covarianceXY = m_sumXY / m_sumW - meanX * meanY;
+
+    // Need some spread in device time before the rate means anything
+    if (m_observationCount >= 2 && varianceX > 1e-9) {
+        m_rate = covarianceXY / varianceX;
+        m_hasFit = true;
+    }
+    else {
+        m_rate = 1.0;
+        m_hasFit = false;
+    }
+    m_intercept = meanY - m_rate * meanX;
+}
+
+double ClockModel::toHostTime(double deviceTime) const
+{
+    if (m_observationCount == 0) {
+        return deviceTime;
+    }
+    return m_hostReference + m_intercept + m_rate * (deviceTime - m_deviceReference);
+}
+
+double ClockModel::getOffset() const
+{
+    // Offset of the model evaluated at device time zero
+    return m_hostReference + m_intercept - m_rate * m_deviceReference;
+}
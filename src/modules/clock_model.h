@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+
+// Online model of a device clock relative to the host clock:
+//
+//   host = offset + rate * device
+//
+// Each batch contributes one observation: its newest device timestamp
+// paired with the host arrival time, which is the sample with the least
+// transport delay in that batch. Observations go into a weighted least
+// squares fit with exponential forgetting, and Huber weights on the
+// residual reject delayed batches. The fit is kept as running sums, so an
+// update is O(1) per batch regardless of its size.
+class ClockModel
+{
+public:
+    ClockModel();
+
+    void setForgettingFactor(double lambda);
+    void reset();
+
+    // Batch interface: addSample() for every sample, then endBatch() once
+    void addSample(double deviceTime);
+    void endBatch(double hostArrivalTime);
+
+    // Direct interface for a single (device, host) pair
+    void addObservation(double deviceTime, double hostTime);
+
+    double toHostTime(double deviceTime) const;
+
+    bool hasObservations() const { return m_observationCount > 0; }
+    bool isValid() const { return m_hasFit; }
+    double getOffset() const;
+    double getRate() const { return m_rate; }
+    double getDriftPpm() const { return (m_rate - 1.0) * 1e6; }
+    size_t getObservationCount() const { return m_observationCount; }
+
+private:
+    void solve();
+
+    double m_lambda;
+
+    // Observations are centered on the first one to keep precision
+    double m_deviceReference;
+    double m_hostReference;
+
+    // Weighted sums of x = device - reference, y = host - reference
+    double m_sumW;
+    double m_sumX;
+    double m_sumY;
+    double m_sumXX;
+    double m_sumXY;
+
+    // Robust residual scale (exponentially weighted mean absolute residual)
+    double m_residualScale;
+
+    // Current fit, relative to the references
+    double m_intercept;
+    double m_rate;
+    bool m_hasFit;
+
+    size_t m_observationCount;
+
+    bool m_batchPending;
+    double m_batchNewest;
+};
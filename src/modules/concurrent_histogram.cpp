@@ -0,0 +1,253 @@
+#include "concurrent_histogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// floor(value / 2^shift) for negative values too
+int64_t floorShift(int64_t value, int shift)
+{
+    return value >= 0 ? value >> shift : -((-value - 1) >> shift) - 1;
+}
+
+// Doublings of the bin width needed for [lo, hi] to fit into binCount bins
+int requiredShift(int64_t lo, int64_t hi, size_t binCount)
+{
+    int shift = 0;
+    while (floorShift(hi, shift) - floorShift(lo, shift) + 1 > static_cast<int64_t>(binCount)) {
+        ++shift;
+    }
+    return shift;
+}
+
+// Attempts before a reader gives up on a writer that keeps rebinning
+const int kSnapshotAttempts = 8;
+
+// Bin indices are clamped so spans of them cannot overflow
+const double kMaxBinIndex = 2305843009213693952.0; // 2^61
+}
+
+ConcurrentHistogram::ConcurrentHistogram(size_t binCount, double initialBinWidth)
+    : m_binCount(std::max<size_t>(binCount, 2))
+    , m_initialExponent(static_cast<int>(std::floor(std::log2(std::max(initialBinWidth, 1e-30)))))
+    , m_generation(0)
+{
+}
+
+ConcurrentHistogram::Writer* ConcurrentHistogram::createWriter()
+{
+    std::lock_guard<std::mutex> lock(m_writersMutex);
+    m_writers.emplace_back(new Writer(*this, m_binCount));
+    return m_writers.back().get();
+}
+
+void ConcurrentHistogram::reset()
+{
+    m_generation.fetch_add(1, std::memory_order_release);
+}
+
+void ConcurrentHistogram::merge(Snapshot& out) const
+{
+    out.counts.assign(m_binCount, 0);
+    out.total = 0;
+    out.binWidth = 0.0;
+    out.firstEdge = 0.0;
+
+    const uint32_t generation = m_generation.load(std::memory_order_acquire);
+    std::lock_guard<std::mutex> lock(m_writersMutex);
+    m_mergeParts.resize(m_writers.size());
+    for (size_t w = 0; w < m_writers.size(); ++w) {
+        const Writer& writer = *m_writers[w];
+        Part& part = m_mergeParts[w];
+        part.valid = writer.m_generation.load(std::memory_order_acquire) == generation &&
+                     writer.snapshot(part.exponent, part.offset, part.counts);
+    }
+    const std::vector<Part>& parts = m_mergeParts;
+
+    // Occupied range on the coarsest grid
+    int exponent = m_initialExponent;
+    for (const Part& part : parts) {
+        if (part.valid) {
+            exponent = std::max(exponent, part.exponent);
+        }
+    }
+
+    bool occupied = false;
+    int64_t lo = 0;
+    int64_t hi = 0;
+    for (const Part& part : parts) {
+        if (!part.valid) {
+            continue;
+        }
+        const int shift = exponent - part.exponent;
+        for (size_t i = 0; i < part.counts.size(); ++i) {
+            if (part.counts[i] == 0) {
+                continue;
+            }
+            const int64_t bin = floorShift(part.offset + static_cast<int64_t>(i), shift);
+            lo = occupied ? std::min(lo, bin) : bin;
+            hi = occupied ? std::max(hi, bin) : bin;
+            occupied = true;
+        }
+    }
+    if (!occupied) {
+        return;
+    }
+
+    // Writers with disjoint ranges may need an even coarser grid
+    const int extraShift = requiredShift(lo, hi, m_binCount);
+    exponent += extraShift;
+    lo = floorShift(lo, extraShift);
+    hi = floorShift(hi, extraShift);
+    const int64_t offset = lo - (static_cast<int64_t>(m_binCount) - (hi - lo + 1)) / 2;
+
+    for (const Part& part : parts) {
+        if (!part.valid) {
+            continue;
+        }
+        const int shift = exponent - part.exponent;
+        for (size_t i = 0; i < part.counts.size(); ++i) {
+            if (part.counts[i] != 0) {
+                out.counts[floorShift(part.offset + static_cast<int64_t>(i), shift) - offset] += part.counts[i];
+                out.total += part.counts[i];
+            }
+        }
+    }
+
+    out.binWidth = std::ldexp(1.0, exponent);
+    out.firstEdge = static_cast<double>(offset) * out.binWidth;
+}
+
+ConcurrentHistogram::Writer::Writer(const ConcurrentHistogram& owner, size_t binCount)
+    : m_owner(owner)
+    , m_counts(binCount)
+    , m_exponent(owner.m_initialExponent)
+    , m_offset(0)
+    , m_hasLayout(false)
+    , m_sequence(0)
+    , m_generation(owner.m_generation.load(std::memory_order_acquire))
+    , m_inverseWidth(std::ldexp(1.0, -owner.m_initialExponent))
+    , m_localOffset(0)
+    , m_localHasLayout(false)
+{
+}
+
+void ConcurrentHistogram::Writer::add(float value)
+{
+    if (!std::isfinite(value)) {
+        return;
+    }
+
+    const uint32_t generation = m_owner.m_generation.load(std::memory_order_acquire);
+    if (generation != m_generation.load(std::memory_order_relaxed)) {
+        clearCounts();
+        m_generation.store(generation, std::memory_order_release);
+    }
+
+    int64_t bin = binOf(value);
+    if (!m_localHasLayout) {
+        // Centre the first sample
+        m_sequence.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        setLayout(m_owner.m_initialExponent, bin - static_cast<int64_t>(m_counts.size() / 2));
+        m_sequence.fetch_add(1, std::memory_order_release);
+    }
+
+    // A clamped index can still miss after one rebin, hence the loop
+    while (bin < m_localOffset || bin >= m_localOffset + static_cast<int64_t>(m_counts.size())) {
+        rebin(bin);
+        bin = binOf(value);
+    }
+
+    // Only this thread writes the counter, so no read-modify-write is needed
+    std::atomic<uint64_t>& counter = m_counts[bin - m_localOffset];
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+int64_t ConcurrentHistogram::Writer::binOf(float value) const
+{
+    return static_cast<int64_t>(std::clamp(std::floor(value * m_inverseWidth), -kMaxBinIndex, kMaxBinIndex));
+}
+
+void ConcurrentHistogram::Writer::rebin(int64_t bin)
+{
+    const size_t binCount = m_counts.size();
+
+    // Occupied range including the new bin
+    int64_t lo = bin;
+    int64_t hi = bin;
+    for (size_t i = 0; i < binCount; ++i) {
+        if (m_counts[i].load(std::memory_order_relaxed) != 0) {
+            lo = std::min(lo, m_localOffset + static_cast<int64_t>(i));
+            hi = std::max(hi, m_localOffset + static_cast<int64_t>(i));
+        }
+    }
+
+    const int shift = requiredShift(lo, hi, binCount);
+    const int64_t newLo = floorShift(lo, shift);
+    const int64_t newHi = floorShift(hi, shift);
+    const int64_t newOffset = newLo - (static_cast<int64_t>(binCount) - (newHi - newLo + 1)) / 2;
+
+    std::vector<uint64_t> merged(binCount, 0);
+    for (size_t i = 0; i < binCount; ++i) {
+        const uint64_t count = m_counts[i].load(std::memory_order_relaxed);
+        if (count != 0) {
+            merged[floorShift(m_localOffset + static_cast<int64_t>(i), shift) - newOffset] += count;
+        }
+    }
+
+    m_sequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < binCount; ++i) {
+        m_counts[i].store(merged[i], std::memory_order_relaxed);
+    }
+    setLayout(m_exponent.load(std::memory_order_relaxed) + shift, newOffset);
+    m_sequence.fetch_add(1, std::memory_order_release);
+}
+
+void ConcurrentHistogram::Writer::clearCounts()
+{
+    m_sequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (auto& counter : m_counts) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    m_exponent.store(m_owner.m_initialExponent, std::memory_order_relaxed);
+    m_inverseWidth = std::ldexp(1.0, -m_owner.m_initialExponent);
+    m_hasLayout.store(false, std::memory_order_relaxed);
+    m_localHasLayout = false;
+    m_sequence.fetch_add(1, std::memory_order_release);
+}
+
+void ConcurrentHistogram::Writer::setLayout(int exponent, int64_t offset)
+{
+    m_exponent.store(exponent, std::memory_order_relaxed);
+    m_offset.store(offset, std::memory_order_relaxed);
+    m_hasLayout.store(true, std::memory_order_relaxed);
+    m_inverseWidth = std::ldexp(1.0, -exponent);
+    m_localOffset = offset;
+    m_localHasLayout = true;
+}
+
+bool ConcurrentHistogram::Writer::snapshot(int& exponent, int64_t& offset, std::vector<uint64_t>& counts) const
+{
+    counts.resize(m_counts.size());
+    for (int attempt = 0; attempt < kSnapshotAttempts; ++attempt) {
+        const uint32_t before = m_sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+
+        const bool hasLayout = m_hasLayout.load(std::memory_order_relaxed);
+        exponent = m_exponent.load(std::memory_order_relaxed);
+        offset = m_offset.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < m_counts.size(); ++i) {
+            counts[i] = m_counts[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence.load(std::memory_order_relaxed) == before) {
+            return hasLayout;
+        }
+    }
+    return false;
+}
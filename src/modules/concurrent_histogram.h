@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Histogram fed by any number of producer threads and read once per frame.
+//
+// Every producer thread owns a Writer: a sub-histogram with atomic bin
+// counters that only that thread increments, so adding a sample is O(1)
+// and never contends. merge() sums snapshots of all writers.
+//
+// Bins live on a grid anchored at zero with power-of-two widths. When a
+// sample falls outside the bins, the writer doubles the bin width (merging
+// neighbour pairs exactly) until the occupied range and the sample fit, so
+// history is never re-scanned. Layout changes are published through a
+// sequence counter; readers retry snapshots taken during a change.
+class ConcurrentHistogram
+{
+public:
+    struct Snapshot {
+        double binWidth = 0.0;
+        double firstEdge = 0.0;  // Left edge of counts[0]
+        std::vector<uint64_t> counts;
+        uint64_t total = 0;
+    };
+
+    class Writer
+    {
+    public:
+        void add(float value);
+
+    private:
+        friend class ConcurrentHistogram;
+
+        Writer(const ConcurrentHistogram& owner, size_t binCount);
+
+        int64_t binOf(float value) const;
+        void rebin(int64_t bin);
+        void clearCounts();
+        void setLayout(int exponent, int64_t offset);
+        bool snapshot(int& exponent, int64_t& offset, std::vector<uint64_t>& counts) const;
+
+        const ConcurrentHistogram& m_owner;
+
+        // Written by the owning thread only
+        std::vector<std::atomic<uint64_t>> m_counts;
+        std::atomic<int> m_exponent;
+        std::atomic<int64_t> m_offset;
+        std::atomic<bool> m_hasLayout;
+        std::atomic<uint32_t> m_sequence;    // Odd while the layout changes
+        std::atomic<uint32_t> m_generation;  // Last reset applied
+
+        // Thread-local copies for the hot path
+        double m_inverseWidth;
+        int64_t m_localOffset;
+        bool m_localHasLayout;
+    };
+
+    explicit ConcurrentHistogram(size_t binCount = 128, double initialBinWidth = 1e-3);
+
+    // Returns a writer for the calling thread; it stays valid for the
+    // lifetime of the histogram
+    Writer* createWriter();
+
+    // Clears all counts. Writers apply it before their next sample and are
+    // left out of merge() until then.
+    void reset();
+
+    // Sum of all writers on one grid of at most getBinCount() bins
+    void merge(Snapshot& out) const;
+
+    size_t getBinCount() const { return m_binCount; }
+
+private:
+    size_t m_binCount;
+    int m_initialExponent;
+    std::atomic<uint32_t> m_generation;
+
+    // One writer's snapshot during merge()
+    struct Part {
+        int exponent = 0;
+        int64_t offset = 0;
+        bool valid = false;
+        std::vector<uint64_t> counts;
+    };
+
+    mutable std::mutex m_writersMutex;
+    std::vector<std::unique_ptr<Writer>> m_writers;
+
+    // Kept between merges so a merge per frame does not allocate. Guarded
+    // by m_writersMutex, which merge() holds throughout; writers never take
+    // it while adding samples.
+    mutable std::vector<Part> m_mergeParts;
+};
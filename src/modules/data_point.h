@@ -0,0 +1,10 @@
+#pragma once
+
+struct DataPoint {
+    double timestamp;
+    float value;
+    int channel = 0;  // For multi-channel data
+    
+    DataPoint() = default;
+    DataPoint(double t, float v, int ch = 0) : timestamp(t), value(v), channel(ch) {}
+};
@@ -1,15 +1,183 @@
 #include "data_receiver.h"
+#include "trace.h"
 #include <QDebug>
 #include <QHostAddress>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QDateTime>
+#include <QtEndian>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+bool isJsonSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+const char* skipJsonSpace(const char* p, const char* end)
+{
+    while (p < end && isJsonSpace(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+// End of the JSON number at p, or nullptr if there is none
+const char* scanJsonNumber(const char* p, const char* end)
+{
+    if (p < end && *p == '-') {
+        ++p;
+    }
+    if (p == end || !isDigit(*p)) {
+        return nullptr;
+    }
+    if (*p == '0') {
+        ++p;
+    } else {
+        while (p < end && isDigit(*p)) {
+            ++p;
+        }
+    }
+    if (p < end && *p == '.') {
+        ++p;
+        if (p == end || !isDigit(*p)) {
+            return nullptr;
+        }
+        while (p < end && isDigit(*p)) {
+            ++p;
+        }
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        if (p < end && (*p == '+' || *p == '-')) {
+            ++p;
+        }
+        if (p == end || !isDigit(*p)) {
+            return nullptr;
+        }
+        while (p < end && isDigit(*p)) {
+            ++p;
+        }
+    }
+    return p;
+}
+
+bool keyIs(const char* key, const char* keyEnd, const char* name, size_t nameLength)
+{
+    return static_cast<size_t>(keyEnd - key) == nameLength && std::memcmp(key, name, nameLength) == 0;
+}
+
+enum FlatJsonResult {
+    FLAT_JSON_RECORD,      // Decoded into the point
+    FLAT_JSON_NO_RECORD,   // Valid, but timestamp or value is missing
+    FLAT_JSON_UNSUPPORTED  // Needs the full parser
+};
+
+// Decodes the object [begin, end) in place if it is flat and all of its
+// members are numbers with plain keys, as sources send them. QJsonDocument
+// would build a tree on the heap for every record.
+FlatJsonResult parseFlatJson(const char* begin, const char* end, DataPoint& point)
+{
+    double timestamp = 0.0;
+    double value = 0.0;
+    double channel = 0.0;
+    bool hasTimestamp = false;
+    bool hasValue = false;
+    
+    const char* p = skipJsonSpace(begin + 1, end);
+    if (p < end && *p == '}') {
+        ++p;
+    } else {
+        while (true) {
+            if (p == end || *p != '"') {
+                return FLAT_JSON_UNSUPPORTED;
+            }
+            const char* key = ++p;
+            while (p < end && *p != '"' && *p != '\\') {
+                ++p;
+            }
+            if (p == end || *p != '"') {
+                return FLAT_JSON_UNSUPPORTED;
+            }
+            const char* keyEnd = p++;
+            
+            p = skipJsonSpace(p, end);
+            if (p == end || *p != ':') {
+                return FLAT_JSON_UNSUPPORTED;
+            }
+            p = skipJsonSpace(p + 1, end);
+            const char* numberEnd = scanJsonNumber(p, end);
+            if (!numberEnd) {
+                return FLAT_JSON_UNSUPPORTED;
+            }
+            bool ok;
+            const double number = QByteArray::fromRawData(p, numberEnd - p).toDouble(&ok);
+            if (!ok) {
+                return FLAT_JSON_UNSUPPORTED;
+            }
+            if (keyIs(key, keyEnd, "timestamp", 9)) {
+                timestamp = number;
+                hasTimestamp = true;
+            } else if (keyIs(key, keyEnd, "value", 5)) {
+                value = number;
+                hasValue = true;
+            } else if (keyIs(key, keyEnd, "channel", 7)) {
+                channel = number;
+            }
+            
+            p = skipJsonSpace(numberEnd, end);
+            if (p < end && *p == ',') {
+                p = skipJsonSpace(p + 1, end);
+            } else if (p < end && *p == '}') {
+                ++p;
+                break;
+            } else {
+                return FLAT_JSON_UNSUPPORTED;
+            }
+        }
+    }
+    if (skipJsonSpace(p, end) != end) {
+        return FLAT_JSON_UNSUPPORTED;
+    }
+    if (!hasTimestamp || !hasValue) {
+        return FLAT_JSON_NO_RECORD;
+    }
+    
+    // Like QJsonValue::toInt(0): whole numbers in range only
+    const bool wholeChannel = channel == std::floor(channel) && channel >= std::numeric_limits<int>::min() &&
+                              channel <= std::numeric_limits<int>::max();
+    point = DataPoint(timestamp, static_cast<float>(value), wholeChannel ? static_cast<int>(channel) : 0);
+    return FLAT_JSON_RECORD;
+}
+
+} // namespace
 
 DataReceiver::DataReceiver(QObject *parent)
     : QObject(parent)
     , m_server(nullptr)
     , m_socket(nullptr)
+    , m_inputFormat(TEXT_INPUT)
+    , m_bufferFormat(TEXT_INPUT)
     , m_maxDataPoints(10000)
+    , m_receivedCount(0)
+    , m_queueDepth(0)
+    , m_alignmentEnabled(false)
+    , m_clockCorrectionEnabled(false)
+    , m_statisticsEnabled(false)
+    , m_statisticsWindow(1.0)
+    , m_eventDetectionEnabled(false)
+    , m_histogramWriter(nullptr)
+    , m_histogramChannel(-1)
     , m_isReceiving(false)
     , m_isServer(false)
     , m_port(8080)
@@ -17,6 +185,8 @@ DataReceiver::DataReceiver(QObject *parent)
     m_updateTimer = new QTimer(this);
     m_updateTimer->setInterval(16); // ~60 FPS updates
     connect(m_updateTimer, &QTimer::timeout, this, &DataReceiver::processReceivedData);
+    
+    m_hostClock.start();
 }
 
 DataReceiver::~DataReceiver()
@@ -100,10 +270,110 @@ std::vector<DataPoint> DataReceiver::getLatestData()
     return result;
 }
 
+size_t DataReceiver::takeLatestData(std::vector<DataPoint>& points)
+{
+    QMutexLocker locker(&m_dataMutex);
+    const size_t count = m_dataQueue.size();
+    points.insert(points.end(), m_dataQueue.cbegin(), m_dataQueue.cend());
+    m_dataQueue.clear();
+    m_queueDepth.store(0, std::memory_order_relaxed);
+    return count;
+}
+
+size_t DataReceiver::takeAlignedData(std::vector<double>& timestamps, std::vector<float>& values)
+{
+    QMutexLocker locker(&m_dataMutex);
+    // Swap so both sides keep their capacity; each frame is handed out once
+    timestamps.swap(m_alignedTimestamps);
+    values.swap(m_alignedValues);
+    m_alignedTimestamps.clear();
+    m_alignedValues.clear();
+    return timestamps.size();
+}
+
+void DataReceiver::discardLatestData()
+{
+    QMutexLocker locker(&m_dataMutex);
+    m_dataQueue.clear();
+    m_queueDepth.store(0, std::memory_order_relaxed);
+}
+
 void DataReceiver::clearData()
 {
     QMutexLocker locker(&m_dataMutex);
     m_dataQueue.clear();
+    m_queueDepth.store(0, std::memory_order_relaxed);
+    m_alignedTimestamps.clear();
+    m_alignedValues.clear();
+}
+
+void DataReceiver::setAlignment(const std::vector<int>& channels, double samplePeriod,
+                                TimeAligner::InterpolationMode mode, double latenessTolerance)
+{
+    QMutexLocker locker(&m_dataMutex);
+    m_timeAligner.setSamplePeriod(samplePeriod);
+    m_timeAligner.setInterpolationMode(mode);
+    m_timeAligner.setLatenessTolerance(latenessTolerance);
+    m_timeAligner.setChannels(channels);
+    m_alignedTimestamps.clear();
+    m_alignedValues.clear();
+    m_alignmentEnabled = !channels.empty();
+}
+
+void DataReceiver::disableAlignment()
+{
+    QMutexLocker locker(&m_dataMutex);
+    m_alignmentEnabled = false;
+    m_timeAligner.setChannels({});
+    m_alignedTimestamps.clear();
+    m_alignedValues.clear();
+}
+
+bool DataReceiver::isAlignmentEnabled() const
+{
+    QMutexLocker locker(&m_dataMutex);
+    return m_alignmentEnabled;
+}
+
+void DataReceiver::setClockCorrectionEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_dataMutex);
+    if (enabled == m_clockCorrectionEnabled) {
+        return;
+    }
+    m_clockCorrectionEnabled = enabled;
+    
+    // Device and host timestamps do not mix, so everything that remembers
+    // timestamps starts over. The clock models see raw device time and
+    // keep their estimates.
+    m_dataQueue.clear();
+    m_queueDepth.store(0, std::memory_order_relaxed);
+    m_timeAligner.reset();
+    m_alignedTimestamps.clear();
+    m_alignedValues.clear();
+    m_triggerEngine.clearHistory();
+    for (auto& entry : m_statistics) {
+        entry.second.clear();
+    }
+    m_eventDetector.reset();
+    m_pendingEvents.clear();
+}
+
+bool DataReceiver::isClockCorrectionEnabled() const
+{
+    QMutexLocker locker(&m_dataMutex);
+    return m_clockCorrectionEnabled;
+}
+
+void DataReceiver::getClockDriftInfo(std::vector<ClockDriftInfo>& info) const
+{
+    QMutexLocker locker(&m_dataMutex);
+    info.clear();
+    
+    for (const auto& entry : m_clockModels) {
+        const ClockModel& model = entry.second;
+        info.push_back({entry.first, model.getDriftPpm(), model.getOffset(), model.isValid()});
+    }
 }
 
 bool DataReceiver::isConnected() const
@@ -117,6 +387,7 @@ bool DataReceiver::isConnected() const
 void DataReceiver::startReceiving()
 {
     if (!m_isReceiving) {
+        Tracer::setThreadName("DataReceiver");
         m_isReceiving = true;
         m_updateTimer->start();
         qDebug() << "Started receiving data";
@@ -185,76 +456,409 @@ void DataReceiver::onSocketError(QAbstractSocket::SocketError error)
     }
 }
 
+void DataReceiver::syncInputFormat()
+{
+    // What is left of a record in the old format would misframe the new one
+    const InputFormat format = m_inputFormat.load(std::memory_order_relaxed);
+    if (format != m_bufferFormat) {
+        m_dataBuffer.clear();
+        m_bufferFormat = format;
+    }
+}
+
+void DataReceiver::feedData(const QByteArray& data, double hostArrivalTime)
+{
+    syncInputFormat();
+    m_dataBuffer.append(data);
+    processBufferedData(hostArrivalTime);
+}
+
+void DataReceiver::processBufferedData(double hostArrivalTime)
+{
+    // Decode complete records in place and drop them from the buffer in one
+    // step, so framing copies nothing per message
+    const char* begin = m_dataBuffer.constData();
+    const char* end = begin + m_dataBuffer.size();
+    const char* consumed = m_bufferFormat == BINARY_INPUT ? processBinaryRecords(begin, end) : processTextRecords(begin, end);
+    m_dataBuffer.remove(0, consumed - begin);
+    
+    if (!m_pendingBatch.empty()) {
+        addDataPoints(m_pendingBatch, hostArrivalTime);
+        m_pendingBatch.clear();
+    }
+}
+
 void DataReceiver::onDataReady()
 {
+    TRACE_ZONE("DataReceiver::onDataReady");
+    
     if (m_socket && m_socket->bytesAvailable() > 0) {
-        QByteArray newData = m_socket->readAll();
-        m_dataBuffer.append(newData);
+        // Everything read here shares one host arrival time
+        const double hostArrivalTime = m_hostClock.nsecsElapsed() * 1e-9;
+        syncInputFormat();
         
-        // Process complete messages (assuming newline-delimited JSON)
-        while (m_dataBuffer.contains('\n')) {
-            int index = m_dataBuffer.indexOf('\n');
-            QByteArray message = m_dataBuffer.left(index);
-            m_dataBuffer.remove(0, index + 1);
-            
-            processIncomingData(message);
+        // Read straight behind the unfinished record instead of through a
+        // temporary from readAll()
+        const qsizetype oldSize = m_dataBuffer.size();
+        const qint64 available = m_socket->bytesAvailable();
+        m_dataBuffer.resize(oldSize + available);
+        const qint64 bytesRead = m_socket->read(m_dataBuffer.data() + oldSize, available);
+        m_dataBuffer.resize(oldSize + qMax<qint64>(bytesRead, 0));
+        
+        processBufferedData(hostArrivalTime);
+    }
+}
+
+const char* DataReceiver::processTextRecords(const char* begin, const char* end)
+{
+    const char* lineStart = begin;
+    while (const char* newline = static_cast<const char*>(std::memchr(lineStart, '\n', end - lineStart))) {
+        processIncomingData(lineStart, newline);
+        lineStart = newline + 1;
+    }
+    return lineStart;
+}
+
+const char* DataReceiver::processBinaryRecords(const char* begin, const char* end)
+{
+    TRACE_ZONE("DataReceiver::processBinaryRecords");
+    
+    DataPoint point;
+    const char* record = begin;
+    for (; end - record >= BINARY_RECORD_SIZE; record += BINARY_RECORD_SIZE) {
+        if (parseBinaryRecord(record, point)) {
+            m_pendingBatch.push_back(point);
         }
     }
+    return record;
 }
 
-void DataReceiver::processIncomingData(const QByteArray& data)
+void DataReceiver::processIncomingData(const char* begin, const char* end)
 {
-    // Try to parse as JSON
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &error);
+    TRACE_ZONE("DataReceiver::processIncomingData");
     
-    if (error.error != QJsonParseError::NoError) {
-        // Try simple format: "timestamp,value" or "timestamp,value,channel"
-        QString str = QString::fromUtf8(data).trimmed();
-        QStringList parts = str.split(',');
+    DataPoint point;
+    if (parseMessage(begin, end, point)) {
+        m_pendingBatch.push_back(point);
+    }
+}
+
+bool DataReceiver::parseMessage(const QByteArray& message, DataPoint& point)
+{
+    return parseMessage(message.constData(), message.constData() + message.size(), point);
+}
+
+bool DataReceiver::parseMessage(const char* begin, const char* end, DataPoint& point)
+{
+    while (begin < end && std::isspace(static_cast<unsigned char>(*begin))) {
+        ++begin;
+    }
+    while (end > begin && std::isspace(static_cast<unsigned char>(end[-1]))) {
+        --end;
+    }
+    if (begin == end) {
+        return false;
+    }
+    
+    if (*begin != '{') {
+        // Simple format: "timestamp,value" or "timestamp,value,channel".
+        // Fields are converted through raw views of the line, which unlike
+        // QString::split() allocates nothing.
+        const char* valueStart = std::find(begin, end, ',');
+        if (valueStart == end) {
+            return false;
+        }
+        ++valueStart;
+        const char* valueEnd = std::find(valueStart, end, ',');
         
-        if (parts.size() >= 2) {
-            bool ok1, ok2;
-            double timestamp = parts[0].toDouble(&ok1);
-            float value = parts[1].toFloat(&ok2);
-            
-            if (ok1 && ok2) {
-                int channel = 0;
-                if (parts.size() > 2) {
-                    channel = parts[2].toInt();
-                }
-                
-                DataPoint point(timestamp, value, channel);
-                addDataPoint(point);
-                emit dataReceived(point);
-            }
+        bool ok1, ok2;
+        double timestamp = QByteArray::fromRawData(begin, valueStart - 1 - begin).toDouble(&ok1);
+        float value = QByteArray::fromRawData(valueStart, valueEnd - valueStart).toFloat(&ok2);
+        if (!ok1 || !ok2) {
+            return false;
         }
-        return;
+        
+        int channel = 0;
+        if (valueEnd != end) {
+            const char* channelEnd = std::find(valueEnd + 1, end, ',');
+            channel = QByteArray::fromRawData(valueEnd + 1, channelEnd - valueEnd - 1).toInt();
+        }
+        
+        point = DataPoint(timestamp, value, channel);
+        return true;
+    }
+    
+    // JSON format; anything beyond flat numeric members takes the full parser
+    const FlatJsonResult flat = parseFlatJson(begin, end, point);
+    if (flat != FLAT_JSON_UNSUPPORTED) {
+        return flat == FLAT_JSON_RECORD;
+    }
+    
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromRawData(begin, end - begin), &error);
+    if (error.error != QJsonParseError::NoError) {
+        return false;
     }
     
-    // Parse JSON format
     QJsonObject obj = doc.object();
     if (obj.contains("timestamp") && obj.contains("value")) {
         double timestamp = obj["timestamp"].toDouble();
         float value = static_cast<float>(obj["value"].toDouble());
         int channel = obj.value("channel").toInt(0);
         
-        DataPoint point(timestamp, value, channel);
-        addDataPoint(point);
-        emit dataReceived(point);
+        point = DataPoint(timestamp, value, channel);
+        return true;
+    }
+    return false;
+}
+
+bool DataReceiver::parseBinaryRecord(const char* record, DataPoint& point)
+{
+    const double timestamp = qFromLittleEndian<double>(record);
+    const float value = qFromLittleEndian<float>(record + 8);
+    const qint32 channel = qFromLittleEndian<qint32>(record + 12);
+    
+    // Fixed-size records cannot be resynchronized by content, but garbage
+    // times would corrupt every time-ordered consumer downstream
+    if (!std::isfinite(timestamp)) {
+        return false;
+    }
+    
+    point = DataPoint(timestamp, value, channel);
+    return true;
+}
+
+void DataReceiver::setTriggerSettings(const TriggerEngine::Settings& settings)
+{
+    QMutexLocker locker(&m_dataMutex);
+    m_triggerEngine.setSettings(settings);
+}
+
+void DataReceiver::armTrigger()
+{
+    QMutexLocker locker(&m_dataMutex);
+    m_triggerEngine.arm();
+}
+
+void DataReceiver::disarmTrigger()
+{
+    QMutexLocker locker(&m_dataMutex);
+    m_triggerEngine.disarm();
+}
+
+TriggerEngine::State DataReceiver::getTriggerState() const
+{
+    QMutexLocker locker(&m_dataMutex);
+    return m_triggerEngine.getState();
+}
+
+bool DataReceiver::takeTriggerCapture(std::vector<DataPoint>& frame, double& triggerTime)
+{
+    QMutexLocker locker(&m_dataMutex);
+    return m_triggerEngine.takeCapture(frame, triggerTime);
+}
+
+void DataReceiver::setStatisticsEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_dataMutex);
+    m_statisticsEnabled = enabled;
+    if (!enabled) {
+        m_statistics.clear();
+    }
+}
+
+void DataReceiver::setStatisticsWindow(double seconds)
+{
+    QMutexLocker locker(&m_dataMutex);
+    m_statisticsWindow = seconds;
+    for (auto& entry : m_statistics) {
+        entry.second.setWindow(seconds);
+    }
+}
+
+bool DataReceiver::isStatisticsEnabled() const
+{
+    QMutexLocker locker(&m_dataMutex);
+    return m_statisticsEnabled;
+}
+
+std::vector<ChannelStatistics> DataReceiver::getChannelStatistics() const
+{
+    QMutexLocker locker(&m_dataMutex);
+    std::vector<ChannelStatistics> result;
+    result.reserve(m_statistics.size());
+    
+    for (const auto& entry : m_statistics) {
+        result.push_back({entry.first, entry.second.getSummary()});
     }
+    
+    return result;
+}
+
+void DataReceiver::setHistogramChannel(int channel)
+{
+    if (m_histogramChannel.exchange(channel) != channel) {
+        m_histogram.reset();
+    }
+}
+
+int DataReceiver::getHistogramChannel() const
+{
+    return m_histogramChannel.load();
+}
+
+void DataReceiver::getHistogram(ConcurrentHistogram::Snapshot& snapshot) const
+{
+    m_histogram.merge(snapshot);
+}
+
+void DataReceiver::setEventDetection(bool enabled, const EventDetector::Settings& settings)
+{
+    QMutexLocker locker(&m_dataMutex);
+    m_eventDetectionEnabled = enabled;
+    m_eventDetector.setSettings(settings);
+    m_pendingEvents.clear();
+}
+
+bool DataReceiver::isEventDetectionEnabled() const
+{
+    QMutexLocker locker(&m_dataMutex);
+    return m_eventDetectionEnabled;
+}
+
+size_t DataReceiver::takeEvents(std::vector<DetectedEvent>& events)
+{
+    QMutexLocker locker(&m_dataMutex);
+    const size_t count = m_pendingEvents.size();
+    events.insert(events.end(), m_pendingEvents.begin(), m_pendingEvents.end());
+    m_pendingEvents.clear();
+    return count;
 }
 
 void DataReceiver::addDataPoint(const DataPoint& point)
 {
     QMutexLocker locker(&m_dataMutex);
+    enqueueDataPoint(point);
+    m_receivedCount.fetch_add(1, std::memory_order_relaxed);
+    m_queueDepth.store(m_dataQueue.size(), std::memory_order_relaxed);
+}
+
+void DataReceiver::addDataPoints(std::vector<DataPoint>& points, double hostArrivalTime)
+{
+    TRACE_ZONE("DataReceiver::addDataPoints");
     
+    bool newCapture = false;
+    {
+        QMutexLocker locker(&m_dataMutex);
+        
+        // One clock observation per channel and batch
+        ClockModel* model = nullptr;
+        int modelChannel = 0;
+        for (const auto& point : points) {
+            if (!model || point.channel != modelChannel) {
+                model = &m_clockModels[point.channel];
+                modelChannel = point.channel;
+            }
+            model->addSample(point.timestamp);
+        }
+        for (auto& entry : m_clockModels) {
+            entry.second.endBatch(hostArrivalTime);
+        }
+        
+        // Store corrected timestamps
+        if (m_clockCorrectionEnabled) {
+            model = nullptr;
+            for (auto& point : points) {
+                if (!model || point.channel != modelChannel) {
+                    model = &m_clockModels[point.channel];
+                    modelChannel = point.channel;
+                }
+                point.timestamp = model->toHostTime(point.timestamp);
+            }
+        }
+        
+        if (m_statisticsEnabled) {
+            RollingStats* stats = nullptr;
+            int statsChannel = 0;
+            for (const auto& point : points) {
+                if (!stats || point.channel != statsChannel) {
+                    auto it = m_statistics.find(point.channel);
+                    if (it == m_statistics.end()) {
+                        it = m_statistics.emplace(point.channel, RollingStats()).first;
+                        it->second.setWindow(m_statisticsWindow);
+                    }
+                    stats = &it->second;
+                    statsChannel = point.channel;
+                }
+                stats->add(point.timestamp, point.value);
+            }
+        }
+        
+        if (m_eventDetectionEnabled) {
+            m_eventDetector.processBatch(points, m_pendingEvents);
+            
+            // Limit undrained events, trimming in chunks like aligned frames
+            const size_t maxEvents = static_cast<size_t>(m_maxDataPoints);
+            if (m_pendingEvents.size() > 2 * maxEvents) {
+                m_pendingEvents.erase(m_pendingEvents.begin(), m_pendingEvents.end() - maxEvents);
+            }
+        }
+        
+        const bool hadCapture = m_triggerEngine.hasNewCapture();
+        m_triggerEngine.processBatch(points);
+        newCapture = !hadCapture && m_triggerEngine.hasNewCapture();
+        
+        for (const auto& point : points) {
+            enqueueDataPoint(point);
+        }
+        m_receivedCount.fetch_add(points.size(), std::memory_order_relaxed);
+        m_queueDepth.store(m_dataQueue.size(), std::memory_order_relaxed);
+    }
+    
+    // Histogram counts need no lock; this thread is their only writer
+    const int histogramChannel = m_histogramChannel.load(std::memory_order_relaxed);
+    if (histogramChannel >= 0) {
+        if (!m_histogramWriter) {
+            m_histogramWriter = m_histogram.createWriter();
+        }
+        for (const auto& point : points) {
+            if (point.channel == histogramChannel) {
+                m_histogramWriter->add(point.value);
+            }
+        }
+    }
+    
+    if (newCapture) {
+        emit triggerCaptured();
+    }
+    
+    for (const auto& point : points) {
+        emit dataReceived(point);
+    }
+}
+
+void DataReceiver::enqueueDataPoint(const DataPoint& point)
+{
     m_dataQueue.enqueue(point);
     
     // Limit queue size
     while (m_dataQueue.size() > m_maxDataPoints) {
         m_dataQueue.dequeue();
     }
+    
+    if (m_alignmentEnabled) {
+        m_timeAligner.push(point);
+        m_timeAligner.drainAligned(m_alignedTimestamps, m_alignedValues);
+        
+        // Limit pending frames, trimming in chunks to keep this amortized O(1)
+        const size_t maxFrames = static_cast<size_t>(m_maxDataPoints);
+        if (m_alignedTimestamps.size() > 2 * maxFrames) {
+            const size_t excess = m_alignedTimestamps.size() - maxFrames;
+            const size_t channelCount = m_timeAligner.getChannelCount();
+            m_alignedTimestamps.erase(m_alignedTimestamps.begin(), m_alignedTimestamps.begin() + excess);
+            m_alignedValues.erase(m_alignedValues.begin(), m_alignedValues.begin() + excess * channelCount);
+        }
+    }
 }
 
 void DataReceiver::processReceivedData()
@@ -8,15 +8,29 @@
 #include <QMutex>
 #include <QQueue>
 #include <QDataStream>
+#include <QElapsedTimer>
+#include <atomic>
+#include <cstdint>
+#include <map>
 #include <vector>
+#include "data_point.h"
+#include "time_aligner.h"
+#include "clock_model.h"
+#include "trigger_engine.h"
+#include "rolling_stats.h"
+#include "concurrent_histogram.h"
+#include "event_detector.h"
 
-struct DataPoint {
-    double timestamp;
-    float value;
-    int channel = 0;  // For multi-channel data
-    
-    DataPoint() = default;
-    DataPoint(double t, float v, int ch = 0) : timestamp(t), value(v), channel(ch) {}
+struct ClockDriftInfo {
+    int channel;
+    double driftPpm;
+    double offset;
+    bool valid;
+};
+
+struct ChannelStatistics {
+    int channel;
+    RollingStats::Summary summary;
 };
 
 class DataReceiver : public QObject
@@ -24,6 +38,13 @@ class DataReceiver : public QObject
     Q_OBJECT
 
 public:
+    // Encoding of the incoming stream
+    enum InputFormat {
+        TEXT_INPUT,    // Newline-separated "t,v[,ch]" or JSON records
+        BINARY_INPUT   // 16-byte little endian records: float64 t, float32 v, int32 ch
+    };
+    static constexpr int BINARY_RECORD_SIZE = 16;
+
     explicit DataReceiver(QObject *parent = nullptr);
     ~DataReceiver();
 
@@ -37,11 +58,68 @@ public:
     void setMaxDataPoints(int maxPoints) { m_maxDataPoints = maxPoints; }
     void setUpdateInterval(int msec) { m_updateTimer->setInterval(msec); }
     
+    // Takes effect with the next read; a partial record is dropped (thread-safe)
+    void setInputFormat(InputFormat format) { m_inputFormat.store(format); }
+    InputFormat getInputFormat() const { return m_inputFormat.load(); }
+    
+    // Time alignment of selected channels onto a common clock (thread-safe)
+    void setAlignment(const std::vector<int>& channels, double samplePeriod,
+                      TimeAligner::InterpolationMode mode = TimeAligner::LINEAR_INTERPOLATION,
+                      double latenessTolerance = 0.05);
+    void disableAlignment();
+    bool isAlignmentEnabled() const;
+    
+    // Device clock correction; drift is estimated per channel either way (thread-safe)
+    void setClockCorrectionEnabled(bool enabled);
+    bool isClockCorrectionEnabled() const;
+    void getClockDriftInfo(std::vector<ClockDriftInfo>& info) const;  // Replaces the contents
+    
+    // Trigger capture, evaluated on every received sample (thread-safe)
+    void setTriggerSettings(const TriggerEngine::Settings& settings);
+    void armTrigger();
+    void disarmTrigger();
+    TriggerEngine::State getTriggerState() const;
+    bool takeTriggerCapture(std::vector<DataPoint>& frame, double& triggerTime);
+    
+    // Rolling per-channel statistics over a time window (thread-safe)
+    void setStatisticsEnabled(bool enabled);
+    void setStatisticsWindow(double seconds);
+    bool isStatisticsEnabled() const;
+    std::vector<ChannelStatistics> getChannelStatistics() const;
+    
+    // Incremental value histogram of one channel, -1 disables (thread-safe;
+    // reading does not block ingest)
+    void setHistogramChannel(int channel);
+    int getHistogramChannel() const;
+    void getHistogram(ConcurrentHistogram::Snapshot& snapshot) const;
+    
+    // Peak/threshold event detection on all channels (thread-safe)
+    void setEventDetection(bool enabled, const EventDetector::Settings& settings = EventDetector::Settings());
+    bool isEventDetectionEnabled() const;
+    size_t takeEvents(std::vector<DetectedEvent>& events);
+    
     // Data access (thread-safe)
     std::vector<DataPoint> getLatestData();
+    size_t takeLatestData(std::vector<DataPoint>& points);  // Appends, then empties the queue
+    size_t takeAlignedData(std::vector<double>& timestamps, std::vector<float>& values);  // Replaces, then empties
+    void discardLatestData();  // Empties the queue, keeps aligned frames
     void clearData();
     
+    // Ingest counters for monitoring, lock-free
+    uint64_t getReceivedCount() const { return m_receivedCount.load(std::memory_order_relaxed); }
+    int getQueueDepth() const { return m_queueDepth.load(std::memory_order_relaxed); }
+    
     bool isConnected() const;
+    
+    // Direct input, bypassing the socket (benchmarks and tests). feedData()
+    // takes raw bytes through the same framing and batching as received
+    // data; parseMessage() decodes one "t,v[,ch]" or JSON line and
+    // parseBinaryRecord() one BINARY_RECORD_SIZE record.
+    void feedData(const QByteArray& data, double hostArrivalTime);
+    void addDataPoint(const DataPoint& point);
+    static bool parseMessage(const QByteArray& message, DataPoint& point);
+    static bool parseMessage(const char* begin, const char* end, DataPoint& point);
+    static bool parseBinaryRecord(const char* record, DataPoint& point);
 
 public slots:
     void startReceiving();
@@ -50,6 +128,7 @@ public slots:
 signals:
     void dataReceived(const DataPoint& point);
     void newDataAvailable();
+    void triggerCaptured();
     void connectionStatusChanged(bool connected);
     void errorOccurred(const QString& error);
 
@@ -62,18 +141,57 @@ private slots:
     void processReceivedData();
 
 private:
-    void processIncomingData(const QByteArray& data);
-    void addDataPoint(const DataPoint& point);
+    void syncInputFormat();
+    void processBufferedData(double hostArrivalTime);
+    const char* processTextRecords(const char* begin, const char* end);
+    const char* processBinaryRecords(const char* begin, const char* end);
+    void processIncomingData(const char* begin, const char* end);
+    void addDataPoints(std::vector<DataPoint>& points, double hostArrivalTime);
+    void enqueueDataPoint(const DataPoint& point);
     
     // Network
     QTcpServer* m_server;
     QTcpSocket* m_socket;
     QByteArray m_dataBuffer;
+    std::vector<DataPoint> m_pendingBatch;
+    std::atomic<InputFormat> m_inputFormat;
+    InputFormat m_bufferFormat;  // Format of the bytes in m_dataBuffer
     
     // Data storage (thread-safe)
     mutable QMutex m_dataMutex;
     QQueue<DataPoint> m_dataQueue;
     int m_maxDataPoints;
+    std::atomic<uint64_t> m_receivedCount;
+    std::atomic<int> m_queueDepth;
+    
+    // Alignment (guarded by m_dataMutex)
+    TimeAligner m_timeAligner;
+    bool m_alignmentEnabled;
+    std::vector<double> m_alignedTimestamps;
+    std::vector<float> m_alignedValues;
+    
+    // Clock models per channel (guarded by m_dataMutex)
+    std::map<int, ClockModel> m_clockModels;
+    bool m_clockCorrectionEnabled;
+    QElapsedTimer m_hostClock;
+    
+    // Trigger (guarded by m_dataMutex)
+    TriggerEngine m_triggerEngine;
+    
+    // Rolling statistics per channel (guarded by m_dataMutex)
+    std::map<int, RollingStats> m_statistics;
+    bool m_statisticsEnabled;
+    double m_statisticsWindow;
+    
+    // Event detection (guarded by m_dataMutex)
+    EventDetector m_eventDetector;
+    bool m_eventDetectionEnabled;
+    std::vector<DetectedEvent> m_pendingEvents;
+    
+    // Value histogram, lock-free; the writer belongs to the receiver thread
+    ConcurrentHistogram m_histogram;
+    ConcurrentHistogram::Writer* m_histogramWriter;
+    std::atomic<int> m_histogramChannel;
     
     // Processing
     QTimer* m_updateTimer;
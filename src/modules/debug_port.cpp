@@ -0,0 +1,287 @@
+#include "debug_port.h"
+#include <QHostAddress>
+#include <QImage>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+#include <cmath>
+
+namespace {
+
+const int kMaxLineLength = 4096;
+
+QByteArray okReply(const QByteArray& detail = QByteArray())
+{
+    return detail.isEmpty() ? QByteArray("ok") : "ok " + detail;
+}
+
+QByteArray errorReply(const QString& message)
+{
+    return "error " + message.toUtf8();
+}
+
+} // namespace
+
+DebugPort::DebugPort(MultiPlotContainer* container, QObject* parent)
+    : QObject(parent)
+    , m_container(container)
+    , m_server(new QTcpServer(this))
+    , m_selectedView(0)
+{
+    connect(m_server, &QTcpServer::newConnection, this, &DebugPort::onNewConnection);
+}
+
+DebugPort::~DebugPort()
+{
+    stop();
+}
+
+bool DebugPort::start(quint16 port)
+{
+    // Local only; the port controls the whole UI
+    if (!m_server->listen(QHostAddress::LocalHost, port)) {
+        qWarning() << "Debug port failed to listen on" << port << ":" << m_server->errorString();
+        return false;
+    }
+    qDebug() << "Debug port listening on 127.0.0.1:" << m_server->serverPort();
+    return true;
+}
+
+void DebugPort::stop()
+{
+    for (auto it = m_buffers.begin(); it != m_buffers.end(); ++it) {
+        it.key()->disconnect(this);
+        it.key()->disconnectFromHost();
+        it.key()->deleteLater();
+    }
+    m_buffers.clear();
+    m_server->close();
+}
+
+bool DebugPort::isListening() const
+{
+    return m_server->isListening();
+}
+
+quint16 DebugPort::getPort() const
+{
+    return m_server->serverPort();
+}
+
+void DebugPort::onNewConnection()
+{
+    while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+        m_buffers.insert(socket, QByteArray());
+        connect(socket, &QTcpSocket::readyRead, this, &DebugPort::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, &DebugPort::onDisconnected);
+    }
+}
+
+void DebugPort::onReadyRead()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket || !m_buffers.contains(socket)) {
+        return;
+    }
+
+    QByteArray& buffer = m_buffers[socket];
+    buffer.append(socket->readAll());
+
+    int index;
+    while ((index = buffer.indexOf('\n')) >= 0) {
+        const QString line = QString::fromUtf8(buffer.left(index)).trimmed();
+        buffer.remove(0, index + 1);
+
+        if (line.isEmpty()) {
+            continue;
+        }
+        socket->write(execute(line.split(' ', Qt::SkipEmptyParts)) + '\n');
+    }
+
+    if (buffer.size() > kMaxLineLength) {
+        socket->write(errorReply("line too long") + '\n');
+        buffer.clear();
+    }
+}
+
+void DebugPort::onDisconnected()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (socket) {
+        m_buffers.remove(socket);
+        socket->deleteLater();
+    }
+}
+
+PlotView* DebugPort::selectedView(QByteArray& error) const
+{
+    const auto& views = m_container->getPlotViews();
+    if (m_selectedView < 0 || m_selectedView >= views.size()) {
+        error = errorReply(QString("no plot view %1").arg(m_selectedView));
+        return nullptr;
+    }
+    return views[m_selectedView];
+}
+
+QByteArray DebugPort::execute(const QStringList& args)
+{
+    const QString command = args[0].toLower();
+
+    if (command == "help") {
+        return okReply("view layout camera zoom projection source capture record metrics hud help");
+    }
+
+    if (command == "view") {
+        bool ok = false;
+        const int index = args.size() > 1 ? args[1].toInt(&ok) : -1;
+        if (!ok || index < 0 || index >= m_container->getPlotViews().size()) {
+            return errorReply("usage: view <index>");
+        }
+        m_selectedView = index;
+        return okReply();
+    }
+
+    QByteArray error;
+    PlotView* view = selectedView(error);
+    if (!view) {
+        return error;
+    }
+
+    if (command == "layout") {
+        static const QStringList names = {"time", "xy", "xyz", "histogram"};
+        const int layout = args.size() > 1 ? names.indexOf(args[1].toLower()) : -1;
+        if (layout < 0) {
+            return errorReply("usage: layout time|xy|xyz|histogram [x y z channels]");
+        }
+        int channels[3] = {0, 1, 2};
+        for (int i = 0; i < 3 && i + 2 < args.size(); ++i) {
+            channels[i] = args[i + 2].toInt();
+        }
+        view->setRealTimeLayout(static_cast<PlotView::RealTimeLayout>(layout), channels[0], channels[1], channels[2]);
+        return okReply();
+    }
+
+    if (command == "camera") {
+        bool okAzimuth = false;
+        bool okElevation = false;
+        const double azimuth = args.size() > 2 ? args[1].toDouble(&okAzimuth) : 0.0;
+        const double elevation = args.size() > 2 ? args[2].toDouble(&okElevation) : 0.0;
+        if (!okAzimuth || !okElevation) {
+            return errorReply("usage: camera <azimuthDeg> <elevationDeg>");
+        }
+        view->setViewAngles(azimuth * M_PI / 180.0, elevation * M_PI / 180.0);
+        return okReply();
+    }
+
+    if (command == "zoom") {
+        bool ok = false;
+        const float zoom = args.size() > 1 ? args[1].toFloat(&ok) : 0.0f;
+        if (!ok || zoom <= 0.0f) {
+            return errorReply("usage: zoom <factor>");
+        }
+        view->setZoom(zoom);
+        return okReply(QByteArray::number(view->getZoom()));
+    }
+
+    if (command == "projection") {
+        const QString mode = args.size() > 1 ? args[1].toLower() : QString();
+        if (mode == "perspective") {
+            view->setProjectionMode(PlotView::PERSPECTIVE_PROJECTION);
+        } else if (mode == "orthographic") {
+            view->setProjectionMode(PlotView::ORTHOGRAPHIC_PROJECTION);
+        } else {
+            return errorReply("usage: projection perspective|orthographic");
+        }
+        return okReply();
+    }
+
+    if (command == "source") {
+        const QString action = args.size() > 1 ? args[1].toLower() : QString();
+        const QString format = args.size() > 3 ? args[3].toLower() : QString("text");
+        if (action == "listen" && args.size() > 2 && (format == "text" || format == "binary")) {
+            view->startDataReceiver(static_cast<quint16>(args[2].toUInt()),
+                                    format == "binary" ? DataReceiver::BINARY_INPUT : DataReceiver::TEXT_INPUT);
+            return okReply();
+        }
+        if (action == "connect" && args.size() > 3) {
+            view->connectToDataSource(args[2], static_cast<quint16>(args[3].toUInt()));
+            return okReply();
+        }
+        if (action == "stop") {
+            view->stopDataReceiver();
+            return okReply();
+        }
+        return errorReply("usage: source listen <port> [text|binary] | source connect <host> <port> | source stop");
+    }
+
+    if (command == "capture") {
+        if (args.size() < 2) {
+            return errorReply("usage: capture <file.png>");
+        }
+        const QImage image = view->grabFramebuffer();
+        if (image.isNull() || !image.save(args[1])) {
+            return errorReply("capture failed");
+        }
+        return okReply(QString("%1x%2").arg(image.width()).arg(image.height()).toUtf8());
+    }
+
+    if (command == "record") {
+        const QString target = args.size() > 1 ? args[1] : QString();
+        if (target.toLower() == "stop") {
+            view->stopCapture();
+            return okReply(QByteArray::number(view->getCapturedFrameCount()));
+        }
+        if (target.isEmpty()) {
+            return errorReply("usage: record <file.y4m|directory> [fps] | record stop");
+        }
+        const int fps = args.size() > 2 ? args[2].toInt() : 30;
+        if (!view->startCapture(target, fps)) {
+            return errorReply("record failed");
+        }
+        return okReply();
+    }
+
+    if (command == "metrics") {
+        return metricsReply(view, args.size() > 1 && args[1].toLower() == "reset");
+    }
+
+    if (command == "hud") {
+        const QString state = args.size() > 1 ? args[1].toLower() : QString();
+        if (state != "on" && state != "off") {
+            return errorReply("usage: hud on|off");
+        }
+        view->setPerformanceHud(state == "on");
+        return okReply();
+    }
+
+    return errorReply("unknown command: " + command);
+}
+
+QByteArray DebugPort::metricsReply(PlotView* view, bool reset) const
+{
+    const FrameStats::Summary summary = view->getFrameStats();
+
+    QJsonObject metrics;
+    metrics["frames"] = static_cast<qint64>(summary.frames);
+    metrics["frame_ms"] = summary.frameMs;
+    metrics["frame_ms_max"] = summary.frameMsMax;
+    metrics["fps"] = summary.frameMs > 0.0 ? 1000.0 / summary.frameMs : 0.0;
+    metrics["update_ms"] = summary.stageMs[FrameStats::DATA_UPDATE_STAGE];
+    metrics["scene_ms"] = summary.stageMs[FrameStats::SCENE_STAGE];
+    metrics["overlay_ms"] = summary.stageMs[FrameStats::OVERLAY_STAGE];
+    metrics["capture_ms"] = summary.stageMs[FrameStats::CAPTURE_STAGE];
+    metrics["gpu_ms"] = summary.gpuValid ? QJsonValue(summary.gpuMs) : QJsonValue();
+    metrics["upload_bytes"] = summary.uploadBytes;
+    metrics["vertices"] = summary.vertices;
+    metrics["received_samples"] = static_cast<qint64>(view->getReceivedSampleCount());
+    metrics["queue_depth"] = view->getReceiveQueueDepth();
+    metrics["receiving"] = view->isReceivingData();
+    metrics["capturing"] = view->isCapturing();
+    metrics["captured_frames"] = static_cast<qint64>(view->getCapturedFrameCount());
+    metrics["dropped_frames"] = static_cast<qint64>(view->getDroppedCaptureCount());
+
+    if (reset) {
+        view->resetFrameStats();
+    }
+    return okReply(QJsonDocument(metrics).toJson(QJsonDocument::Compact));
+}
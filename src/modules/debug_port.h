@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHash>
+#include <QByteArray>
+#include <QStringList>
+#include "multi_plot_container.h"
+
+// Local control socket for scripted GUI runs (ENABLE_DEBUG_PORT builds).
+//
+// Listens on 127.0.0.1 and takes one command per line; every command gets
+// a one-line reply starting with "ok" or "error". Commands act on the
+// selected plot view, view 0 unless changed with "view":
+//
+//   view <index>
+//   layout time|xy|xyz|histogram [xChannel yChannel zChannel]
+//   camera <azimuthDeg> <elevationDeg>
+//   zoom <factor>
+//   projection perspective|orthographic
+//   source listen <port> [text|binary] | source connect <host> <port> | source stop
+//                         (connect uses the receiver started by listen;
+//                         binary takes the load generator's 16-byte records)
+//   capture <file.png>
+//   record <file.y4m|directory> [fps] | record stop
+//   metrics [reset]       -> ok {"frames":...,"frame_ms":...,...}
+//   hud on|off
+//   help
+class DebugPort : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DebugPort(MultiPlotContainer* container, QObject* parent = nullptr);
+    ~DebugPort();
+
+    bool start(quint16 port);
+    void stop();
+    bool isListening() const;
+    quint16 getPort() const;
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+
+private:
+    QByteArray execute(const QStringList& args);
+    PlotView* selectedView(QByteArray& error) const;
+    QByteArray metricsReply(PlotView* view, bool reset) const;
+
+    MultiPlotContainer* m_container;
+    QTcpServer* m_server;
+    QHash<QTcpSocket*, QByteArray> m_buffers;
+    int m_selectedView;
+};
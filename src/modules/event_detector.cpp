@@ -0,0 +1,78 @@
+#include "event_detector.h"
+#include <algorithm>
+#include <cmath>
+
+void EventDetector::setSettings(const Settings& settings)
+{
+    m_settings = settings;
+    m_settings.hysteresis = std::max(0.0f, settings.hysteresis);
+    m_settings.releaseTime = std::max(1e-9, settings.releaseTime);
+    m_settings.maxEventDuration = std::max(1e-9, settings.maxEventDuration);
+    reset();
+}
+
+void EventDetector::reset()
+{
+    m_channels.clear();
+}
+
+size_t EventDetector::processBatch(const std::vector<DataPoint>& points, std::vector<DetectedEvent>& out)
+{
+    const size_t before = out.size();
+    const float releaseLevel = m_settings.threshold - m_settings.hysteresis;
+
+    ChannelState* state = nullptr;
+    int stateChannel = 0;
+    for (const auto& point : points) {
+        if (!std::isfinite(point.value)) {
+            continue;
+        }
+        if (!state || point.channel != stateChannel) {
+            state = &m_channels[point.channel];
+            stateChannel = point.channel;
+        }
+
+        // Peak-hold envelope with exponential release
+        const float magnitude = std::fabs(point.value);
+        if (state->hasSample) {
+            const double dt = std::max(0.0, point.timestamp - state->lastTime);
+            state->envelope = std::max(magnitude, static_cast<float>(state->envelope * std::exp(-dt / m_settings.releaseTime)));
+        } else {
+            state->envelope = magnitude;
+            state->hasSample = true;
+        }
+        state->lastTime = point.timestamp;
+
+        DetectedEvent& event = state->event;
+        if (!state->active) {
+            if (state->envelope > m_settings.threshold) {
+                state->active = true;
+                event.channel = point.channel;
+                event.startTime = event.peakTime = point.timestamp;
+                event.startValue = event.peakValue = point.value;
+            }
+            continue;
+        }
+
+        if (magnitude > std::fabs(event.peakValue)) {
+            event.peakTime = point.timestamp;
+            event.peakValue = point.value;
+        }
+
+        if (state->envelope < releaseLevel) {
+            event.endTime = point.timestamp;
+            event.endValue = point.value;
+            out.push_back(event);
+            state->active = false;
+        } else if (point.timestamp - event.startTime >= m_settings.maxEventDuration) {
+            // Split, and continue with a new event from this sample
+            event.endTime = point.timestamp;
+            event.endValue = point.value;
+            out.push_back(event);
+            event.startTime = event.peakTime = point.timestamp;
+            event.startValue = event.peakValue = point.value;
+        }
+    }
+
+    return out.size() - before;
+}
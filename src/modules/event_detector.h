@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <vector>
+#include "data_point.h"
+
+// One excursion of a channel's envelope above the detection threshold:
+// where it crossed upwards, its largest-magnitude sample, and where it
+// fell back below the threshold minus the hysteresis.
+struct DetectedEvent {
+    int channel = 0;
+    double startTime = 0.0;
+    float startValue = 0.0f;
+    double peakTime = 0.0;
+    float peakValue = 0.0f;
+    double endTime = 0.0;
+    float endValue = 0.0f;
+};
+
+// Peak and threshold-crossing detection for vibration and impact signals.
+//
+// Each channel runs a peak-hold envelope follower on |value| that decays
+// with the release time, so a ringing impact stays one event instead of
+// one per oscillation. Work is O(1) per sample and events are emitted when
+// they end, or every maxEventDuration while a channel stays above the
+// threshold.
+class EventDetector
+{
+public:
+    struct Settings {
+        float threshold = 1.0f;
+        float hysteresis = 0.1f;
+        double releaseTime = 0.05;      // Envelope decay time constant
+        double maxEventDuration = 1.0;  // Long excursions are split
+    };
+
+    void setSettings(const Settings& settings);
+    const Settings& getSettings() const { return m_settings; }
+    void reset();
+
+    // Appends completed events to out, returns how many were added
+    size_t processBatch(const std::vector<DataPoint>& points, std::vector<DetectedEvent>& out);
+
+private:
+    struct ChannelState {
+        bool hasSample = false;
+        double lastTime = 0.0;
+        float envelope = 0.0f;
+        bool active = false;
+        DetectedEvent event;
+    };
+
+    Settings m_settings;
+    std::map<int, ChannelState> m_channels;
+};
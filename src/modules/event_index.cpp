@@ -0,0 +1,55 @@
+#include "event_index.h"
+#include <algorithm>
+
+EventIndex::EventIndex()
+    : m_capacity(100000)
+    , m_maxDuration(0.0)
+{
+}
+
+void EventIndex::setCapacity(size_t capacity)
+{
+    m_capacity = std::max<size_t>(capacity, 1);
+    while (m_events.size() > m_capacity) {
+        m_events.pop_front();
+    }
+}
+
+void EventIndex::clear()
+{
+    m_events.clear();
+    m_maxDuration = 0.0;
+}
+
+void EventIndex::insert(const DetectedEvent& event)
+{
+    m_maxDuration = std::max(m_maxDuration, event.endTime - event.startTime);
+
+    if (m_events.empty() || m_events.back().startTime <= event.startTime) {
+        m_events.push_back(event);
+    } else {
+        // Late event from another channel; it belongs near the end
+        const auto position = std::upper_bound(m_events.begin(), m_events.end(), event.startTime,
+                                               [](double t, const DetectedEvent& e) { return t < e.startTime; });
+        m_events.insert(position, event);
+    }
+
+    if (m_events.size() > m_capacity) {
+        m_events.pop_front();
+    }
+}
+
+size_t EventIndex::query(double first, double last, std::vector<DetectedEvent>& out) const
+{
+    const size_t before = out.size();
+
+    const auto begin = std::lower_bound(m_events.begin(), m_events.end(), first - m_maxDuration,
+                                        [](const DetectedEvent& e, double t) { return e.startTime < t; });
+    for (auto it = begin; it != m_events.end() && it->startTime <= last; ++it) {
+        if (it->endTime >= first) {
+            out.push_back(*it);
+        }
+    }
+
+    return out.size() - before;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include "event_detector.h"
+
+// Bounded interval index of detected events, ordered by start time.
+//
+// Events are short compared to the history, so a query for the events
+// overlapping [first, last] binary searches the start times in
+// [first - longest duration, last] and filters by end time. Events arrive
+// almost in order; the oldest are dropped once the capacity is reached.
+class EventIndex
+{
+public:
+    EventIndex();
+
+    void setCapacity(size_t capacity);
+    void clear();
+
+    void insert(const DetectedEvent& event);
+
+    // Appends the events overlapping [first, last] to out
+    size_t query(double first, double last, std::vector<DetectedEvent>& out) const;
+
+    size_t size() const { return m_events.size(); }
+
+private:
+    std::deque<DetectedEvent> m_events;
+    size_t m_capacity;
+    double m_maxDuration;
+};
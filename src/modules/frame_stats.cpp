@@ -0,0 +1,82 @@
+#include "frame_stats.h"
+#include <algorithm>
+
+FrameStats::FrameStats()
+{
+    reset();
+}
+
+void FrameStats::reset()
+{
+    m_frames.fill(Frame());
+    m_frameCount = 0;
+    m_current = Frame();
+    m_frameStart = 0;
+    m_started = false;
+    m_gpuNs.fill(0);
+    m_gpuCount = 0;
+}
+
+void FrameStats::beginFrame(uint64_t nowNs)
+{
+    if (m_started) {
+        m_current.intervalNs = nowNs > m_frameStart ? nowNs - m_frameStart : 0;
+        m_frames[m_frameCount % FRAME_HISTORY] = m_current;
+        ++m_frameCount;
+    }
+
+    m_current = Frame();
+    m_frameStart = nowNs;
+    m_started = true;
+}
+
+void FrameStats::addGpuTime(uint64_t ns)
+{
+    m_gpuNs[m_gpuCount % FRAME_HISTORY] = ns;
+    ++m_gpuCount;
+}
+
+FrameStats::Summary FrameStats::summarize() const
+{
+    Summary summary;
+
+    const size_t frames = std::min(m_frameCount, FRAME_HISTORY);
+    summary.frames = frames;
+    if (frames > 0) {
+        uint64_t intervalSum = 0;
+        uint64_t intervalMax = 0;
+        uint64_t stageSum[STAGE_COUNT] = {};
+        uint64_t uploadSum = 0;
+        uint64_t vertexSum = 0;
+        for (size_t i = 0; i < frames; ++i) {
+            const Frame& frame = m_frames[i];
+            intervalSum += frame.intervalNs;
+            intervalMax = std::max(intervalMax, frame.intervalNs);
+            for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+                stageSum[stage] += frame.stageNs[stage];
+            }
+            uploadSum += frame.uploadBytes;
+            vertexSum += frame.vertices;
+        }
+
+        summary.frameMs = intervalSum * 1e-6 / frames;
+        summary.frameMsMax = intervalMax * 1e-6;
+        for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+            summary.stageMs[stage] = stageSum[stage] * 1e-6 / frames;
+        }
+        summary.uploadBytes = static_cast<double>(uploadSum) / frames;
+        summary.vertices = static_cast<double>(vertexSum) / frames;
+    }
+
+    const size_t gpuFrames = std::min(m_gpuCount, FRAME_HISTORY);
+    if (gpuFrames > 0) {
+        uint64_t gpuSum = 0;
+        for (size_t i = 0; i < gpuFrames; ++i) {
+            gpuSum += m_gpuNs[i];
+        }
+        summary.gpuValid = true;
+        summary.gpuMs = gpuSum * 1e-6 / gpuFrames;
+    }
+
+    return summary;
+}
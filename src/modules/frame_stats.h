@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Frame timings and counters for the performance HUD.
+//
+// Keeps the last FRAME_HISTORY frames in fixed rings, so recording never
+// allocates and summarize() costs the same however long the view has run.
+// A frame spans from one beginFrame() to the next; stage times, uploads
+// and draws recorded in between are charged to it. GPU times arrive a few
+// frames late from timer queries and are averaged separately.
+class FrameStats
+{
+public:
+    enum Stage {
+        DATA_UPDATE_STAGE,  // Pulling new samples and building vertices
+        SCENE_STAGE,        // paintGL
+        OVERLAY_STAGE,      // QPainter text on top
+        CAPTURE_STAGE,      // Video capture readback
+        STAGE_COUNT
+    };
+
+    static constexpr size_t FRAME_HISTORY = 120;
+
+    struct Summary {
+        size_t frames = 0;
+        double frameMs = 0.0;       // Mean interval between frames
+        double frameMsMax = 0.0;
+        double stageMs[STAGE_COUNT] = {};
+        bool gpuValid = false;
+        double gpuMs = 0.0;
+        double uploadBytes = 0.0;   // Per frame
+        double vertices = 0.0;      // Per frame
+    };
+
+    FrameStats();
+
+    void reset();
+
+    // Closes the current frame and starts the next one at nowNs
+    void beginFrame(uint64_t nowNs);
+
+    void addStageTime(Stage stage, uint64_t ns) { m_current.stageNs[stage] += ns; }
+    void addUpload(size_t bytes) { m_current.uploadBytes += bytes; }
+    void addVertices(size_t count) { m_current.vertices += count; }
+    void addGpuTime(uint64_t ns);
+
+    Summary summarize() const;
+
+private:
+    struct Frame {
+        uint64_t intervalNs = 0;
+        uint64_t stageNs[STAGE_COUNT] = {};
+        uint64_t uploadBytes = 0;
+        uint64_t vertices = 0;
+    };
+
+    std::array<Frame, FRAME_HISTORY> m_frames;
+    size_t m_frameCount;   // Total closed frames
+    Frame m_current;
+    uint64_t m_frameStart;
+    bool m_started;
+
+    std::array<uint64_t, FRAME_HISTORY> m_gpuNs;
+    size_t m_gpuCount;
+};
@@ -0,0 +1,251 @@
+#include "frame_writer.h"
+#include "trace.h"
+#include <cerrno>
+#include <cstring>
+
+namespace {
+
+// BT.601 limited range, as players assume for Y4M
+inline uint8_t lumaFromRgb(int r, int g, int b)
+{
+    return static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+}
+
+inline uint8_t cbFromRgb(int r, int g, int b)
+{
+    return static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+}
+
+inline uint8_t crFromRgb(int r, int g, int b)
+{
+    return static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+}
+
+} // namespace
+
+FrameWriter::FrameWriter()
+    : m_format(Y4M_FORMAT)
+    , m_width(0)
+    , m_height(0)
+    , m_open(false)
+    , m_file(nullptr)
+    , m_stopping(false)
+    , m_failed(false)
+    , m_written(0)
+    , m_dropped(0)
+{
+}
+
+FrameWriter::~FrameWriter()
+{
+    close();
+}
+
+bool FrameWriter::open(const std::string& path, Format format, int width, int height, int fps, size_t bufferCount)
+{
+    close();
+
+    if (width <= 0 || height <= 0 || width % 2 || height % 2 || fps <= 0 || bufferCount == 0) {
+        m_error = "frame size must be even and positive";
+        return false;
+    }
+
+    m_format = format;
+    m_path = path;
+    m_width = width;
+    m_height = height;
+    m_error.clear();
+
+    if (format == Y4M_FORMAT) {
+        m_file = std::fopen(path.c_str(), "wb");
+        if (!m_file) {
+            m_error = path + ": " + std::strerror(errno);
+            return false;
+        }
+        std::fprintf(m_file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, fps);
+    }
+
+    // All buffers up front; capturing allocates nothing per frame
+    m_buffers.assign(bufferCount, std::vector<uint8_t>(getFrameBytes()));
+    m_freeBuffers.clear();
+    for (auto& buffer : m_buffers) {
+        m_freeBuffers.push_back(buffer.data());
+    }
+    m_queue.clear();
+    m_convertBuffer.resize(format == Y4M_FORMAT ? static_cast<size_t>(width) * height * 3 / 2
+                                                : static_cast<size_t>(width) * height * 3);
+    m_stopping = false;
+    m_failed = false;
+    m_written = 0;
+    m_dropped = 0;
+
+    m_thread = std::thread(&FrameWriter::run, this);
+    m_open = true;
+    return true;
+}
+
+void FrameWriter::close()
+{
+    if (!m_open) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_one();
+    m_thread.join();
+
+    if (m_failed) {
+        m_error = m_path + ": write failed";
+    }
+    if (m_file) {
+        if (std::fclose(m_file) != 0 && m_error.empty()) {
+            m_error = m_path + ": " + std::strerror(errno);
+        }
+        m_file = nullptr;
+    }
+    m_open = false;
+}
+
+uint8_t* FrameWriter::acquireBuffer()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_freeBuffers.empty()) {
+        ++m_dropped;
+        return nullptr;
+    }
+    uint8_t* buffer = m_freeBuffers.back();
+    m_freeBuffers.pop_back();
+    return buffer;
+}
+
+void FrameWriter::submitBuffer(uint8_t* buffer)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(buffer);
+    }
+    m_condition.notify_one();
+}
+
+void FrameWriter::dropFrame()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_dropped;
+}
+
+uint64_t FrameWriter::getWrittenCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_written;
+}
+
+uint64_t FrameWriter::getDroppedCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_dropped;
+}
+
+void FrameWriter::run()
+{
+    Tracer::setThreadName("FrameWriter");
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_condition.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+        if (m_queue.empty()) {
+            break;  // Stopping and drained
+        }
+
+        uint8_t* buffer = m_queue.front();
+        m_queue.pop_front();
+        const bool failed = m_failed;
+        lock.unlock();
+
+        // After a write error the rest is discarded, but still counted
+        const bool written = !failed && writeFrame(buffer);
+
+        lock.lock();
+        m_freeBuffers.push_back(buffer);
+        if (written) {
+            ++m_written;
+        } else {
+            ++m_dropped;
+            m_failed = true;
+        }
+    }
+}
+
+bool FrameWriter::writeFrame(const uint8_t* rgba)
+{
+    TRACE_ZONE("FrameWriter::writeFrame");
+
+    return m_format == Y4M_FORMAT ? writeY4mFrame(rgba) : writePpmFrame(rgba);
+}
+
+bool FrameWriter::writeY4mFrame(const uint8_t* rgba)
+{
+    const size_t lumaSize = static_cast<size_t>(m_width) * m_height;
+    uint8_t* luma = m_convertBuffer.data();
+    uint8_t* cb = luma + lumaSize;
+    uint8_t* cr = cb + lumaSize / 4;
+    const size_t stride = static_cast<size_t>(m_width) * 4;
+
+    // Two output rows at a time, flipping the bottom-up input; chroma is
+    // taken from the mean of each 2x2 block
+    for (int y = 0; y < m_height; y += 2) {
+        const uint8_t* row0 = rgba + (m_height - 1 - y) * stride;
+        const uint8_t* row1 = row0 - stride;
+        uint8_t* luma0 = luma + static_cast<size_t>(y) * m_width;
+        uint8_t* luma1 = luma0 + m_width;
+        uint8_t* cbRow = cb + static_cast<size_t>(y / 2) * (m_width / 2);
+        uint8_t* crRow = cr + static_cast<size_t>(y / 2) * (m_width / 2);
+
+        for (int x = 0; x < m_width; x += 2) {
+            const uint8_t* p00 = row0 + x * 4;
+            const uint8_t* p01 = p00 + 4;
+            const uint8_t* p10 = row1 + x * 4;
+            const uint8_t* p11 = p10 + 4;
+
+            luma0[x] = lumaFromRgb(p00[0], p00[1], p00[2]);
+            luma0[x + 1] = lumaFromRgb(p01[0], p01[1], p01[2]);
+            luma1[x] = lumaFromRgb(p10[0], p10[1], p10[2]);
+            luma1[x + 1] = lumaFromRgb(p11[0], p11[1], p11[2]);
+
+            const int r = (p00[0] + p01[0] + p10[0] + p11[0] + 2) >> 2;
+            const int g = (p00[1] + p01[1] + p10[1] + p11[1] + 2) >> 2;
+            const int b = (p00[2] + p01[2] + p10[2] + p11[2] + 2) >> 2;
+            cbRow[x / 2] = cbFromRgb(r, g, b);
+            crRow[x / 2] = crFromRgb(r, g, b);
+        }
+    }
+
+    return std::fputs("FRAME\n", m_file) >= 0
+        && std::fwrite(m_convertBuffer.data(), 1, m_convertBuffer.size(), m_file) == m_convertBuffer.size();
+}
+
+bool FrameWriter::writePpmFrame(const uint8_t* rgba)
+{
+    const size_t stride = static_cast<size_t>(m_width) * 4;
+    uint8_t* out = m_convertBuffer.data();
+    for (int y = 0; y < m_height; ++y) {
+        const uint8_t* row = rgba + (m_height - 1 - y) * stride;
+        for (int x = 0; x < m_width; ++x) {
+            *out++ = row[x * 4];
+            *out++ = row[x * 4 + 1];
+            *out++ = row[x * 4 + 2];
+        }
+    }
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "/frame_%06llu.ppm", static_cast<unsigned long long>(m_written));
+    FILE* file = std::fopen((m_path + name).c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    std::fprintf(file, "P6\n%d %d\n255\n", m_width, m_height);
+    const bool written = std::fwrite(m_convertBuffer.data(), 1, m_convertBuffer.size(), file) == m_convertBuffer.size();
+    return std::fclose(file) == 0 && written;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes captured frames to disk on its own thread.
+//
+// Frames are bottom-up RGBA rows, as glReadPixels returns them. The caller
+// fills a buffer from a fixed pool and submits it; when every buffer is
+// still queued the frame is dropped rather than waited for, so the render
+// thread never blocks on the disk. Conversion happens on the writer thread:
+//
+//   Y4M_FORMAT       one YUV4MPEG2 file, 4:2:0 BT.601 (ffmpeg, mpv and
+//                    most encoders read it directly)
+//   PPM_SEQUENCE     frame_NNNNNN.ppm (binary RGB) in a directory
+//
+// Width and height must be even.
+class FrameWriter
+{
+public:
+    enum Format {
+        Y4M_FORMAT,
+        PPM_SEQUENCE_FORMAT
+    };
+
+    FrameWriter();
+    ~FrameWriter();
+
+    bool open(const std::string& path, Format format, int width, int height, int fps, size_t bufferCount = 8);
+    // Writes everything queued, then stops the thread
+    void close();
+    bool isOpen() const { return m_open; }
+    // Set by open() and close()
+    const std::string& errorString() const { return m_error; }
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    size_t getFrameBytes() const { return static_cast<size_t>(m_width) * m_height * 4; }
+
+    // Render thread. acquireBuffer() returns nullptr, and counts a dropped
+    // frame, when the writer is behind.
+    uint8_t* acquireBuffer();
+    void submitBuffer(uint8_t* buffer);
+    void dropFrame();
+
+    uint64_t getWrittenCount() const;
+    uint64_t getDroppedCount() const;
+
+private:
+    void run();
+    bool writeFrame(const uint8_t* rgba);
+    bool writeY4mFrame(const uint8_t* rgba);
+    bool writePpmFrame(const uint8_t* rgba);
+
+    Format m_format;
+    std::string m_path;
+    int m_width;
+    int m_height;
+    bool m_open;
+    std::string m_error;
+    FILE* m_file;  // Y4M only
+
+    std::vector<std::vector<uint8_t>> m_buffers;
+    std::vector<uint8_t> m_convertBuffer;  // Writer thread only
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::vector<uint8_t*> m_freeBuffers;
+    std::deque<uint8_t*> m_queue;
+    bool m_stopping;
+    bool m_failed;
+    uint64_t m_written;
+    uint64_t m_dropped;
+    std::thread m_thread;
+};
@@ -0,0 +1,159 @@
+#include "headless_renderer.h"
+#include "trace.h"
+#include <QOpenGLFunctions>
+#include <QOpenGLPaintDevice>
+#include <QDebug>
+
+HeadlessRenderer::HeadlessRenderer(const QSize& size, int samples)
+    : m_size(size)
+    , m_samples(samples)
+    , m_pboSupported(false)
+    , m_frameIndex(0)
+{
+    for (int i = 0; i < PBO_COUNT; ++i) {
+        m_pbos[i] = QOpenGLBuffer(QOpenGLBuffer::PixelPackBuffer);
+        m_pending[i] = false;
+    }
+}
+
+HeadlessRenderer::~HeadlessRenderer()
+{
+    // The view and buffers free GL objects, so the context must be current
+    if (m_context.isValid() && m_context.makeCurrent(&m_surface)) {
+        m_view.reset();
+        m_renderTarget.reset();
+        m_resolveTarget.reset();
+        for (QOpenGLBuffer& pbo : m_pbos) {
+            pbo.destroy();
+        }
+        m_context.doneCurrent();
+    }
+}
+
+bool HeadlessRenderer::initialize(std::unique_ptr<PlotView> view)
+{
+    m_context.setFormat(QSurfaceFormat::defaultFormat());
+    if (!m_context.create()) {
+        m_error = "Failed to create an OpenGL context";
+        return false;
+    }
+
+    m_surface.setFormat(m_context.format());
+    m_surface.create();
+    if (!m_surface.isValid() || !m_context.makeCurrent(&m_surface)) {
+        m_error = "Failed to make an offscreen surface current";
+        return false;
+    }
+
+    QOpenGLFramebufferObjectFormat format;
+    format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+    if (m_samples > 0 && QOpenGLFramebufferObject::hasOpenGLFramebufferBlit()) {
+        // Multisampled targets cannot be read directly; resolve into a plain one
+        format.setSamples(m_samples);
+        m_resolveTarget = std::make_unique<QOpenGLFramebufferObject>(m_size);
+    }
+    m_renderTarget = std::make_unique<QOpenGLFramebufferObject>(m_size, format);
+    if (!m_renderTarget->isValid() || (m_resolveTarget && !m_resolveTarget->isValid())) {
+        m_error = QString("Failed to create a %1x%2 framebuffer").arg(m_size.width()).arg(m_size.height());
+        return false;
+    }
+
+    // Mapping a PBO for reading needs OpenGL 3.0, ARB_map_buffer_range or OpenGL ES 3.0
+    const QSurfaceFormat actual = m_context.format();
+    m_pboSupported = m_context.isOpenGLES() ? actual.majorVersion() >= 3
+                                            : actual.version() >= qMakePair(3, 0)
+                                              || m_context.hasExtension("GL_ARB_map_buffer_range");
+    for (QOpenGLBuffer& pbo : m_pbos) {
+        if (!m_pboSupported || !pbo.create()) {
+            m_pboSupported = false;
+            break;
+        }
+        pbo.setUsagePattern(QOpenGLBuffer::StreamRead);
+        pbo.bind();
+        pbo.allocate(m_size.width() * m_size.height() * 4);
+        pbo.release();
+    }
+    if (!m_pboSupported) {
+        qDebug() << "Pixel buffer objects not supported, reading frames back synchronously";
+    }
+
+    m_view = view ? std::move(view) : std::make_unique<PlotView>();
+    m_view->setAttribute(Qt::WA_DontShowOnScreen);
+    m_view->resize(m_size);
+
+    m_renderTarget->bind();
+    m_view->initializeOffscreen();
+    return true;
+}
+
+QImage HeadlessRenderer::renderFrame()
+{
+    TRACE_ZONE("HeadlessRenderer::renderFrame");
+
+    m_renderTarget->bind();
+    QOpenGLPaintDevice overlayDevice(m_size);
+    m_view->renderOffscreen(&overlayDevice);
+
+    if (m_resolveTarget) {
+        QOpenGLFramebufferObject::blitFramebuffer(m_resolveTarget.get(), m_renderTarget.get());
+    }
+
+    const int slot = m_frameIndex % PBO_COUNT;
+    readBack(slot);
+    ++m_frameIndex;
+
+    // The previous frame's transfer ran while this one was drawn
+    return takeImage((slot + PBO_COUNT - 1) % PBO_COUNT);
+}
+
+QImage HeadlessRenderer::finish()
+{
+    return takeImage((m_frameIndex + PBO_COUNT - 1) % PBO_COUNT);
+}
+
+void HeadlessRenderer::readBack(int slot)
+{
+    QOpenGLFramebufferObject* source = m_resolveTarget ? m_resolveTarget.get() : m_renderTarget.get();
+    m_pending[slot] = true;
+
+    if (!m_pboSupported) {
+        m_syncImages[slot] = source->toImage().convertToFormat(QImage::Format_RGB32);
+        return;
+    }
+
+    // Returns at once; the copy into the PBO completes asynchronously
+    source->bind();
+    QOpenGLFunctions* f = m_context.functions();
+    m_pbos[slot].bind();
+    f->glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    f->glReadPixels(0, 0, m_size.width(), m_size.height(), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    m_pbos[slot].release();
+}
+
+QImage HeadlessRenderer::takeImage(int slot)
+{
+    if (!m_pending[slot]) {
+        return QImage();
+    }
+    m_pending[slot] = false;
+
+    if (!m_pboSupported) {
+        QImage image = m_syncImages[slot];
+        m_syncImages[slot] = QImage();
+        return image;
+    }
+
+    QImage image;
+    m_pbos[slot].bind();
+    const int bytes = m_size.width() * m_size.height() * 4;
+    if (const void* pixels = m_pbos[slot].mapRange(0, bytes, QOpenGLBuffer::RangeRead)) {
+        // Rows arrive bottom-up; alpha is ignored, as on screen
+        image = QImage(static_cast<const uchar*>(pixels), m_size.width(), m_size.height(),
+                       QImage::Format_RGBX8888).mirrored();
+        m_pbos[slot].unmap();
+    } else {
+        qWarning() << "Failed to map pixel buffer for frame readback";
+    }
+    m_pbos[slot].release();
+    return image;
+}
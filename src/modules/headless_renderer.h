@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QImage>
+#include <QOffscreenSurface>
+#include <QOpenGLBuffer>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QSize>
+#include <QString>
+#include <memory>
+#include "plot_view.h"
+
+// Renders a PlotView without a window, for image export and render
+// benchmarks on machines without a display (e.g. Mesa llvmpipe).
+//
+// The view draws into a framebuffer object on an offscreen surface, using
+// the same paintGL() and overlay code as on screen. Readback is pipelined
+// through two pixel buffer objects: renderFrame() starts the transfer of
+// the frame it just drew and returns the frame before it, whose transfer
+// has had a whole frame to finish. finish() returns the last one. Without
+// PBO support frames are read back synchronously, with the same ordering.
+//
+// The context stays current on the creating thread for the renderer's
+// lifetime, so view setters that rebuild GL data work between frames.
+class HeadlessRenderer
+{
+public:
+    explicit HeadlessRenderer(const QSize& size, int samples = 4);
+    ~HeadlessRenderer();
+
+    // Renders the given view, e.g. a subclass, or a plain PlotView
+    bool initialize(std::unique_ptr<PlotView> view = nullptr);
+    QString errorString() const { return m_error; }
+
+    PlotView* view() const { return m_view.get(); }
+    QSize size() const { return m_size; }
+
+    // Null image on the first call
+    QImage renderFrame();
+    QImage finish();
+
+private:
+    void readBack(int slot);
+    QImage takeImage(int slot);
+
+    static const int PBO_COUNT = 2;
+
+    QSize m_size;
+    int m_samples;
+    QString m_error;
+
+    QOpenGLContext m_context;
+    QOffscreenSurface m_surface;
+    std::unique_ptr<QOpenGLFramebufferObject> m_renderTarget;
+    std::unique_ptr<QOpenGLFramebufferObject> m_resolveTarget;  // Multisampling only
+    std::unique_ptr<PlotView> m_view;
+
+    bool m_pboSupported;
+    QOpenGLBuffer m_pbos[PBO_COUNT];
+    QImage m_syncImages[PBO_COUNT];
+    bool m_pending[PBO_COUNT];
+    int m_frameIndex;
+};
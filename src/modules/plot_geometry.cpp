@@ -0,0 +1,178 @@
+#include "plot_geometry.h"
+#include <algorithm>
+#include <cmath>
+
+float gridStepForSize(float visibleSize)
+{
+    const int targetGridLines = 10;
+    const float rawStep = visibleSize / targetGridLines;
+
+    // Round to "nice" numbers (1, 2, 5, 10, 20, 50, etc.)
+    const float magnitude = std::pow(10.0f, std::floor(std::log10(rawStep)));
+    const float normalizedStep = rawStep / magnitude;
+
+    float niceStep;
+    if (normalizedStep <= 1.0f)
+        niceStep = 1.0f;
+    else if (normalizedStep <= 2.0f)
+        niceStep = 2.0f;
+    else if (normalizedStep <= 5.0f)
+        niceStep = 5.0f;
+    else
+        niceStep = 10.0f;
+
+    return niceStep * magnitude;
+}
+
+GridLayout computeGridLayout(float visibleSize, float panX, float panY, float panZ,
+                             double azimuth, double elevation)
+{
+    GridLayout layout;
+    const float step = gridStepForSize(visibleSize);
+    const float boxHalfSize = visibleSize * 0.6f * 0.5f;
+    layout.step = step;
+    layout.boxHalfSize = boxHalfSize;
+
+    // Lines move in the same direction as the pan
+    layout.fracOffset[0] = std::fmod(panX, step);
+    layout.fracOffset[1] = std::fmod(panY, step);
+    layout.fracOffset[2] = -std::fmod(panZ, step);
+
+    // Extra lines on both sides so the grid can slide without gaps
+    const float margin = step * 2.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        layout.start[axis] = static_cast<int>(std::floor((-boxHalfSize - margin) / step));
+        layout.end[axis] = static_cast<int>(std::ceil((boxHalfSize + margin) / step));
+    }
+
+    // Grids go on the faces away from the viewer
+    const bool showPositiveZ = std::cos(elevation) * std::cos(azimuth) > 0;
+    const bool showPositiveY = std::sin(elevation) > 0;
+    const bool showPositiveX = std::cos(elevation) * std::sin(azimuth) > 0;
+    layout.zPlane = showPositiveZ ? -boxHalfSize : boxHalfSize;
+    layout.yPlane = showPositiveY ? -boxHalfSize : boxHalfSize;
+    layout.xPlane = showPositiveX ? boxHalfSize : -boxHalfSize;
+
+    return layout;
+}
+
+namespace {
+
+inline float* writeLine(float* out, float x0, float y0, float z0, float x1, float y1, float z1, const float* color)
+{
+    *out++ = x0; *out++ = y0; *out++ = z0;
+    *out++ = color[0]; *out++ = color[1]; *out++ = color[2];
+    *out++ = x1; *out++ = y1; *out++ = z1;
+    *out++ = color[0]; *out++ = color[1]; *out++ = color[2];
+    return out;
+}
+
+inline int lineCount(const GridLayout& layout, int axis)
+{
+    return std::max(0, layout.end[axis] - layout.start[axis] + 1);
+}
+
+} // namespace
+
+void buildGridVertices(const GridLayout& layout, std::vector<float>& vertices)
+{
+    const float mainColor[3] = {0.0f, 0.0f, 0.0f};  // XY plane - black
+    const float sideColor[3] = {0.2f, 0.2f, 0.2f};  // Side planes - dark gray
+    const float boxMin = -layout.boxHalfSize;
+    const float boxMax = layout.boxHalfSize;
+    const float step = layout.step;
+
+    // Each axis' lines appear on two of the three planes
+    const size_t lines = 2 * static_cast<size_t>(lineCount(layout, 0) + lineCount(layout, 1) + lineCount(layout, 2));
+    vertices.resize(lines * 12);
+    float* out = vertices.data();
+
+    // XY plane at the far Z position
+    for (int i = layout.start[0]; i <= layout.end[0]; ++i) {
+        const float x = i * step + layout.fracOffset[0];
+        out = writeLine(out, x, boxMin, layout.zPlane, x, boxMax, layout.zPlane, mainColor);
+    }
+    for (int i = layout.start[1]; i <= layout.end[1]; ++i) {
+        const float y = i * step + layout.fracOffset[1];
+        out = writeLine(out, boxMin, y, layout.zPlane, boxMax, y, layout.zPlane, mainColor);
+    }
+
+    // XZ plane at the far Y position
+    for (int i = layout.start[2]; i <= layout.end[2]; ++i) {
+        const float z = i * step + layout.fracOffset[2];
+        out = writeLine(out, boxMin, layout.yPlane, z, boxMax, layout.yPlane, z, sideColor);
+    }
+    for (int i = layout.start[0]; i <= layout.end[0]; ++i) {
+        const float x = i * step + layout.fracOffset[0];
+        out = writeLine(out, x, layout.yPlane, boxMin, x, layout.yPlane, boxMax, sideColor);
+    }
+
+    // YZ plane at the far X position
+    for (int i = layout.start[2]; i <= layout.end[2]; ++i) {
+        const float z = i * step + layout.fracOffset[2];
+        out = writeLine(out, layout.xPlane, boxMin, z, layout.xPlane, boxMax, z, sideColor);
+    }
+    for (int i = layout.start[1]; i <= layout.end[1]; ++i) {
+        const float y = i * step + layout.fracOffset[1];
+        out = writeLine(out, layout.xPlane, y, boxMin, layout.xPlane, y, boxMax, sideColor);
+    }
+}
+
+void buildGridTicks(const GridLayout& layout, bool includeZ, std::vector<GridTick>& ticks)
+{
+    const float boxMin = -layout.boxHalfSize;
+    const float step = layout.step;
+
+    ticks.clear();
+    ticks.reserve(lineCount(layout, 0) + lineCount(layout, 1) + (includeZ ? lineCount(layout, 2) : 0));
+
+    // Ticks sit on the sliding lines but show the "nice" step value
+    GridTick tick;
+    tick.axis = 0;
+    for (int i = layout.start[0]; i <= layout.end[0]; ++i) {
+        tick.position[0] = i * step + layout.fracOffset[0];
+        tick.position[1] = boxMin;
+        tick.position[2] = layout.zPlane;
+        tick.value = i * step;
+        ticks.push_back(tick);
+    }
+
+    tick.axis = 1;
+    for (int i = layout.start[1]; i <= layout.end[1]; ++i) {
+        tick.position[0] = boxMin;
+        tick.position[1] = i * step + layout.fracOffset[1];
+        tick.position[2] = layout.zPlane;
+        tick.value = i * step;
+        ticks.push_back(tick);
+    }
+
+    if (includeZ) {
+        tick.axis = 2;
+        for (int i = layout.start[2]; i <= layout.end[2]; ++i) {
+            tick.position[0] = boxMin;
+            tick.position[1] = layout.yPlane;
+            tick.position[2] = i * step + layout.fracOffset[2];
+            tick.value = i * step;
+            ticks.push_back(tick);
+        }
+    }
+}
+
+void buildSeriesVertices(const std::vector<float>& xData, const std::vector<float>& yData,
+                         const std::vector<float>& zData, std::vector<float>& vertices)
+{
+    const size_t count = std::min(xData.size(), yData.size());
+    const bool hasZ = !zData.empty() && zData.size() >= count;
+
+    vertices.resize(count * 6);
+    float* out = vertices.data();
+    for (size_t i = 0; i < count; ++i) {
+        const float colorR = static_cast<float>(i) / count;  // Gradient from red to cyan
+        *out++ = xData[i];
+        *out++ = yData[i];
+        *out++ = hasZ ? zData[i] : 0.0f;
+        *out++ = colorR;
+        *out++ = 1.0f - colorR;
+        *out++ = 0.8f;
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+// View geometry behind PlotView's grid, axis numbers and data series.
+//
+// Plain functions over floats with no Qt or OpenGL dependency, so the
+// per-frame math can be benchmarked and tested without a GL context.
+
+// Box frame of the sliding grid: the box stays centred at the origin while
+// the lines inside it shift with the pan offset
+struct GridLayout {
+    float step = 1.0f;
+    float boxHalfSize = 0.0f;               // Box spans +/-boxHalfSize on every axis
+    float fracOffset[3] = {0.0f, 0.0f, 0.0f};  // Sliding offset of the lines, per axis
+    int start[3] = {0, 0, 0};               // Line indices covering the box plus a margin
+    int end[3] = {0, 0, 0};
+    float xPlane = 0.0f;                    // Far faces carrying the grids
+    float yPlane = 0.0f;
+    float zPlane = 0.0f;
+};
+
+// One axis number: where it is anchored and the "nice" value it shows
+struct GridTick {
+    int axis = 0;  // 0 = X, 1 = Y, 2 = Z
+    float position[3] = {0.0f, 0.0f, 0.0f};
+    float value = 0.0f;
+};
+
+// 1/2/5 x 10^n step giving about ten lines across the visible size
+float gridStepForSize(float visibleSize);
+
+GridLayout computeGridLayout(float visibleSize, float panX, float panY, float panZ,
+                             double azimuth, double elevation);
+
+// Line list of the three far grid planes, 6 floats (xyz rgb) per vertex
+void buildGridVertices(const GridLayout& layout, std::vector<float>& vertices);
+
+// Number anchors along the X and Y edges of the XY plane, and along the Z
+// edge of the XZ plane when includeZ is set
+void buildGridTicks(const GridLayout& layout, bool includeZ, std::vector<GridTick>& ticks);
+
+// Line strip with a red-to-cyan gradient, 6 floats (xyz rgb) per vertex.
+// zData may be empty for a flat series.
+void buildSeriesVertices(const std::vector<float>& xData, const std::vector<float>& yData,
+                         const std::vector<float>& zData, std::vector<float>& vertices);
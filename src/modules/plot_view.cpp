@@ -1,12 +1,69 @@
 #include "plot_view.h"
+#include "trace.h"
+#include <QDateTime>
+#include <QDir>
 #include <QDebug>
+#include <QOpenGLContext>
+#include <QVector2D>
 #include <QPaintEvent>
 #include <QThread>
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+
+// Charges the time until the end of the scope to a frame stage
+class StageTimer
+{
+public:
+    StageTimer(FrameStats &stats, const QElapsedTimer &clock, FrameStats::Stage stage)
+        : m_stats(stats), m_clock(clock), m_stage(stage), m_start(clock.nsecsElapsed())
+    {
+    }
+
+    ~StageTimer()
+    {
+        m_stats.addStageTime(m_stage, m_clock.nsecsElapsed() - m_start);
+    }
+
+private:
+    FrameStats &m_stats;
+    const QElapsedTimer &m_clock;
+    FrameStats::Stage m_stage;
+    qint64 m_start;
+};
+
+} // namespace
 
 PlotView::PlotView(QWidget *parent)
-    : QOpenGLWidget(parent), m_shaderProgram(nullptr), m_plotMode(PLOT_3D), m_showGrid(true), m_showAxes(false), m_zoom(1.0f), m_panOffset(0.0f, 0.0f, 0.0f), m_projectionMode(PERSPECTIVE_PROJECTION), m_fov(45.0f), m_mousePressed(false), m_interactionMode(ROTATE_MODE), m_animationTime(0.0f), m_dataReceiver(nullptr), m_dataThread(nullptr), m_realTimeMode(false), m_maxRealTimePoints(1000)
+    : QOpenGLWidget(parent), m_shaderProgram(nullptr), m_barShaderProgram(nullptr), m_instancingSupported(false), m_barBuffersReady(false), m_glyphShaderProgram(nullptr), m_glyphBuffersReady(false), m_plotMode(PLOT_3D), m_showGrid(true), m_showAxes(false), m_zoom(1.0f), m_panOffset(0.0f, 0.0f, 0.0f), m_projectionMode(PERSPECTIVE_PROJECTION), m_fov(45.0f), m_mousePressed(false), m_interactionMode(ROTATE_MODE), m_animationTime(0.0f), m_dataReceiver(nullptr), m_dataThread(nullptr), m_realTimeMode(false), m_maxRealTimePoints(1000), m_statisticsOverlay(false), m_statisticsBands(false), m_statisticsWindow(1.0), m_triggerDisplay(false), m_triggerTime(0.0), m_realTimeLayout(TIME_SERIES_LAYOUT), m_realTimeStyle(POINT_CLOUD_STYLE), m_layoutChannels{0, 1, 2}, m_alignmentPeriod(0.01), m_streamCapacity(1000), m_streamHead(0), m_streamCount(0), m_streamDirtyFirst(0), m_streamDirtyCount(0), m_streamSeamDirty(false), m_streamAllocatedSlots(0), m_octreeDirty(false), m_lodVertexCount(0), m_lodPointThreshold(200000), m_lodPixelThreshold(8.0f), m_voxelDownsampling(false), m_barCount(0), m_histogramDirty(false), m_histogramHeight(4.0f), m_eventMarkers(false), m_pickSeriesSorted(true), m_pickMinChannel(0), m_pickMaxChannel(0), m_pickRadius(10.0f), m_performanceHud(false), m_hudRefreshTime(0), m_hudReceivedCount(0), m_gpuTimersSupported(true), m_gpuTimerActive(false), m_capturing(false), m_capturePeriod(0), m_nextCaptureTime(0), m_captureIndex(0)
 {
+#if !QT_CONFIG(opengles2)
+    for (int i = 0; i < GPU_TIMER_COUNT; ++i)
+    {
+        m_gpuTimers[i] = nullptr;
+        m_gpuTimerPending[i] = false;
+    }
+    m_gpuTimerIndex = 0;
+#else
+    m_gpuTimersSupported = false;
+#endif
+    for (int i = 0; i < CAPTURE_PBO_COUNT; ++i)
+    {
+        m_capturePbos[i] = QOpenGLBuffer(QOpenGLBuffer::PixelPackBuffer);
+        m_capturePending[i] = false;
+#if !QT_CONFIG(opengles2)
+        m_captureFences[i] = nullptr;
+#endif
+    }
+#if !QT_CONFIG(opengles2)
+    m_captureFencesSupported = false;
+#endif
+    m_frameClock.start();
+
     m_animationTimer = new QTimer(this);
     connect(m_animationTimer, &QTimer::timeout, this, &PlotView::updateAnimation);
     m_animationTimer->start(16); // ~60 FPS
@@ -14,16 +71,30 @@ PlotView::PlotView(QWidget *parent)
     // Initialize view angles for 3D plotting with X right, Y up
     m_viewAngles.setAngles(0.0, 0.0);
 
+    resetStream();
+
     // Enable keyboard focus for key events
     setFocusPolicy(Qt::StrongFocus);
+
+    // Hover picking needs move events without a pressed button
+    setMouseTracking(true);
 }
 
 PlotView::~PlotView()
 {
     stopDataReceiver();
+    stopCapture();
 
     makeCurrent();
     delete m_shaderProgram;
+    delete m_barShaderProgram;
+    delete m_glyphShaderProgram;
+#if !QT_CONFIG(opengles2)
+    for (QOpenGLTimerQuery *timer : m_gpuTimers)
+    {
+        delete timer;
+    }
+#endif
     doneCurrent();
 }
 
@@ -37,6 +108,13 @@ void PlotView::initializeGL()
     glLineWidth(1.5f);
     glPointSize(3.0f);
 
+    // Instanced bars need OpenGL 3.3 or OpenGL ES 3.0. The current context
+    // is not always context(): headless rendering brings its own.
+    QOpenGLContext *glContext = QOpenGLContext::currentContext();
+    const QSurfaceFormat format = glContext->format();
+    m_instancingSupported = glContext->isOpenGLES() ? format.majorVersion() >= 3
+                                                    : format.version() >= qMakePair(3, 3);
+
     setupShaders();
     setupBuffers();
     createGridData();
@@ -75,6 +153,62 @@ void PlotView::setupShaders()
     m_shaderProgram->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexShaderSource);
     m_shaderProgram->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentShaderSource);
     m_shaderProgram->link();
+
+    if (m_instancingSupported)
+    {
+        // Histogram bar: unit quad corner scaled by per-instance bar geometry
+        const char *barVertexShaderSource = R"(
+            attribute vec2 aCorner;
+            attribute vec3 aBar;
+            
+            uniform mat4 uMVPMatrix;
+            uniform vec3 uColor;
+            
+            varying vec3 vColor;
+            
+            void main() {
+                vec3 position = vec3(aBar.x + aCorner.x * aBar.y, aCorner.y * aBar.z, 0.0);
+                gl_Position = uMVPMatrix * vec4(position, 1.0);
+                vColor = uColor;
+            }
+        )";
+
+        m_barShaderProgram = new QOpenGLShaderProgram(this);
+        m_barShaderProgram->addShaderFromSourceCode(QOpenGLShader::Vertex, barVertexShaderSource);
+        m_barShaderProgram->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentShaderSource);
+        if (!m_barShaderProgram->link())
+        {
+            qDebug() << "Instanced bar shader failed, using CPU bars:" << m_barShaderProgram->log();
+            m_instancingSupported = false;
+        }
+
+        // Event marker: outline offset in pixels around the projected position
+        const char *glyphVertexShaderSource = R"(
+            attribute vec2 aCorner;
+            attribute vec3 aPosition;
+            attribute vec3 aColor;
+            
+            uniform mat4 uMVPMatrix;
+            uniform vec2 uPixelSize;
+            
+            varying vec3 vColor;
+            
+            void main() {
+                gl_Position = uMVPMatrix * vec4(aPosition, 1.0);
+                gl_Position.xy += aCorner * uPixelSize * gl_Position.w;
+                vColor = aColor;
+            }
+        )";
+
+        m_glyphShaderProgram = new QOpenGLShaderProgram(this);
+        m_glyphShaderProgram->addShaderFromSourceCode(QOpenGLShader::Vertex, glyphVertexShaderSource);
+        m_glyphShaderProgram->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentShaderSource);
+        if (!m_glyphShaderProgram->link())
+        {
+            qDebug() << "Instanced glyph shader failed, using points:" << m_glyphShaderProgram->log();
+            m_instancingSupported = false;
+        }
+    }
 }
 
 void PlotView::setupBuffers()
@@ -99,135 +233,45 @@ void PlotView::setupBuffers()
     // Background plane VAO
     m_backgroundPlaneVAO.create();
     m_backgroundPlaneVertexBuffer.create();
+
+    // Streaming VAO, updated in place as real-time data arrives
+    m_streamVAO.create();
+    m_streamVertexBuffer.create();
+    m_streamVertexBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    m_streamAllocatedSlots = 0;
+
+    // LOD VAO, refilled when the camera or the point cloud changes
+    m_lodVAO.create();
+    m_lodVertexBuffer.create();
+    m_lodVertexBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+
+    // Histogram VAO, refilled when the histogram changes
+    m_barVAO.create();
+    m_barQuadBuffer.create();
+    m_barInstanceBuffer.create();
+    m_barInstanceBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    m_barBuffersReady = false;
+
+    // Event marker VAO, refilled every frame with the markers in view
+    m_glyphVAO.create();
+    m_glyphMeshBuffer.create();
+    m_glyphInstanceBuffer.create();
+    m_glyphInstanceBuffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+    m_glyphBuffersReady = false;
 }
 
 void PlotView::createGridData()
 {
-    m_gridVertices.clear();
-
-    // Dynamic grid spacing based on zoom level
-    const float step = calculateOptimalGridStep();
-    const float visibleSize = getVisibleWorldSize();
-    const float boxSize = visibleSize * 0.6f; // Size of the grid box
-
-    // Get current view angles to determine which box faces are visible
-    const double azimuth = m_viewAngles.getAzimuth();
-    const double elevation = m_viewAngles.getElevation();
-
-    // Box frame stays centered at origin, but grid lines shift with panning
-    const float boxHalfSize = boxSize * 0.5f;
-    const float boxMinX = -boxHalfSize;
-    const float boxMaxX = boxHalfSize;
-    const float boxMinY = -boxHalfSize;
-    const float boxMaxY = boxHalfSize;
-    const float boxMinZ = -boxHalfSize;
-    const float boxMaxZ = boxHalfSize;
-
-    // Create a smooth sliding grid within the fixed box frame
-    // The pan offset creates fractional shifts that make lines slide continuously
-
-    // Calculate fractional offset within one grid step
-    // Grid lines should move in same direction as pan for intuitive behavior
-    const float fracOffsetX = fmod(m_panOffset.x(), step);
-    const float fracOffsetY = fmod(m_panOffset.y(), step);
-    const float fracOffsetZ = -fmod(m_panOffset.z(), step);
-
-    // Create enough grid lines to cover the box plus some margin for sliding
-    const float margin = step * 2.0f; // Extra lines for smooth sliding
-    const float extendedMinX = boxMinX - margin;
-    const float extendedMaxX = boxMaxX + margin;
-    const float extendedMinY = boxMinY - margin;
-    const float extendedMaxY = boxMaxY + margin;
-    const float extendedMinZ = boxMinZ - margin;
-    const float extendedMaxZ = boxMaxZ + margin;
-
-    // Calculate grid line positions, including fractional offset for smooth sliding
-    const int startX = (int)floor(extendedMinX / step);
-    const int endX = (int)ceil(extendedMaxX / step);
-    const int startY = (int)floor(extendedMinY / step);
-    const int endY = (int)ceil(extendedMaxY / step);
-    const int startZ = (int)floor(extendedMinZ / step);
-    const int endZ = (int)ceil(extendedMaxZ / step);
-
-    // Determine which box faces to show based on viewing direction
-    // Use sin/cos to determine if we're looking from positive or negative side
-    const bool showPositiveZ = cos(elevation) * cos(azimuth) > 0; // Looking towards +Z
-    const bool showPositiveY = sin(elevation) > 0;                // Looking towards +Y
-    const bool showPositiveX = cos(elevation) * sin(azimuth) > 0; // Looking towards +X
-
-    // Select Z plane position (XY plane at far Z)
-    const float zPlane = showPositiveZ ? boxMinZ : boxMaxZ;
-
-    // Select Y plane position (XZ plane at far Y)
-    const float yPlane = showPositiveY ? boxMinY : boxMaxY;
-
-    // Select X plane position (YZ plane at far X)
-    const float xPlane = showPositiveX ? boxMaxX : boxMinX;
-
-    // Grid colors - black on white background
-    const float mainColor[3] = {0.0f, 0.0f, 0.0f}; // Main planes - black
-    const float sideColor[3] = {0.2f, 0.2f, 0.2f}; // Side planes - dark gray
-
-    // XY Plane Grid (at far Z position)
-    // Vertical lines (parallel to Y-axis) - slide with fractional X offset
-    for (int i = startX; i <= endX; ++i)
-    {
-        float x = i * step + fracOffsetX; // Add fractional offset for smooth sliding
-
-        m_gridVertices.insert(m_gridVertices.end(), {x, boxMinY, zPlane, mainColor[0], mainColor[1], mainColor[2],
-                                                     x, boxMaxY, zPlane, mainColor[0], mainColor[1], mainColor[2]});
-    }
-
-    // Horizontal lines (parallel to X-axis) - slide with fractional Y offset
-    for (int i = startY; i <= endY; ++i)
-    {
-        float y = i * step + fracOffsetY; // Add fractional offset for smooth sliding
-
-        m_gridVertices.insert(m_gridVertices.end(), {boxMinX, y, zPlane, mainColor[0], mainColor[1], mainColor[2],
-                                                     boxMaxX, y, zPlane, mainColor[0], mainColor[1], mainColor[2]});
-    }
-
-    // XZ Plane Grid (at far Y position)
-    // Lines parallel to X-axis - slide with fractional Z offset
-    for (int i = startZ; i <= endZ; ++i)
-    {
-        float z = i * step + fracOffsetZ; // Add fractional offset for smooth sliding
-
-        m_gridVertices.insert(m_gridVertices.end(), {boxMinX, yPlane, z, sideColor[0], sideColor[1], sideColor[2],
-                                                     boxMaxX, yPlane, z, sideColor[0], sideColor[1], sideColor[2]});
-    }
-
-    // Lines parallel to Z-axis - slide with fractional X offset
-    for (int i = startX; i <= endX; ++i)
-    {
-        float x = i * step + fracOffsetX; // Add fractional offset for smooth sliding
-
-        m_gridVertices.insert(m_gridVertices.end(), {x, yPlane, boxMinZ, sideColor[0], sideColor[1], sideColor[2],
-                                                     x, yPlane, boxMaxZ, sideColor[0], sideColor[1], sideColor[2]});
-    }
-
-    // YZ Plane Grid (at far X position)
-    // Lines parallel to Y-axis - slide with fractional Z offset
-    for (int i = startZ; i <= endZ; ++i)
-    {
-        float z = i * step + fracOffsetZ; // Add fractional offset for smooth sliding
-
-        m_gridVertices.insert(m_gridVertices.end(), {xPlane, boxMinY, z, sideColor[0], sideColor[1], sideColor[2],
-                                                     xPlane, boxMaxY, z, sideColor[0], sideColor[1], sideColor[2]});
-    }
-
-    // Lines parallel to Z-axis - slide with fractional Y offset
-    for (int i = startY; i <= endY; ++i)
-    {
-        float y = i * step + fracOffsetY; // Add fractional offset for smooth sliding
-
-        m_gridVertices.insert(m_gridVertices.end(), {xPlane, y, boxMinZ, sideColor[0], sideColor[1], sideColor[2],
-                                                     xPlane, y, boxMaxZ, sideColor[0], sideColor[1], sideColor[2]});
-    }
+    // Dynamic grid spacing based on zoom level; the box faces follow the view angles
+    const GridLayout layout = computeGridLayout(getVisibleWorldSize(), m_panOffset.x(), m_panOffset.y(),
+                                                m_panOffset.z(), m_viewAngles.getAzimuth(),
+                                                m_viewAngles.getElevation());
+    buildGridVertices(layout, m_gridVertices);
 
     m_gridVAO.bind();
     m_gridVertexBuffer.bind();
     m_gridVertexBuffer.allocate(m_gridVertices.data(), m_gridVertices.size() * sizeof(float));
+    m_frameStats.addUpload(m_gridVertices.size() * sizeof(float));
 
     int posLocation = m_shaderProgram->attributeLocation("aPosition");
     int colorLocation = m_shaderProgram->attributeLocation("aColor");
@@ -340,6 +384,10 @@ void PlotView::createOriginPlaneData()
 
 void PlotView::paintGL()
 {
+    TRACE_ZONE("PlotView::paintGL");
+
+    beginGpuTimer();
+
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     m_shaderProgram->bind();
@@ -359,16 +407,50 @@ void PlotView::paintGL()
 
     renderData();
 
+    if (m_realTimeLayout == XY_LAYOUT || m_realTimeLayout == XYZ_LAYOUT)
+    {
+        renderStream();
+    }
+
     m_shaderProgram->release();
+
+    if (m_realTimeLayout == HISTOGRAM_LAYOUT)
+    {
+        renderHistogram();
+    }
+    else if (m_realTimeLayout == TIME_SERIES_LAYOUT && m_eventMarkers)
+    {
+        renderEventMarkers();
+    }
+
+    endGpuTimer();
 }
 
 void PlotView::paintEvent(QPaintEvent *event)
 {
+    TRACE_ZONE("PlotView::paintEvent");
+
+    const qint64 frameStart = m_frameClock.nsecsElapsed();
+    m_frameStats.beginFrame(frameStart);
+
     // First render OpenGL content
     QOpenGLWidget::paintEvent(event);
+    const qint64 sceneEnd = m_frameClock.nsecsElapsed();
+    m_frameStats.addStageTime(FrameStats::SCENE_STAGE, sceneEnd - frameStart);
 
     // Then overlay text with QPainter
     QPainter painter(this);
+    renderOverlay(painter);
+    painter.end();
+
+    m_frameStats.addStageTime(FrameStats::OVERLAY_STAGE, m_frameClock.nsecsElapsed() - sceneEnd);
+
+    // Read back the finished frame, overlay included
+    captureFrame();
+}
+
+void PlotView::renderOverlay(QPainter &painter)
+{
     painter.setRenderHint(QPainter::Antialiasing);
 
     // Always render axis numbers even if axis lines are disabled
@@ -380,7 +462,50 @@ void PlotView::paintEvent(QPaintEvent *event)
     // Show current interaction mode
     renderInteractionMode(painter);
 
+    // Show frame timings when enabled
+    renderPerformanceHud(painter);
+
+    // Show estimated device clock drift
+    renderClockDrift(painter);
+
+    // Show trigger state when a trigger is active
+    renderTriggerStatus(painter);
+
+    // Show rolling per-channel statistics
+    renderStatistics(painter);
+
+    // Show the hovered and pinned samples
+    renderPickInfo(painter);
+}
+
+void PlotView::initializeOffscreen()
+{
+    initializeGL();
+}
+
+void PlotView::renderOffscreen(QPaintDevice *overlayDevice)
+{
+    TRACE_ZONE("PlotView::renderOffscreen");
+
+    const qint64 frameStart = m_frameClock.nsecsElapsed();
+    m_frameStats.beginFrame(frameStart);
+
+    // The overlay painter of the previous frame reset the GL state
+    glViewport(0, 0, width(), height());
+    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    paintGL();
+    const qint64 sceneEnd = m_frameClock.nsecsElapsed();
+    m_frameStats.addStageTime(FrameStats::SCENE_STAGE, sceneEnd - frameStart);
+
+    QPainter painter(overlayDevice);
+    renderOverlay(painter);
     painter.end();
+
+    m_frameStats.addStageTime(FrameStats::OVERLAY_STAGE, m_frameClock.nsecsElapsed() - sceneEnd);
 }
 
 void PlotView::renderGrid()
@@ -402,6 +527,7 @@ void PlotView::renderGrid()
 
     m_gridVAO.bind();
     glDrawArrays(GL_LINES, 0, m_gridVertices.size() / 6);
+    m_frameStats.addVertices(m_gridVertices.size() / 6);
     m_gridVAO.release();
 
     // Restore the normal MVP matrix for subsequent rendering
@@ -414,6 +540,7 @@ void PlotView::renderAxes()
     glLineWidth(3.0f);
     m_axisVAO.bind();
     glDrawArrays(GL_LINES, 0, m_axisVertices.size() / 6);
+    m_frameStats.addVertices(m_axisVertices.size() / 6);
     m_axisVAO.release();
     glLineWidth(1.5f);
 }
@@ -423,6 +550,7 @@ void PlotView::renderOriginPlanes()
     glLineWidth(2.5f); // Thicker than grid (1.5f) but thinner than axis lines (3.0f)
     m_originPlaneVAO.bind();
     glDrawArrays(GL_LINES, 0, m_originPlaneVertices.size() / 6);
+    m_frameStats.addVertices(m_originPlaneVertices.size() / 6);
     m_originPlaneVAO.release();
     glLineWidth(1.5f); // Reset to default
 }
@@ -508,6 +636,7 @@ void PlotView::createBackgroundPlaneData()
     m_backgroundPlaneVAO.bind();
     m_backgroundPlaneVertexBuffer.bind();
     m_backgroundPlaneVertexBuffer.allocate(m_backgroundPlaneVertices.data(), m_backgroundPlaneVertices.size() * sizeof(float));
+    m_frameStats.addUpload(m_backgroundPlaneVertices.size() * sizeof(float));
 
     int posLocation = m_shaderProgram->attributeLocation("aPosition");
     int colorLocation = m_shaderProgram->attributeLocation("aColor");
@@ -546,6 +675,7 @@ void PlotView::renderBackgroundPlanes()
 
     m_backgroundPlaneVAO.bind();
     glDrawArrays(GL_TRIANGLES, 0, m_backgroundPlaneVertices.size() / 6);
+    m_frameStats.addVertices(m_backgroundPlaneVertices.size() / 6);
     m_backgroundPlaneVAO.release();
 
     // Restore the normal MVP matrix for subsequent rendering
@@ -555,6 +685,8 @@ void PlotView::renderBackgroundPlanes()
 
 void PlotView::renderData()
 {
+    TRACE_ZONE("PlotView::renderData");
+
     if (m_plotDataSeries.empty())
     {
         return;
@@ -576,6 +708,7 @@ void PlotView::renderData()
         m_vao.bind();
         m_vertexBuffer.bind();
         m_vertexBuffer.allocate(plotData.vertices.data(), plotData.vertices.size() * sizeof(float));
+        m_frameStats.addUpload(plotData.vertices.size() * sizeof(float));
 
         if (posLocation >= 0)
         {
@@ -594,10 +727,13 @@ void PlotView::renderData()
             m_indexBuffer.bind();
             m_indexBuffer.allocate(plotData.indices.data(), plotData.indices.size() * sizeof(unsigned int));
             glDrawElements(plotData.drawMode, plotData.indices.size(), GL_UNSIGNED_INT, 0);
+            m_frameStats.addUpload(plotData.indices.size() * sizeof(unsigned int));
+            m_frameStats.addVertices(plotData.indices.size());
         }
         else
         {
             glDrawArrays(plotData.drawMode, 0, plotData.vertices.size() / 6);
+            m_frameStats.addVertices(plotData.vertices.size() / 6);
         }
 
         m_vao.release();
@@ -607,130 +743,557 @@ void PlotView::renderData()
     glLineWidth(1.5f);
 }
 
-QMatrix4x4 PlotView::getViewMatrix() const
+void PlotView::uploadStreamVertices()
 {
-    QMatrix4x4 view;
-    view.translate(0.0f, 0.0f, -10.0f * m_zoom);
+    const int floatsPerVertex = 6;
+    const int stride = floatsPerVertex * sizeof(float);
+    const int slotCount = m_streamCapacity + 1;
 
-    // Apply panning
-    view.translate(m_panOffset);
+    m_streamVAO.bind();
+    m_streamVertexBuffer.bind();
 
-    if (m_plotMode == PLOT_3D)
+    if (m_streamAllocatedSlots != slotCount)
     {
-        view.rotate(m_viewAngles.getElevation() * 180.0 / M_PI, 1.0f, 0.0f, 0.0f);
-        view.rotate(m_viewAngles.getAzimuth() * 180.0 / M_PI, 0.0f, 1.0f, 0.0f);
+        // (Re)allocate once per capacity change, then only update in place
+        m_streamVertexBuffer.allocate(m_streamVertices.data(), slotCount * stride);
+        m_streamAllocatedSlots = slotCount;
+        m_frameStats.addUpload(slotCount * stride);
+
+        int posLocation = m_shaderProgram->attributeLocation("aPosition");
+        int colorLocation = m_shaderProgram->attributeLocation("aColor");
+
+        if (posLocation >= 0)
+        {
+            glVertexAttribPointer(posLocation, 3, GL_FLOAT, GL_FALSE, stride, (void *)0);
+            glEnableVertexAttribArray(posLocation);
+        }
+
+        if (colorLocation >= 0)
+        {
+            glVertexAttribPointer(colorLocation, 3, GL_FLOAT, GL_FALSE, stride, (void *)(3 * sizeof(float)));
+            glEnableVertexAttribArray(colorLocation);
+        }
+    }
+    else if (m_streamDirtyCount > 0)
+    {
+        // Dirty slots are contiguous in ring order, so at most two writes
+        const int first = m_streamDirtyFirst;
+        const int firstPart = qMin(m_streamDirtyCount, m_streamCapacity - first);
+        m_streamVertexBuffer.write(first * stride, &m_streamVertices[first * floatsPerVertex], firstPart * stride);
+        if (m_streamDirtyCount > firstPart)
+        {
+            m_streamVertexBuffer.write(0, m_streamVertices.data(), (m_streamDirtyCount - firstPart) * stride);
+        }
+        if (m_streamSeamDirty)
+        {
+            m_streamVertexBuffer.write(m_streamCapacity * stride, &m_streamVertices[m_streamCapacity * floatsPerVertex], stride);
+        }
+        m_frameStats.addUpload((m_streamDirtyCount + (m_streamSeamDirty ? 1 : 0)) * stride);
     }
 
-    return view;
+    m_streamDirtyCount = 0;
+    m_streamSeamDirty = false;
+
+    m_streamVAO.release();
 }
 
-QMatrix4x4 PlotView::getProjectionMatrix() const
+void PlotView::renderStream()
 {
-    QMatrix4x4 projection;
-    float aspect = (float)width() / height();
+    if (m_streamCount == 0)
+    {
+        return;
+    }
 
-    if (m_plotMode == PLOT_2D || m_projectionMode == ORTHOGRAPHIC_PROJECTION)
+    if (m_realTimeLayout == XYZ_LAYOUT && m_realTimeStyle == POINT_CLOUD_STYLE &&
+        m_octree.size() > m_lodPointThreshold)
     {
-        projection.ortho(-5.0f * aspect * m_zoom, 5.0f * aspect * m_zoom,
-                         -5.0f * m_zoom, 5.0f * m_zoom, 0.1f, 100.0f);
+        renderOctreeLod();
+        return;
+    }
+
+    uploadStreamVertices();
+
+    m_streamVAO.bind();
+    m_frameStats.addVertices(m_streamCount);
+
+    if (m_realTimeStyle == POINT_CLOUD_STYLE)
+    {
+        glDrawArrays(GL_POINTS, 0, m_streamCount);
     }
     else
     {
-        projection.perspective(m_fov, aspect, 0.1f, 100.0f);
+        glLineWidth(2.0f);
+        if (m_streamCount < m_streamCapacity || m_streamHead == 0)
+        {
+            glDrawArrays(GL_LINE_STRIP, 0, m_streamCount);
+        }
+        else
+        {
+            // Oldest vertex is at the head; the extra slot continues into slot 0
+            glDrawArrays(GL_LINE_STRIP, m_streamHead, m_streamCapacity + 1 - m_streamHead);
+            if (m_streamHead > 1)
+            {
+                glDrawArrays(GL_LINE_STRIP, 0, m_streamHead);
+            }
+        }
+        glLineWidth(1.5f);
     }
 
-    return projection;
+    m_streamVAO.release();
 }
 
-void PlotView::resizeGL(int w, int h)
+void PlotView::renderOctreeLod()
 {
-    glViewport(0, 0, w, h);
-}
+    const QMatrix4x4 mvp = getProjectionMatrix() * getViewMatrix();
 
-void PlotView::mousePressEvent(QMouseEvent *event)
-{
-    m_lastMousePos = event->pos();
-    m_mousePressed = true;
-}
+    m_lodVAO.bind();
 
-void PlotView::mouseMoveEvent(QMouseEvent *event)
-{
-    if (!m_mousePressed)
-        return;
+    if (m_octreeDirty || mvp != m_lodMVP)
+    {
+        m_lodPoints.clear();
+        m_octree.selectVisible(mvp.constData(), width(), height(), m_lodPixelThreshold, m_lodPoints);
 
-    QPoint delta = event->pos() - m_lastMousePos;
+        m_lodVertices.resize(m_lodPoints.size() * 6);
+        for (size_t i = 0; i < m_lodPoints.size(); ++i)
+        {
+            float *vertex = &m_lodVertices[i * 6];
+            vertex[0] = m_lodPoints[i].x;
+            vertex[1] = m_lodPoints[i].y;
+            vertex[2] = m_lodPoints[i].z;
+            vertex[3] = 0.1f; // Same color as the streamed points
+            vertex[4] = 0.4f;
+            vertex[5] = 0.9f;
+        }
 
-    switch (m_interactionMode)
-    {
-    case ROTATE_MODE:
-        if (m_plotMode == PLOT_3D)
+        m_lodVertexBuffer.bind();
+        m_lodVertexBuffer.allocate(m_lodVertices.data(), m_lodVertices.size() * sizeof(float));
+        m_frameStats.addUpload(m_lodVertices.size() * sizeof(float));
+
+        int posLocation = m_shaderProgram->attributeLocation("aPosition");
+        int colorLocation = m_shaderProgram->attributeLocation("aColor");
+
+        if (posLocation >= 0)
         {
-            double deltaAzimuth = delta.x() * 0.01;
-            double deltaElevation = delta.y() * 0.01;
-            m_viewAngles.changeAnglesWithDelta(deltaAzimuth, deltaElevation);
-            createGridData();            // Update grid for new view angles
-            createOriginPlaneData();     // Update origin planes for new view angles
-            createBackgroundPlaneData(); // Update background planes for new view angles
+            glVertexAttribPointer(posLocation, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)0);
+            glEnableVertexAttribArray(posLocation);
         }
-        break;
 
-    case ZOOM_MODE:
-    {
-        float zoomFactor = 1.0f + (-delta.y() * 0.01f);
-        m_zoom = qMax(0.1f, qMin(5.0f, m_zoom * zoomFactor));
-        createGridData();            // Update grid for new zoom level
-        createOriginPlaneData();     // Update origin planes for new zoom level
-        createBackgroundPlaneData(); // Update background planes to maintain constant visual size
-    }
-    break;
+        if (colorLocation >= 0)
+        {
+            glVertexAttribPointer(colorLocation, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)(3 * sizeof(float)));
+            glEnableVertexAttribArray(colorLocation);
+        }
 
-    case PAN_MODE:
-    {
-        float panSpeed = 0.01f * m_zoom;
-        
-        // Convert mouse movement to 3D world coordinates based on current view angles
-        double azimuth = m_viewAngles.getAzimuth();
-        double elevation = m_viewAngles.getElevation();
-        
-        // Calculate the right and up vectors in world space based on view orientation
-        // Right vector (screen X direction in world space)
-        float rightX = cos(azimuth);
-        float rightY = sin(azimuth);
-        float rightZ = 0.0f;
-        
-        // Up vector (screen Y direction in world space) 
-        float upX = -sin(azimuth) * sin(elevation);
-        float upY = cos(azimuth) * sin(elevation);
-        float upZ = cos(elevation);
-        
-        // Apply mouse delta to 3D pan offset using view-oriented vectors
-        float deltaX = delta.x() * panSpeed;
-        float deltaY = -delta.y() * panSpeed; // Invert Y for intuitive panning
-        
-        m_panOffset.setX(m_panOffset.x() + deltaX * rightX + deltaY * upX);
-        m_panOffset.setY(m_panOffset.y() + deltaX * rightY + deltaY * upY);
-        m_panOffset.setZ(m_panOffset.z() + deltaX * rightZ + deltaY * upZ);
-        
-        createGridData();                                         // Update grid lines to shift within the fixed box frame
-        createOriginPlaneData();                                  // Update origin planes for new pan position
-        // Background planes stay centered and don't need updates for panning
-    }
-    break;
+        m_lodVertexCount = static_cast<int>(m_lodPoints.size());
+        m_lodMVP = mvp;
+        m_octreeDirty = false;
     }
 
-    m_lastMousePos = event->pos();
-    update();
-}
+    glDrawArrays(GL_POINTS, 0, m_lodVertexCount);
+    m_frameStats.addVertices(m_lodVertexCount);
 
-void PlotView::mouseReleaseEvent(QMouseEvent *event)
-{
-    Q_UNUSED(event);
-    m_mousePressed = false;
+    m_lodVAO.release();
 }
 
-void PlotView::wheelEvent(QWheelEvent *event)
+void PlotView::renderHistogram()
 {
-    float zoomFactor = 1.0f + (event->angleDelta().y() / 1200.0f);
+    if (m_histogram.total == 0)
+    {
+        return;
+    }
+
+    if (m_histogramDirty)
+    {
+        // Per bar: left edge, width, height. Empty bins are skipped.
+        const uint64_t maxCount = *std::max_element(m_histogram.counts.begin(), m_histogram.counts.end());
+        const float width = static_cast<float>(m_histogram.binWidth * 0.9); // Small gap between bars
+
+        m_barInstances.clear();
+        for (size_t i = 0; i < m_histogram.counts.size(); ++i)
+        {
+            if (m_histogram.counts[i] == 0)
+            {
+                continue;
+            }
+            const float left = static_cast<float>(m_histogram.firstEdge + i * m_histogram.binWidth);
+            const float height = m_histogramHeight * m_histogram.counts[i] / maxCount;
+            m_barInstances.insert(m_barInstances.end(), {left, width, height});
+        }
+        m_barCount = static_cast<int>(m_barInstances.size() / 3);
+    }
+
+    const QMatrix4x4 mvp = getProjectionMatrix() * getViewMatrix();
+
+    if (m_instancingSupported)
+    {
+        QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+
+        m_barShaderProgram->bind();
+        m_barShaderProgram->setUniformValue("uMVPMatrix", mvp);
+        m_barShaderProgram->setUniformValue("uColor", QVector3D(0.2f, 0.5f, 0.85f));
+
+        m_barVAO.bind();
+
+        if (!m_barBuffersReady)
+        {
+            // Two triangles of the unit quad, shared by every bar
+            const float corners[] = {0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f,
+                                     0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f};
+            m_barQuadBuffer.bind();
+            m_barQuadBuffer.allocate(corners, sizeof(corners));
+            const int cornerLocation = m_barShaderProgram->attributeLocation("aCorner");
+            f->glVertexAttribPointer(cornerLocation, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
+            f->glEnableVertexAttribArray(cornerLocation);
+
+            m_barInstanceBuffer.bind();
+            m_barInstanceBuffer.allocate(m_barInstances.data(), m_barInstances.size() * sizeof(float));
+            m_frameStats.addUpload(m_barInstances.size() * sizeof(float));
+            const int barLocation = m_barShaderProgram->attributeLocation("aBar");
+            f->glVertexAttribPointer(barLocation, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
+            f->glEnableVertexAttribArray(barLocation);
+            f->glVertexAttribDivisor(barLocation, 1);
+
+            m_barBuffersReady = true;
+        }
+        else if (m_histogramDirty)
+        {
+            m_barInstanceBuffer.bind();
+            m_barInstanceBuffer.allocate(m_barInstances.data(), m_barInstances.size() * sizeof(float));
+            m_frameStats.addUpload(m_barInstances.size() * sizeof(float));
+        }
+
+        f->glDrawArraysInstanced(GL_TRIANGLES, 0, 6, m_barCount);
+        m_frameStats.addVertices(6 * m_barCount);
+
+        m_barVAO.release();
+        m_barShaderProgram->release();
+    }
+    else
+    {
+        // Expand every bar to two triangles for the regular shader
+        m_shaderProgram->bind();
+        m_shaderProgram->setUniformValue("uMVPMatrix", mvp);
+
+        // Without instancing the quad buffer holds the expanded bars
+        m_barVAO.bind();
+        m_barQuadBuffer.bind();
+
+        if (m_histogramDirty || !m_barBuffersReady)
+        {
+            m_barVertices.clear();
+            m_barVertices.reserve(m_barCount * 36);
+            for (int i = 0; i < m_barCount; ++i)
+            {
+                const float left = m_barInstances[i * 3];
+                const float right = left + m_barInstances[i * 3 + 1];
+                const float top = m_barInstances[i * 3 + 2];
+                m_barVertices.insert(m_barVertices.end(), {left, 0.0f, 0.0f, 0.2f, 0.5f, 0.85f,
+                                                           right, 0.0f, 0.0f, 0.2f, 0.5f, 0.85f,
+                                                           right, top, 0.0f, 0.2f, 0.5f, 0.85f,
+                                                           left, 0.0f, 0.0f, 0.2f, 0.5f, 0.85f,
+                                                           right, top, 0.0f, 0.2f, 0.5f, 0.85f,
+                                                           left, top, 0.0f, 0.2f, 0.5f, 0.85f});
+            }
+            m_barQuadBuffer.allocate(m_barVertices.data(), m_barVertices.size() * sizeof(float));
+            m_frameStats.addUpload(m_barVertices.size() * sizeof(float));
+
+            int posLocation = m_shaderProgram->attributeLocation("aPosition");
+            int colorLocation = m_shaderProgram->attributeLocation("aColor");
+
+            if (posLocation >= 0)
+            {
+                glVertexAttribPointer(posLocation, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)0);
+                glEnableVertexAttribArray(posLocation);
+            }
+
+            if (colorLocation >= 0)
+            {
+                glVertexAttribPointer(colorLocation, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)(3 * sizeof(float)));
+                glEnableVertexAttribArray(colorLocation);
+            }
+
+            m_barBuffersReady = true;
+        }
+
+        glDrawArrays(GL_TRIANGLES, 0, m_barCount * 6);
+        m_frameStats.addVertices(6 * m_barCount);
+
+        m_barVAO.release();
+        m_shaderProgram->release();
+    }
+
+    m_histogramDirty = false;
+}
+
+void PlotView::renderEventMarkers()
+{
+    double origin = 0.0;
+    double direction = 0.0;
+    if (m_eventIndex.size() == 0 || !timeSeriesMapping(origin, direction))
+    {
+        return;
+    }
+
+    const QMatrix4x4 mvp = getProjectionMatrix() * getViewMatrix();
+
+    // Fetch only the events in view; all of them if the view does not bound time
+    double firstTime = -std::numeric_limits<double>::infinity();
+    double lastTime = std::numeric_limits<double>::infinity();
+    screenRectToTimeRange(mvp, QRectF(rect()), origin, direction, firstTime, lastTime);
+
+    m_visibleEvents.clear();
+    if (m_eventIndex.query(firstTime, lastTime, m_visibleEvents) == 0)
+    {
+        return;
+    }
+
+    // Per marker: position and colour. Green/grey mark the threshold
+    // crossings, red the peak.
+    m_glyphInstances.clear();
+    const auto addMarker = [&](double timestamp, float value, int channel, float r, float g, float b) {
+        m_glyphInstances.insert(m_glyphInstances.end(), {static_cast<float>(direction * (timestamp - origin)), value,
+                                                         static_cast<float>(channel), r, g, b});
+    };
+    for (const auto &event : m_visibleEvents)
+    {
+        addMarker(event.startTime, event.startValue, event.channel, 0.1f, 0.7f, 0.2f);
+        addMarker(event.peakTime, event.peakValue, event.channel, 0.9f, 0.1f, 0.1f);
+        addMarker(event.endTime, event.endValue, event.channel, 0.5f, 0.5f, 0.5f);
+    }
+    const int markerCount = static_cast<int>(m_glyphInstances.size() / 6);
+
+    glDisable(GL_DEPTH_TEST); // Markers stay on top of the series
+
+    if (m_instancingSupported)
+    {
+        QOpenGLExtraFunctions *f = QOpenGLContext::currentContext()->extraFunctions();
+
+        m_glyphShaderProgram->bind();
+        m_glyphShaderProgram->setUniformValue("uMVPMatrix", mvp);
+        m_glyphShaderProgram->setUniformValue("uPixelSize", QVector2D(2.0f / width(), 2.0f / height()));
+
+        m_glyphVAO.bind();
+
+        m_glyphInstanceBuffer.bind();
+        m_glyphInstanceBuffer.allocate(m_glyphInstances.data(), m_glyphInstances.size() * sizeof(float));
+        m_frameStats.addUpload(m_glyphInstances.size() * sizeof(float));
+
+        if (!m_glyphBuffersReady)
+        {
+            const int positionLocation = m_glyphShaderProgram->attributeLocation("aPosition");
+            const int colorLocation = m_glyphShaderProgram->attributeLocation("aColor");
+            f->glVertexAttribPointer(positionLocation, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)0);
+            f->glEnableVertexAttribArray(positionLocation);
+            f->glVertexAttribDivisor(positionLocation, 1);
+            f->glVertexAttribPointer(colorLocation, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)(3 * sizeof(float)));
+            f->glEnableVertexAttribArray(colorLocation);
+            f->glVertexAttribDivisor(colorLocation, 1);
+
+            // Diamond, 6 pixels from centre to tip
+            const float diamond[] = {0.0f, 6.0f, -6.0f, 0.0f, 6.0f, 0.0f,
+                                     6.0f, 0.0f, -6.0f, 0.0f, 0.0f, -6.0f};
+            m_glyphMeshBuffer.bind();
+            m_glyphMeshBuffer.allocate(diamond, sizeof(diamond));
+            const int cornerLocation = m_glyphShaderProgram->attributeLocation("aCorner");
+            f->glVertexAttribPointer(cornerLocation, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
+            f->glEnableVertexAttribArray(cornerLocation);
+
+            m_glyphBuffersReady = true;
+        }
+
+        f->glDrawArraysInstanced(GL_TRIANGLES, 0, 6, markerCount);
+        m_frameStats.addVertices(6 * markerCount);
+
+        m_glyphVAO.release();
+        m_glyphShaderProgram->release();
+    }
+    else
+    {
+        // Large points with the regular shader; instances share its layout
+        m_shaderProgram->bind();
+        m_shaderProgram->setUniformValue("uMVPMatrix", mvp);
+
+        m_glyphVAO.bind();
+        m_glyphInstanceBuffer.bind();
+        m_glyphInstanceBuffer.allocate(m_glyphInstances.data(), m_glyphInstances.size() * sizeof(float));
+        m_frameStats.addUpload(m_glyphInstances.size() * sizeof(float));
+
+        if (!m_glyphBuffersReady)
+        {
+            int posLocation = m_shaderProgram->attributeLocation("aPosition");
+            int colorLocation = m_shaderProgram->attributeLocation("aColor");
+
+            if (posLocation >= 0)
+            {
+                glVertexAttribPointer(posLocation, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)0);
+                glEnableVertexAttribArray(posLocation);
+            }
+
+            if (colorLocation >= 0)
+            {
+                glVertexAttribPointer(colorLocation, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)(3 * sizeof(float)));
+                glEnableVertexAttribArray(colorLocation);
+            }
+
+            m_glyphBuffersReady = true;
+        }
+
+        glPointSize(9.0f);
+        glDrawArrays(GL_POINTS, 0, markerCount);
+        m_frameStats.addVertices(markerCount);
+        glPointSize(3.0f);
+
+        m_glyphVAO.release();
+        m_shaderProgram->release();
+    }
+
+    glEnable(GL_DEPTH_TEST);
+}
+
+QMatrix4x4 PlotView::getViewMatrix() const
+{
+    QMatrix4x4 view;
+    view.translate(0.0f, 0.0f, -10.0f * m_zoom);
+
+    // Apply panning
+    view.translate(m_panOffset);
+
+    if (m_plotMode == PLOT_3D)
+    {
+        view.rotate(m_viewAngles.getElevation() * 180.0 / M_PI, 1.0f, 0.0f, 0.0f);
+        view.rotate(m_viewAngles.getAzimuth() * 180.0 / M_PI, 0.0f, 1.0f, 0.0f);
+    }
+
+    return view;
+}
+
+QMatrix4x4 PlotView::getProjectionMatrix() const
+{
+    QMatrix4x4 projection;
+    float aspect = (float)width() / height();
+
+    if (m_plotMode == PLOT_2D || m_projectionMode == ORTHOGRAPHIC_PROJECTION)
+    {
+        projection.ortho(-5.0f * aspect * m_zoom, 5.0f * aspect * m_zoom,
+                         -5.0f * m_zoom, 5.0f * m_zoom, 0.1f, 100.0f);
+    }
+    else
+    {
+        projection.perspective(m_fov, aspect, 0.1f, 100.0f);
+    }
+
+    return projection;
+}
+
+void PlotView::resizeGL(int w, int h)
+{
+    glViewport(0, 0, w, h);
+}
+
+void PlotView::mousePressEvent(QMouseEvent *event)
+{
+    m_lastMousePos = event->pos();
+    m_pressMousePos = event->pos();
+    m_mousePressed = true;
+    m_hoverPick = PickResult(); // No hover info while dragging
+}
+
+void PlotView::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!m_mousePressed)
+    {
+        m_lastMousePos = event->pos();
+        m_hoverPick = pickNearest(event->pos());
+        update();
+        return;
+    }
+
+    QPoint delta = event->pos() - m_lastMousePos;
+
+    switch (m_interactionMode)
+    {
+    case ROTATE_MODE:
+        if (m_plotMode == PLOT_3D)
+        {
+            double deltaAzimuth = delta.x() * 0.01;
+            double deltaElevation = delta.y() * 0.01;
+            m_viewAngles.changeAnglesWithDelta(deltaAzimuth, deltaElevation);
+            createGridData();            // Update grid for new view angles
+            createOriginPlaneData();     // Update origin planes for new view angles
+            createBackgroundPlaneData(); // Update background planes for new view angles
+        }
+        break;
+
+    case ZOOM_MODE:
+    {
+        float zoomFactor = 1.0f + (-delta.y() * 0.01f);
+        m_zoom = qMax(0.1f, qMin(5.0f, m_zoom * zoomFactor));
+        createGridData();            // Update grid for new zoom level
+        createOriginPlaneData();     // Update origin planes for new zoom level
+        createBackgroundPlaneData(); // Update background planes to maintain constant visual size
+    }
+    break;
+
+    case PAN_MODE:
+    {
+        float panSpeed = 0.01f * m_zoom;
+        
+        // Convert mouse movement to 3D world coordinates based on current view angles
+        double azimuth = m_viewAngles.getAzimuth();
+        double elevation = m_viewAngles.getElevation();
+        
+        // Calculate the right and up vectors in world space based on view orientation
+        // Right vector (screen X direction in world space)
+        float rightX = cos(azimuth);
+        float rightY = sin(azimuth);
+        float rightZ = 0.0f;
+        
+        // Up vector (screen Y direction in world space) 
+        float upX = -sin(azimuth) * sin(elevation);
+        float upY = cos(azimuth) * sin(elevation);
+        float upZ = cos(elevation);
+        
+        // Apply mouse delta to 3D pan offset using view-oriented vectors
+        float deltaX = delta.x() * panSpeed;
+        float deltaY = -delta.y() * panSpeed; // Invert Y for intuitive panning
+        
+        m_panOffset.setX(m_panOffset.x() + deltaX * rightX + deltaY * upX);
+        m_panOffset.setY(m_panOffset.y() + deltaX * rightY + deltaY * upY);
+        m_panOffset.setZ(m_panOffset.z() + deltaX * rightZ + deltaY * upZ);
+        
+        createGridData();                                         // Update grid lines to shift within the fixed box frame
+        createOriginPlaneData();                                  // Update origin planes for new pan position
+        // Background planes stay centered and don't need updates for panning
+    }
+    break;
+    }
+
+    m_lastMousePos = event->pos();
+    update();
+}
+
+void PlotView::mouseReleaseEvent(QMouseEvent *event)
+{
+    m_mousePressed = false;
+
+    // A click without dragging pins the nearest sample, or unpins on empty space
+    if (event->button() == Qt::LeftButton && (event->pos() - m_pressMousePos).manhattanLength() < 3)
+    {
+        m_pinnedPick = pickNearest(event->pos());
+        update();
+    }
+}
+
+void PlotView::leaveEvent(QEvent *event)
+{
+    m_hoverPick = PickResult();
+    update();
+    QOpenGLWidget::leaveEvent(event);
+}
+
+void PlotView::wheelEvent(QWheelEvent *event)
+{
+    float zoomFactor = 1.0f + (event->angleDelta().y() / 1200.0f);
     m_zoom = qMax(0.1f, qMin(5.0f, m_zoom * zoomFactor));
     createGridData();            // Update grid for new zoom level
     createOriginPlaneData();     // Update origin planes for new zoom level
@@ -741,9 +1304,34 @@ void PlotView::wheelEvent(QWheelEvent *event)
 void PlotView::updateAnimation()
 {
     m_animationTime += 0.016f;
+
+    // Dump requested from outside the UI, e.g. by SIGUSR1
+    if (Tracer::takeDumpRequest())
+    {
+        dumpTrace();
+    }
+
     update();
 }
 
+void PlotView::dumpTrace()
+{
+#ifdef ENABLE_TRACING
+    const QString path = QDir::current().filePath(
+        QString("trace_%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss")));
+    if (Tracer::writeChromeTrace(path.toStdString()))
+    {
+        qDebug() << "Trace written to" << path;
+    }
+    else
+    {
+        qWarning() << "Failed to write trace to" << path;
+    }
+#else
+    qDebug() << "Tracing is disabled in this build (ENABLE_TRACING)";
+#endif
+}
+
 void PlotView::setPlotData(const PlotData &data)
 {
     m_plotDataSeries.clear();
@@ -770,20 +1358,7 @@ void PlotView::addDataSeries(const std::vector<float> &xData, const std::vector<
                              const std::vector<float> &zData, float lineWidth)
 {
     PlotData newSeries;
-    newSeries.vertices.clear();
-
-    size_t count = std::min(xData.size(), yData.size());
-    bool hasZ = !zData.empty() && zData.size() >= count;
-
-    for (size_t i = 0; i < count; ++i)
-    {
-        float z = hasZ ? zData[i] : 0.0f;
-        float colorR = (float)i / count; // Gradient from red to cyan
-        float colorG = 1.0f - colorR;
-        float colorB = 0.8f;
-
-        newSeries.vertices.insert(newSeries.vertices.end(), {xData[i], yData[i], z, colorR, colorG, colorB});
-    }
+    buildSeriesVertices(xData, yData, zData, newSeries.vertices);
 
     newSeries.drawMode = GL_LINE_STRIP;
     newSeries.lineWidth = lineWidth;
@@ -792,6 +1367,20 @@ void PlotView::addDataSeries(const std::vector<float> &xData, const std::vector<
     update();
 }
 
+void PlotView::setSingleDataSeries(const std::vector<float> &xData, const std::vector<float> &yData,
+                                   const std::vector<float> &zData, float lineWidth)
+{
+    // Same as clearData() + addDataSeries(), but keeps the first series'
+    // vertex storage so a streaming update does not reallocate it
+    m_plotDataSeries.resize(1);
+    PlotData &series = m_plotDataSeries.front();
+    buildSeriesVertices(xData, yData, zData, series.vertices);
+    series.indices.clear();
+    series.drawMode = GL_LINE_STRIP;
+    series.lineWidth = lineWidth;
+    update();
+}
+
 void PlotView::addPlotData(const PlotData &data)
 {
     m_plotDataSeries.push_back(data);
@@ -836,19 +1425,44 @@ void PlotView::resetView()
 void PlotView::setViewAngles(double azimuth, double elevation)
 {
     m_viewAngles.setAngles(azimuth, elevation);
+    if (m_shaderProgram) // Otherwise initializeGL() builds them
+    {
+        makeCurrent();
+        createGridData();            // Update grid for new view angles
+        createBackgroundPlaneData(); // Update background planes for new view angles
+        doneCurrent();
+    }
     update();
 }
 
-void PlotView::setAxisLabels(const QString &xLabel, const QString &yLabel, const QString &zLabel)
-{
-    m_xLabel = xLabel;
-    m_yLabel = yLabel;
-    m_zLabel = zLabel;
-}
-
-QVector3D PlotView::worldToScreen(const QVector3D &worldPos) const
+void PlotView::setZoom(float zoom)
+{
+    m_zoom = qMax(0.1f, qMin(5.0f, zoom));
+    if (m_shaderProgram) // Otherwise initializeGL() builds them
+    {
+        makeCurrent();
+        createGridData();            // Update grid for new zoom level
+        createOriginPlaneData();     // Update origin planes for new zoom level
+        createBackgroundPlaneData(); // Update background planes to maintain constant visual size
+        doneCurrent();
+    }
+    update();
+}
+
+void PlotView::setAxisLabels(const QString &xLabel, const QString &yLabel, const QString &zLabel)
+{
+    m_xLabel = xLabel;
+    m_yLabel = yLabel;
+    m_zLabel = zLabel;
+}
+
+QVector3D PlotView::worldToScreen(const QVector3D &worldPos) const
+{
+    return worldToScreen(getProjectionMatrix() * getViewMatrix(), worldPos);
+}
+
+QVector3D PlotView::worldToScreen(const QMatrix4x4 &mvpMatrix, const QVector3D &worldPos) const
 {
-    QMatrix4x4 mvpMatrix = getProjectionMatrix() * getViewMatrix();
     QVector4D worldPos4(worldPos, 1.0f);
     QVector4D clipPos = mvpMatrix * worldPos4;
 
@@ -872,140 +1486,63 @@ void PlotView::renderAxisNumbers(QPainter &painter)
     painter.setPen(QPen(Qt::black, 1));
     painter.setFont(QFont("Arial", 8));
 
-    // Dynamic grid parameters matching createGridData()
-    const float step = calculateOptimalGridStep();
-    const float visibleSize = getVisibleWorldSize();
-    const float boxSize = visibleSize * 0.6f;
-
-    // Get current view angles to determine which box faces are visible (matching createGridData)
-    const double azimuth = m_viewAngles.getAzimuth();
-    const double elevation = m_viewAngles.getElevation();
-
-    // Box frame stays centered at origin, but grid lines shift with panning (matching createGridData)
-    const float boxHalfSize = boxSize * 0.5f;
+    // Same layout as createGridData()
+    const GridLayout layout = computeGridLayout(getVisibleWorldSize(), m_panOffset.x(), m_panOffset.y(),
+                                                m_panOffset.z(), m_viewAngles.getAzimuth(),
+                                                m_viewAngles.getElevation());
+    const float step = layout.step;
+    const float boxHalfSize = layout.boxHalfSize;
     const float boxMinX = -boxHalfSize;
     const float boxMaxX = boxHalfSize;
     const float boxMinY = -boxHalfSize;
     const float boxMaxY = boxHalfSize;
-    const float boxMinZ = -boxHalfSize;
     const float boxMaxZ = boxHalfSize;
+    const float xPlane = layout.xPlane;
+    const float yPlane = layout.yPlane;
+    const float zPlane = layout.zPlane;
 
-    // With smooth sliding grid, numbers should show actual world coordinates (matching createGridData)
-
-    // Calculate fractional offset within one grid step (matching createGridData)
-    // Grid lines should move in same direction as pan for intuitive behavior
-    const float fracOffsetX = fmod(m_panOffset.x(), step);
-    const float fracOffsetY = fmod(m_panOffset.y(), step);
-    const float fracOffsetZ = -fmod(m_panOffset.z(), step);
-
-    // Use extended range for numbers (matching createGridData)
-    const float margin = step * 2.0f;
-    const float extendedMinX = boxMinX - margin;
-    const float extendedMaxX = boxMaxX + margin;
-    const float extendedMinY = boxMinY - margin;
-    const float extendedMaxY = boxMaxY + margin;
-    const float extendedMinZ = boxMinZ - margin;
-    const float extendedMaxZ = boxMaxZ + margin;
-
-    // Calculate grid line positions (matching createGridData)
-    const int startX = (int)floor(extendedMinX / step);
-    const int endX = (int)ceil(extendedMaxX / step);
-    const int startY = (int)floor(extendedMinY / step);
-    const int endY = (int)ceil(extendedMaxY / step);
-    const int startZ = (int)floor(extendedMinZ / step);
-    const int endZ = (int)ceil(extendedMaxZ / step);
-
-    // Determine which box faces to show (matching createGridData)
-    const bool showPositiveZ = cos(elevation) * cos(azimuth) > 0;
-    const bool showPositiveY = sin(elevation) > 0;
-    const bool showPositiveX = cos(elevation) * sin(azimuth) > 0;
-
-    // Select plane positions (matching createGridData)
-    const float zPlane = showPositiveZ ? boxMinZ : boxMaxZ;
-    const float yPlane = showPositiveY ? boxMinY : boxMaxY;
-    const float xPlane = showPositiveX ? boxMaxX : boxMinX;
+    // Z numbers along the XZ plane only in 3D
+    buildGridTicks(layout, m_plotMode == PLOT_3D || m_projectionMode == PERSPECTIVE_PROJECTION, m_gridTicks);
 
     // Determine decimal places for clean number display
     int decimalPlaces = (step >= 1.0f) ? 0 : (step >= 0.1f) ? 1
                                                             : 2;
 
-    // X-axis numbers along XY plane (at far Z position)
-    for (int i = startX; i <= endX; ++i)
+    const QMatrix4x4 mvpMatrix = getProjectionMatrix() * getViewMatrix();
+    for (const GridTick &tick : m_gridTicks)
     {
-        float x = i * step + fracOffsetX; // Include fractional offset for smooth sliding
-        QVector3D worldPos(x, boxMinY, zPlane);
-        QVector3D screenPos = worldToScreen(worldPos);
-
-        if (screenPos.z() > -1.0f && screenPos.z() < 1.0f)
+        QVector3D screenPos = worldToScreen(mvpMatrix, QVector3D(tick.position[0], tick.position[1], tick.position[2]));
+        if (screenPos.z() <= -1.0f || screenPos.z() >= 1.0f)
         {
-            // Show the "nice" step value, not the offset position
-            float labelValue = i * step;
-            QString text = QString::number(labelValue, 'f', decimalPlaces);
-            QRect textRect = painter.fontMetrics().boundingRect(text);
-
-            int textX = (int)screenPos.x() - textRect.width() / 2;
-            int textY = (int)screenPos.y() + textRect.height() + 5;
-
-            if (textX >= 0 && textX + textRect.width() <= width() &&
-                textY >= 0 && textY <= height())
-            {
-                painter.drawText(textX, textY, text);
-            }
+            continue;
         }
-    }
 
-    // Y-axis numbers along XY plane (at far Z position)
-    for (int i = startY; i <= endY; ++i)
-    {
-        float y = i * step + fracOffsetY; // Include fractional offset for smooth sliding
-        QVector3D worldPos(boxMinX, y, zPlane);
-        QVector3D screenPos = worldToScreen(worldPos);
+        QString text = QString::number(tick.value, 'f', decimalPlaces);
+        QRect textRect = painter.fontMetrics().boundingRect(text);
 
-        if (screenPos.z() > -1.0f && screenPos.z() < 1.0f)
+        int textX;
+        int textY;
+        if (tick.axis == 0)
         {
-            // Show the "nice" step value, not the offset position
-            float labelValue = i * step;
-            QString text = QString::number(labelValue, 'f', decimalPlaces);
-            QRect textRect = painter.fontMetrics().boundingRect(text);
-
-            int textX = (int)screenPos.x() - textRect.width() - 5;
-            int textY = (int)screenPos.y() + textRect.height() / 2;
-
-            if (textX >= 0 && textX + textRect.width() <= width() &&
-                textY >= 0 && textY <= height())
-            {
-                painter.drawText(textX, textY, text);
-            }
+            textX = (int)screenPos.x() - textRect.width() / 2;
+            textY = (int)screenPos.y() + textRect.height() + 5;
         }
-    }
-
-    // Z-axis numbers along XZ plane (at far Y position) when in 3D mode
-    if (m_plotMode == PLOT_3D || m_projectionMode == PERSPECTIVE_PROJECTION)
-    {
-        for (int i = startZ; i <= endZ; ++i)
+        else if (tick.axis == 1)
+        {
+            textX = (int)screenPos.x() - textRect.width() - 5;
+            textY = (int)screenPos.y() + textRect.height() / 2;
+        }
+        else
         {
-            float z = i * step + fracOffsetZ; // Include fractional offset for smooth sliding
-            QVector3D worldPos(boxMinX, yPlane, z);
-            QVector3D screenPos = worldToScreen(worldPos);
+            textX = (int)screenPos.x() + 5;
+            textY = (int)screenPos.y() + textRect.height() / 2;
+        }
 
-            if (screenPos.z() > -1.0f && screenPos.z() < 1.0f)
-            {
-                // Show the "nice" step value, not the offset position
-                float labelValue = i * step;
-                QString text = QString::number(labelValue, 'f', decimalPlaces);
-                QRect textRect = painter.fontMetrics().boundingRect(text);
-
-                int textX = (int)screenPos.x() + 5;
-                int textY = (int)screenPos.y() + textRect.height() / 2;
-
-                if (textX >= 0 && textX + textRect.width() <= width() &&
-                    textY >= 0 && textY <= height())
-                {
-                    painter.setPen(QPen(Qt::cyan, 1)); // Different color for Z
-                    painter.drawText(textX, textY, text);
-                    painter.setPen(QPen(Qt::black, 1)); // Reset color
-                }
-            }
+        if (textX >= 0 && textX + textRect.width() <= width() &&
+            textY >= 0 && textY <= height())
+        {
+            painter.setPen(QPen(tick.axis == 2 ? Qt::cyan : Qt::black, 1)); // Different color for Z
+            painter.drawText(textX, textY, text);
         }
     }
 
@@ -1144,257 +1681,1586 @@ void PlotView::renderAxisLabels(QPainter &painter)
     QVector3D zAxisEnd = worldToScreen(QVector3D(0.0f, 0.0f, axisLength));
     if (zAxisEnd.z() > -1.0f && zAxisEnd.z() < 1.0f)
     {
-        painter.setPen(QPen(Qt::blue, 2));
-        QString text = "Z";
-        QRect textRect = painter.fontMetrics().boundingRect(text);
-        int textX = (int)zAxisEnd.x() + 5;
-        int textY = (int)zAxisEnd.y() - 5;
-        
-        if (textX >= 0 && textX + textRect.width() <= width() &&
-            textY >= 0 && textY <= height())
-        {
-            painter.drawText(textX, textY, text);
-        }
+        painter.setPen(QPen(Qt::blue, 2));
+        QString text = "Z";
+        QRect textRect = painter.fontMetrics().boundingRect(text);
+        int textX = (int)zAxisEnd.x() + 5;
+        int textY = (int)zAxisEnd.y() - 5;
+        
+        if (textX >= 0 && textX + textRect.width() <= width() &&
+            textY >= 0 && textY <= height())
+        {
+            painter.drawText(textX, textY, text);
+        }
+    }
+}
+
+void PlotView::keyPressEvent(QKeyEvent *event)
+{
+    switch (event->key())
+    {
+    case Qt::Key_Z:
+        m_interactionMode = ZOOM_MODE;
+        setCursor(Qt::SizeVerCursor);
+        update();
+        break;
+    case Qt::Key_P:
+        m_interactionMode = PAN_MODE;
+        setCursor(Qt::OpenHandCursor);
+        update();
+        break;
+    case Qt::Key_R:
+    case Qt::Key_Escape:
+        m_interactionMode = ROTATE_MODE;
+        setCursor(Qt::ArrowCursor);
+        update();
+        break;
+    case Qt::Key_V:
+        toggleProjectionMode();
+        break;
+    case Qt::Key_N:
+        decreaseFOV();
+        break;
+    case Qt::Key_M:
+        increaseFOV();
+        break;
+    case Qt::Key_T:
+        // Cycle trigger: off -> normal -> single shot -> off
+        if (!m_triggerDisplay)
+        {
+            m_triggerSettings.mode = TriggerEngine::NORMAL_MODE;
+            setTriggerSettings(m_triggerSettings);
+            armTrigger();
+        }
+        else if (m_triggerSettings.mode == TriggerEngine::NORMAL_MODE)
+        {
+            m_triggerSettings.mode = TriggerEngine::SINGLE_SHOT_MODE;
+            setTriggerSettings(m_triggerSettings);
+            armTrigger();
+        }
+        else
+        {
+            disableTrigger();
+        }
+        break;
+    case Qt::Key_L:
+        // Cycle real-time layout: time series -> XY -> XYZ -> histogram
+        setRealTimeLayout(static_cast<RealTimeLayout>((m_realTimeLayout + 1) % (HISTOGRAM_LAYOUT + 1)),
+                          m_layoutChannels[0], m_layoutChannels[1], m_layoutChannels[2]);
+        break;
+    case Qt::Key_O:
+        setRealTimeStyle(m_realTimeStyle == POINT_CLOUD_STYLE ? TRAJECTORY_STYLE : POINT_CLOUD_STYLE);
+        break;
+    case Qt::Key_X:
+        setVoxelDownsampling(!m_voxelDownsampling, m_voxelGrid.getResolution(), m_voxelGrid.getMode());
+        break;
+    case Qt::Key_S:
+        setStatisticsOverlay(!m_statisticsOverlay, m_statisticsWindow);
+        break;
+    case Qt::Key_B:
+        setStatisticsBands(!m_statisticsBands);
+        break;
+    case Qt::Key_E:
+        setEventMarkers(!m_eventMarkers, m_eventSettings);
+        break;
+    case Qt::Key_C:
+        if (m_dataReceiver)
+        {
+            setClockCorrectionEnabled(!m_dataReceiver->isClockCorrectionEnabled());
+        }
+        break;
+    case Qt::Key_D:
+        dumpTrace();
+        break;
+    case Qt::Key_F:
+        setPerformanceHud(!m_performanceHud);
+        break;
+    case Qt::Key_W:
+        if (m_capturing)
+        {
+            stopCapture();
+        }
+        else
+        {
+            startCapture(QDir::current().filePath(
+                QString("capture_%1.y4m").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"))));
+        }
+        break;
+    default:
+        QOpenGLWidget::keyPressEvent(event);
+        break;
+    }
+}
+
+void PlotView::keyReleaseEvent(QKeyEvent *event)
+{
+    QOpenGLWidget::keyReleaseEvent(event);
+}
+
+void PlotView::renderInteractionMode(QPainter &painter)
+{
+    painter.setPen(QPen(Qt::yellow, 1));
+    painter.setFont(QFont("Arial", 12, QFont::Bold));
+
+    QString modeText;
+    switch (m_interactionMode)
+    {
+    case ROTATE_MODE:
+        modeText = "ROTATE (R) - Drag to rotate view";
+        break;
+    case ZOOM_MODE:
+        modeText = "ZOOM (Z) - Drag up/down to zoom";
+        break;
+    case PAN_MODE:
+        modeText = "PAN (P) - Drag to pan view";
+        break;
+    }
+
+    // Add projection mode info to the mode text
+    QString projectionInfo = QString(" | %1 | FOV: %2°")
+                                 .arg(m_projectionMode == PERSPECTIVE_PROJECTION ? "Perspective" : "Orthographic")
+                                 .arg(QString::number(m_fov, 'f', 1));
+    modeText += projectionInfo;
+
+    // Draw mode indicator in top-left corner
+    QRect textRect = painter.fontMetrics().boundingRect(modeText);
+    painter.fillRect(5, 5, textRect.width() + 10, textRect.height() + 6,
+                     QColor(0, 0, 0, 128)); // Semi-transparent background
+    painter.drawText(10, 20, modeText);
+
+    // Show view angles when in rotate mode with left mouse button pressed
+    if (m_interactionMode == ROTATE_MODE && m_mousePressed)
+    {
+        painter.setPen(QPen(Qt::white, 1));
+        painter.setFont(QFont("Arial", 12, QFont::Bold));
+
+        QString angleText = QString("(%1°, %2°)")
+                                .arg(QString::number(m_viewAngles.getAzimuth() * 180.0 / M_PI, 'f', 1))
+                                .arg(QString::number(m_viewAngles.getElevation() * 180.0 / M_PI, 'f', 1));
+
+        QRect angleRect = painter.fontMetrics().boundingRect(angleText);
+        int angleX = width() - angleRect.width() - 15;
+        int angleY = height() - 30;
+
+        // Semi-transparent background for better readability
+        painter.fillRect(angleX - 5, angleY - angleRect.height() - 5, angleRect.width() + 10, angleRect.height() + 6,
+                         QColor(0, 0, 0, 128));
+        painter.drawText(angleX, angleY - 5, angleText);
+    }
+    else
+    {
+        // Show keyboard shortcuts in bottom-left corner when not showing view angles
+        painter.setPen(QPen(Qt::lightGray, 1));
+        painter.setFont(QFont("Arial", 9));
+
+        QStringList shortcuts = {
+            "R - Rotate mode",
+            "Z - Zoom mode",
+            "P - Pan mode",
+            "V - Toggle projection",
+            "N/M - FOV (perspective)",
+            "C - Toggle clock correction",
+            "T - Trigger off/normal/single",
+            "L - Layout time/XY/XYZ/histogram, O - Points/lines",
+            "X - Voxel downsampling (XYZ)",
+            "S - Statistics, B - Statistics bands",
+            "E - Peak/crossing markers",
+            "Hover/click - Show/pin nearest sample",
+            "D - Dump trace (Chrome/Perfetto JSON)",
+            "F - Performance HUD",
+            "W - Record video (Y4M)",
+            "ESC - Reset to rotate"};
+
+        int y = height() - 250;
+        for (const QString &shortcut : shortcuts)
+        {
+            painter.drawText(10, y, shortcut);
+            y += 15;
+        }
+    }
+}
+
+quint64 PlotView::getReceivedSampleCount() const
+{
+    return m_dataReceiver ? m_dataReceiver->getReceivedCount() : 0;
+}
+
+int PlotView::getReceiveQueueDepth() const
+{
+    return m_dataReceiver ? m_dataReceiver->getQueueDepth() : 0;
+}
+
+void PlotView::setPerformanceHud(bool enabled)
+{
+    m_performanceHud = enabled;
+    m_frameStats.reset();
+    m_hudLines.clear();
+    update();
+}
+
+void PlotView::renderPerformanceHud(QPainter &painter)
+{
+    if (!m_performanceHud)
+    {
+        return;
+    }
+
+    // Rebuild the text four times per second, reusing it in between
+    const qint64 now = m_frameClock.nsecsElapsed();
+    const qint64 sinceRefresh = now - m_hudRefreshTime;
+    if (m_hudLines.isEmpty() || sinceRefresh >= 250000000)
+    {
+        const FrameStats::Summary summary = m_frameStats.summarize();
+
+        double ingestRate = 0.0;
+        int queueDepth = 0;
+        if (m_dataReceiver)
+        {
+            const quint64 received = m_dataReceiver->getReceivedCount();
+            if (!m_hudLines.isEmpty() && sinceRefresh > 0 && received >= m_hudReceivedCount)
+            {
+                ingestRate = (received - m_hudReceivedCount) * 1e9 / sinceRefresh;
+            }
+            m_hudReceivedCount = received;
+            queueDepth = m_dataReceiver->getQueueDepth();
+        }
+        m_hudRefreshTime = now;
+
+        QString gpuLine;
+        if (summary.gpuValid)
+        {
+            gpuLine = QString("GPU %1 ms").arg(summary.gpuMs, 0, 'f', 2);
+        }
+        else
+        {
+            gpuLine = m_gpuTimersSupported ? "GPU waiting..." : "GPU n/a (no timer queries)";
+        }
+
+        m_hudLines.clear();
+        m_hudLines << QString("Frame %1 ms (max %2, %3 fps)")
+                          .arg(summary.frameMs, 0, 'f', 2)
+                          .arg(summary.frameMsMax, 0, 'f', 1)
+                          .arg(summary.frameMs > 0.0 ? 1000.0 / summary.frameMs : 0.0, 0, 'f', 0)
+                   << QString("CPU update %1 | scene %2 | overlay %3 ms")
+                          .arg(summary.stageMs[FrameStats::DATA_UPDATE_STAGE], 0, 'f', 2)
+                          .arg(summary.stageMs[FrameStats::SCENE_STAGE], 0, 'f', 2)
+                          .arg(summary.stageMs[FrameStats::OVERLAY_STAGE], 0, 'f', 2)
+                   << gpuLine
+                   << QString("Upload %1 KB, %2 vertices per frame")
+                          .arg(summary.uploadBytes / 1024.0, 0, 'f', 1)
+                          .arg(summary.vertices, 0, 'f', 0)
+                   << QString("Ingest %1 samples/s, queue %2")
+                          .arg(ingestRate, 0, 'f', 0)
+                          .arg(queueDepth);
+        if (m_capturing)
+        {
+            m_hudLines << QString("Capture %1 ms, %2 written, %3 dropped")
+                              .arg(summary.stageMs[FrameStats::CAPTURE_STAGE], 0, 'f', 2)
+                              .arg(m_frameWriter.getWrittenCount())
+                              .arg(m_frameWriter.getDroppedCount());
+        }
+    }
+
+    painter.setFont(QFont("Courier", 9));
+
+    // Draw in the bottom-right corner, above the view angles
+    int textWidth = 0;
+    for (const QString &line : m_hudLines)
+    {
+        textWidth = qMax(textWidth, painter.fontMetrics().horizontalAdvance(line));
+    }
+    const int lineHeight = painter.fontMetrics().height();
+    const int x = width() - textWidth - 15;
+    int y = height() - 50 - lineHeight * (m_hudLines.size() - 1);
+
+    painter.fillRect(x - 5, y - lineHeight, textWidth + 10, lineHeight * m_hudLines.size() + 6,
+                     QColor(0, 0, 0, 128)); // Semi-transparent background
+    painter.setPen(QPen(Qt::green, 1));
+    for (const QString &line : m_hudLines)
+    {
+        painter.drawText(x, y, line);
+        y += lineHeight;
+    }
+}
+
+void PlotView::beginGpuTimer()
+{
+#if !QT_CONFIG(opengles2)
+    if (!m_performanceHud || !m_gpuTimersSupported)
+    {
+        return;
+    }
+
+    if (!m_gpuTimers[0])
+    {
+        // Needs OpenGL 3.3 or ARB_timer_query
+        for (int i = 0; i < GPU_TIMER_COUNT; ++i)
+        {
+            m_gpuTimers[i] = new QOpenGLTimerQuery;
+            m_gpuTimerPending[i] = false;
+            if (!m_gpuTimers[i]->create())
+            {
+                m_gpuTimersSupported = false;
+            }
+        }
+        if (!m_gpuTimersSupported)
+        {
+            qDebug() << "GPU timer queries not supported, HUD shows CPU times only";
+            for (QOpenGLTimerQuery *&timer : m_gpuTimers)
+            {
+                delete timer;
+                timer = nullptr;
+            }
+            return;
+        }
+    }
+
+    const int index = m_gpuTimerIndex;
+    if (m_gpuTimerPending[index])
+    {
+        // More than GPU_TIMER_COUNT frames in flight; skip this frame rather than wait
+        if (!m_gpuTimers[index]->isResultAvailable())
+        {
+            return;
+        }
+        m_frameStats.addGpuTime(m_gpuTimers[index]->waitForResult());
+        m_gpuTimerPending[index] = false;
+    }
+
+    m_gpuTimers[index]->begin();
+    m_gpuTimerActive = true;
+#endif
+}
+
+void PlotView::endGpuTimer()
+{
+#if !QT_CONFIG(opengles2)
+    if (!m_gpuTimerActive)
+    {
+        return;
+    }
+
+    m_gpuTimers[m_gpuTimerIndex]->end();
+    m_gpuTimerPending[m_gpuTimerIndex] = true;
+    m_gpuTimerIndex = (m_gpuTimerIndex + 1) % GPU_TIMER_COUNT;
+    m_gpuTimerActive = false;
+#endif
+}
+
+bool PlotView::startCapture(const QString &path, int fps)
+{
+    stopCapture();
+
+    if (!m_shaderProgram || fps <= 0)
+    {
+        qWarning() << "Capture needs an initialized view and a positive frame rate";
+        return false;
+    }
+
+    makeCurrent();
+
+    // Mapping a PBO for reading needs OpenGL 3.0, ARB_map_buffer_range or
+    // OpenGL ES 3.0; multisampled widget framebuffers cannot be read directly
+    QOpenGLContext *glContext = QOpenGLContext::currentContext();
+    const QSurfaceFormat glFormat = glContext->format();
+    const bool pboSupported = glContext->isOpenGLES() ? glFormat.majorVersion() >= 3
+                                                      : glFormat.version() >= qMakePair(3, 0) ||
+                                                            glContext->hasExtension("GL_ARB_map_buffer_range");
+    if (!pboSupported || format().samples() > 1)
+    {
+        qWarning() << "Capture needs mappable pixel buffers and a single-sampled view";
+        doneCurrent();
+        return false;
+    }
+#if !QT_CONFIG(opengles2)
+    m_captureFencesSupported = glContext->isOpenGLES() ? glFormat.majorVersion() >= 3
+                                                       : glFormat.version() >= qMakePair(3, 2) ||
+                                                             glContext->hasExtension("GL_ARB_sync");
+#endif
+
+    // 4:2:0 video needs even sizes, so an odd last row or column is cropped
+    const qreal ratio = devicePixelRatio();
+    const int captureWidth = static_cast<int>(width() * ratio) & ~1;
+    const int captureHeight = static_cast<int>(height() * ratio) & ~1;
+    const bool y4m = path.endsWith(".y4m", Qt::CaseInsensitive);
+    if ((!y4m && !QDir().mkpath(path)) ||
+        !m_frameWriter.open(path.toStdString(), y4m ? FrameWriter::Y4M_FORMAT : FrameWriter::PPM_SEQUENCE_FORMAT,
+                            captureWidth, captureHeight, fps))
+    {
+        qWarning() << "Failed to start capture to" << path << ":" << QString::fromStdString(m_frameWriter.errorString());
+        doneCurrent();
+        return false;
+    }
+
+    for (int i = 0; i < CAPTURE_PBO_COUNT; ++i)
+    {
+        m_capturePbos[i].create();
+        m_capturePbos[i].setUsagePattern(QOpenGLBuffer::StreamRead);
+        m_capturePbos[i].bind();
+        m_capturePbos[i].allocate(static_cast<int>(m_frameWriter.getFrameBytes()));
+        m_capturePbos[i].release();
+        m_capturePending[i] = false;
+    }
+    doneCurrent();
+
+    m_captureIndex = 0;
+    m_capturePeriod = 1000000000LL / fps;
+    m_nextCaptureTime = m_frameClock.nsecsElapsed();
+    m_capturing = true;
+
+    qDebug() << "Capturing" << captureWidth << "x" << captureHeight << "at" << fps << "fps to" << path;
+    update();
+    return true;
+}
+
+void PlotView::stopCapture()
+{
+    if (!m_frameWriter.isOpen())
+    {
+        return;
+    }
+    m_capturing = false;
+
+    // Hand over the frames still in flight, oldest first; mapping waits for them
+    makeCurrent();
+    for (int i = 0; i < CAPTURE_PBO_COUNT; ++i)
+    {
+        const int slot = (m_captureIndex + i) % CAPTURE_PBO_COUNT;
+        if (m_capturePending[slot])
+        {
+            handOverCapture(slot);
+        }
+    }
+    for (QOpenGLBuffer &pbo : m_capturePbos)
+    {
+        pbo.destroy();
+    }
+    doneCurrent();
+
+    m_frameWriter.close();
+    qDebug() << "Capture stopped:" << m_frameWriter.getWrittenCount() << "frames written,"
+             << m_frameWriter.getDroppedCount() << "dropped";
+    if (!m_frameWriter.errorString().empty())
+    {
+        qWarning() << "Capture error:" << QString::fromStdString(m_frameWriter.errorString());
+    }
+}
+
+void PlotView::captureFrame()
+{
+    if (!m_capturing)
+    {
+        return;
+    }
+    TRACE_ZONE("PlotView::captureFrame");
+    const StageTimer stageTimer(m_frameStats, m_frameClock, FrameStats::CAPTURE_STAGE);
+
+    const qreal ratio = devicePixelRatio();
+    if ((static_cast<int>(width() * ratio) & ~1) != m_frameWriter.getWidth() ||
+        (static_cast<int>(height() * ratio) & ~1) != m_frameWriter.getHeight())
+    {
+        // The output has a fixed frame size; finish it outside of painting
+        qWarning() << "View resized, stopping capture";
+        m_capturing = false;
+        QTimer::singleShot(0, this, &PlotView::stopCapture);
+        return;
+    }
+
+    makeCurrent();
+
+    // Hand completed readbacks to the writer, oldest first
+    for (int i = 0; i < CAPTURE_PBO_COUNT; ++i)
+    {
+        const int slot = (m_captureIndex + i) % CAPTURE_PBO_COUNT;
+        if (!m_capturePending[slot])
+        {
+            continue;
+        }
+        if (!captureReadbackReady(slot))
+        {
+            break;
+        }
+        handOverCapture(slot);
+    }
+
+    const qint64 now = m_frameClock.nsecsElapsed();
+    if (now < m_nextCaptureTime)
+    {
+        return;
+    }
+    // Frames are taken at most at the capture rate; after a stall the
+    // schedule restarts instead of catching up
+    m_nextCaptureTime = qMax(m_nextCaptureTime + m_capturePeriod, now);
+
+    const int slot = m_captureIndex;
+    if (m_capturePending[slot])
+    {
+        // Every buffer still in flight
+        m_frameWriter.dropFrame();
+        return;
+    }
+
+    // Starts an asynchronous copy into the PBO; returns at once
+    glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebufferObject());
+    m_capturePbos[slot].bind();
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, m_frameWriter.getWidth(), m_frameWriter.getHeight(), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    m_capturePbos[slot].release();
+#if !QT_CONFIG(opengles2)
+    if (m_captureFencesSupported)
+    {
+        m_captureFences[slot] = QOpenGLContext::currentContext()->extraFunctions()->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+#endif
+    m_capturePending[slot] = true;
+    m_captureIndex = (slot + 1) % CAPTURE_PBO_COUNT;
+}
+
+bool PlotView::captureReadbackReady(int slot)
+{
+#if !QT_CONFIG(opengles2)
+    if (m_captureFences[slot])
+    {
+        const GLenum status =
+            QOpenGLContext::currentContext()->extraFunctions()->glClientWaitSync(m_captureFences[slot], 0, 0);
+        return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+    }
+#endif
+    // Without fences, assume the copy is done once the ring has come round to it
+    return slot == m_captureIndex;
+}
+
+void PlotView::handOverCapture(int slot)
+{
+#if !QT_CONFIG(opengles2)
+    if (m_captureFences[slot])
+    {
+        QOpenGLContext::currentContext()->extraFunctions()->glDeleteSync(m_captureFences[slot]);
+        m_captureFences[slot] = nullptr;
+    }
+#endif
+
+    const int bytes = static_cast<int>(m_frameWriter.getFrameBytes());
+    m_capturePbos[slot].bind();
+    if (const void *pixels = m_capturePbos[slot].mapRange(0, bytes, QOpenGLBuffer::RangeRead))
+    {
+        // A free writer buffer, or the frame is dropped and counted
+        if (uint8_t *buffer = m_frameWriter.acquireBuffer())
+        {
+            std::memcpy(buffer, pixels, bytes);
+            m_frameWriter.submitBuffer(buffer);
+        }
+        m_capturePbos[slot].unmap();
+    }
+    else
+    {
+        m_frameWriter.dropFrame();
+    }
+    m_capturePbos[slot].release();
+    m_capturePending[slot] = false;
+}
+
+void PlotView::renderClockDrift(QPainter &painter)
+{
+    if (m_clockDriftInfo.empty())
+    {
+        return;
+    }
+
+    painter.setFont(QFont("Arial", 9));
+
+    const bool corrected = m_dataReceiver && m_dataReceiver->isClockCorrectionEnabled();
+    QStringList lines;
+    lines << QString("Clock drift (%1)").arg(corrected ? "corrected" : "uncorrected");
+    for (const auto &info : m_clockDriftInfo)
+    {
+        if (info.valid)
+        {
+            lines << QString("ch %1: %2 ppm").arg(info.channel).arg(info.driftPpm, 0, 'f', 1);
+        }
+        else
+        {
+            lines << QString("ch %1: estimating...").arg(info.channel);
+        }
+    }
+
+    // Draw in the top-right corner
+    int textWidth = 0;
+    for (const QString &line : lines)
+    {
+        textWidth = qMax(textWidth, painter.fontMetrics().horizontalAdvance(line));
+    }
+    const int lineHeight = painter.fontMetrics().height();
+    const int x = width() - textWidth - 15;
+    int y = 35;
+
+    painter.fillRect(x - 5, y - lineHeight, textWidth + 10, lineHeight * lines.size() + 6,
+                     QColor(0, 0, 0, 128)); // Semi-transparent background
+    painter.setPen(QPen(Qt::white, 1));
+    for (const QString &line : lines)
+    {
+        painter.drawText(x, y, line);
+        y += lineHeight;
+    }
+}
+
+void PlotView::renderTriggerStatus(QPainter &painter)
+{
+    if (!m_triggerDisplay || !m_dataReceiver)
+    {
+        return;
+    }
+
+    QString stateText;
+    switch (m_dataReceiver->getTriggerState())
+    {
+    case TriggerEngine::IDLE:
+        stateText = "idle";
+        break;
+    case TriggerEngine::ARMED:
+        stateText = "armed";
+        break;
+    case TriggerEngine::CAPTURING:
+        stateText = "capturing";
+        break;
+    case TriggerEngine::STOPPED:
+        stateText = "stopped";
+        break;
+    }
+
+    QString typeText;
+    switch (m_triggerSettings.type)
+    {
+    case TriggerEngine::RISING_EDGE:
+        typeText = "rising";
+        break;
+    case TriggerEngine::FALLING_EDGE:
+        typeText = "falling";
+        break;
+    case TriggerEngine::LEVEL:
+        typeText = "level";
+        break;
+    }
+
+    const QString text = QString("TRIGGER %1 (%2) - ch %3 %4 @ %5")
+                             .arg(m_triggerSettings.mode == TriggerEngine::NORMAL_MODE ? "NORMAL" : "SINGLE")
+                             .arg(stateText)
+                             .arg(m_triggerSettings.channel)
+                             .arg(typeText)
+                             .arg(m_triggerSettings.level, 0, 'f', 2);
+
+    painter.setFont(QFont("Arial", 10, QFont::Bold));
+    QRect textRect = painter.fontMetrics().boundingRect(text);
+    painter.fillRect(5, 30, textRect.width() + 10, textRect.height() + 6,
+                     QColor(0, 0, 0, 128)); // Semi-transparent background
+    painter.setPen(QPen(Qt::yellow, 1));
+    painter.drawText(10, 30 + textRect.height(), text);
+}
+
+void PlotView::renderStatistics(QPainter &painter)
+{
+    if (!m_statisticsOverlay || m_channelStatistics.empty())
+    {
+        return;
+    }
+
+    painter.setFont(QFont("Courier", 9));
+
+    QStringList lines;
+    lines << QString("Statistics over %1 s").arg(m_statisticsWindow, 0, 'g', 3);
+    for (const auto &stats : m_channelStatistics)
+    {
+        const RollingStats::Summary &summary = stats.summary;
+        QString line = QString("ch %1: n=%2 mean=%3 std=%4 min=%5 max=%6")
+                           .arg(stats.channel)
+                           .arg(summary.count)
+                           .arg(summary.mean, 0, 'g', 5)
+                           .arg(summary.stddev, 0, 'g', 4)
+                           .arg(summary.min, 0, 'g', 5)
+                           .arg(summary.max, 0, 'g', 5);
+        for (size_t i = 0; i < summary.quantiles.size() && i < summary.quantileLevels.size(); ++i)
+        {
+            line += QString(" p%1=%2").arg(summary.quantileLevels[i] * 100.0, 0, 'g', 3).arg(summary.quantiles[i], 0, 'g', 5);
+        }
+        lines << line;
+    }
+
+    // Draw below the trigger status in the top-left corner
+    int textWidth = 0;
+    for (const QString &line : lines)
+    {
+        textWidth = qMax(textWidth, painter.fontMetrics().horizontalAdvance(line));
+    }
+    const int lineHeight = painter.fontMetrics().height();
+    int y = 70;
+
+    painter.fillRect(5, y - lineHeight, textWidth + 10, lineHeight * lines.size() + 6,
+                     QColor(0, 0, 0, 128)); // Semi-transparent background
+    painter.setPen(QPen(Qt::white, 1));
+    for (const QString &line : lines)
+    {
+        painter.drawText(10, y, line);
+        y += lineHeight;
+    }
+}
+
+void PlotView::addStatisticsBands(float maxAge)
+{
+    // Shaded mean +/- stddev, lines at min, mean and max. Bands sit just
+    // behind the channel's series so the series stays on top.
+    PlotData bands;
+    bands.drawMode = GL_TRIANGLES;
+    PlotData lines;
+    lines.drawMode = GL_LINES;
+    lines.lineWidth = 1.0f;
+
+    for (const auto &stats : m_channelStatistics)
+    {
+        const RollingStats::Summary &summary = stats.summary;
+        if (summary.count == 0)
+        {
+            continue;
+        }
+
+        const float z = static_cast<float>(stats.channel) - 0.02f;
+        const float mean = static_cast<float>(summary.mean);
+        const float low = static_cast<float>(summary.mean - summary.stddev);
+        const float high = static_cast<float>(summary.mean + summary.stddev);
+
+        bands.vertices.insert(bands.vertices.end(), {0.0f, low, z, 0.80f, 0.88f, 1.0f,
+                                                     maxAge, low, z, 0.80f, 0.88f, 1.0f,
+                                                     maxAge, high, z, 0.80f, 0.88f, 1.0f,
+                                                     0.0f, low, z, 0.80f, 0.88f, 1.0f,
+                                                     maxAge, high, z, 0.80f, 0.88f, 1.0f,
+                                                     0.0f, high, z, 0.80f, 0.88f, 1.0f});
+
+        lines.vertices.insert(lines.vertices.end(), {0.0f, summary.min, z, 0.6f, 0.6f, 0.6f,
+                                                     maxAge, summary.min, z, 0.6f, 0.6f, 0.6f,
+                                                     0.0f, mean, z, 0.2f, 0.3f, 0.6f,
+                                                     maxAge, mean, z, 0.2f, 0.3f, 0.6f,
+                                                     0.0f, summary.max, z, 0.6f, 0.6f, 0.6f,
+                                                     maxAge, summary.max, z, 0.6f, 0.6f, 0.6f});
+    }
+
+    if (!bands.vertices.empty())
+    {
+        addPlotData(bands);
+        addPlotData(lines);
+    }
+}
+
+// Real-time data methods
+void PlotView::startDataReceiver(quint16 port, DataReceiver::InputFormat format)
+{
+    if (m_dataReceiver)
+    {
+        stopDataReceiver();
+    }
+
+    createDataReceiver();
+    m_dataReceiver->setInputFormat(format);
+    m_dataThread = new QThread(this);
+    m_dataReceiver->moveToThread(m_dataThread);
+    connect(m_dataThread, &QThread::started, m_dataReceiver, &DataReceiver::startReceiving);
+
+    // Start server
+    m_dataReceiver->startServer(port);
+    m_dataThread->start();
+
+    qDebug() << "Started data receiver on port" << port;
+}
+
+void PlotView::replayData(const QByteArray &data, double arrivalTime)
+{
+    if (m_dataThread)
+    {
+        stopDataReceiver();
+    }
+    if (!m_dataReceiver)
+    {
+        // Stays on this thread and is fed directly, without a socket
+        createDataReceiver();
+        setRealTimeMode(true);
+    }
+
+    m_dataReceiver->feedData(data, arrivalTime);
+    onNewDataReceived();
+}
+
+void PlotView::createDataReceiver()
+{
+    m_dataReceiver = new DataReceiver();
+
+    // Connect signals
+    connect(m_dataReceiver, &DataReceiver::newDataAvailable, this, &PlotView::onNewDataReceived);
+    connect(m_dataReceiver, &DataReceiver::connectionStatusChanged, this, &PlotView::onDataReceiverConnected);
+    connect(m_dataReceiver, &DataReceiver::errorOccurred, this, &PlotView::onDataReceiverError);
+    connect(m_dataReceiver, &DataReceiver::triggerCaptured, this, &PlotView::onTriggerCaptured);
+
+    m_dataReceiver->setTriggerSettings(m_triggerSettings);
+    m_dataReceiver->setStatisticsWindow(m_statisticsWindow);
+    m_dataReceiver->setStatisticsEnabled(m_statisticsOverlay);
+    m_dataReceiver->setEventDetection(m_eventMarkers, m_eventSettings);
+    applyRealTimeLayout();
+}
+
+void PlotView::stopDataReceiver()
+{
+    if (m_dataThread && m_dataReceiver)
+    {
+        m_dataReceiver->stopReceiving();
+        m_dataThread->quit();
+        m_dataThread->wait(3000);
+
+        delete m_dataReceiver;
+        delete m_dataThread;
+        m_dataReceiver = nullptr;
+        m_dataThread = nullptr;
+
+        qDebug() << "Stopped data receiver";
+    }
+    else if (m_dataReceiver)
+    {
+        // Replay receiver, never moved to a thread
+        delete m_dataReceiver;
+        m_dataReceiver = nullptr;
+    }
+}
+
+void PlotView::connectToDataSource(const QString &host, quint16 port)
+{
+    if (m_dataReceiver)
+    {
+        m_dataReceiver->connectToHost(host, port);
+        qDebug() << "Connecting to data source at" << host << ":" << port;
+    }
+}
+
+void PlotView::setRealTimeMode(bool enabled)
+{
+    m_realTimeMode = enabled;
+    if (!enabled)
+    {
+        m_realTimeBuffer.clear();
+    }
+    qDebug() << "Real-time mode" << (enabled ? "enabled" : "disabled");
+}
+
+void PlotView::setMaxRealTimePoints(int maxPoints)
+{
+    m_maxRealTimePoints = maxPoints;
+
+    // Trim buffer if necessary
+    if (m_realTimeBuffer.size() > static_cast<size_t>(m_maxRealTimePoints))
+    {
+        m_realTimeBuffer.erase(m_realTimeBuffer.begin(), m_realTimeBuffer.end() - m_maxRealTimePoints);
+    }
+
+    if (qMax(1, maxPoints) != m_streamCapacity)
+    {
+        resetStream();
+    }
+}
+
+void PlotView::setRealTimeLayout(RealTimeLayout layout, int xChannel, int yChannel, int zChannel)
+{
+    m_realTimeLayout = layout;
+    m_layoutChannels[0] = xChannel;
+    m_layoutChannels[1] = yChannel;
+    m_layoutChannels[2] = zChannel;
+
+    clearData();
+    m_realTimeBuffer.clear();
+    m_histogram = ConcurrentHistogram::Snapshot();
+    m_histogramDirty = true;
+    resetStream();
+    applyRealTimeLayout();
+    update();
+}
+
+PlotView::RealTimeLayout PlotView::getRealTimeLayout() const
+{
+    return m_realTimeLayout;
+}
+
+void PlotView::setRealTimeStyle(RealTimeStyle style)
+{
+    m_realTimeStyle = style;
+    update();
+}
+
+void PlotView::setAlignmentPeriod(double seconds)
+{
+    m_alignmentPeriod = seconds;
+    applyRealTimeLayout();
+}
+
+void PlotView::setVoxelDownsampling(bool enabled, float voxelSize, VoxelGrid::Mode mode)
+{
+    m_voxelDownsampling = enabled;
+    m_voxelGrid.setMode(mode);
+    m_voxelGrid.setResolution(voxelSize);
+    resetStream();
+    update();
+}
+
+void PlotView::applyRealTimeLayout()
+{
+    if (!m_dataReceiver)
+    {
+        return;
+    }
+
+    m_dataReceiver->setHistogramChannel(m_realTimeLayout == HISTOGRAM_LAYOUT ? m_layoutChannels[0] : -1);
+
+    if (m_realTimeLayout == TIME_SERIES_LAYOUT || m_realTimeLayout == HISTOGRAM_LAYOUT)
+    {
+        m_dataReceiver->disableAlignment();
+        return;
+    }
+
+    std::vector<int> channels = {m_layoutChannels[0], m_layoutChannels[1]};
+    if (m_realTimeLayout == XYZ_LAYOUT)
+    {
+        channels.push_back(m_layoutChannels[2]);
+    }
+    m_dataReceiver->setAlignment(channels, m_alignmentPeriod);
+}
+
+void PlotView::resetStream()
+{
+    m_streamCapacity = qMax(1, m_maxRealTimePoints);
+    m_streamVertices.assign((m_streamCapacity + 1) * 6, 0.0f);
+    m_streamHead = 0;
+    m_streamCount = 0;
+    m_streamDirtyFirst = 0;
+    m_streamDirtyCount = 0;
+    m_streamSeamDirty = false;
+    m_streamAllocatedSlots = 0; // Forces reallocation on the next upload
+
+    m_octree.clear();
+    m_octreeDirty = true;
+
+    m_voxelGrid.clear();
+    m_voxelGrid.setMaxVoxels(m_streamCapacity);
+
+    m_streamTimestamps.assign(m_streamCapacity, 0.0);
+    m_hoverPick = PickResult();
+    m_pinnedPick = PickResult();
+}
+
+void PlotView::rebuildOctree()
+{
+    m_octree.clear();
+
+    // Oldest to newest, so reservoir samples favour the same history as the ring
+    const int oldest = m_streamCount < m_streamCapacity ? 0 : m_streamHead;
+    for (int i = 0; i < m_streamCount; ++i)
+    {
+        const int slot = (oldest + i) % m_streamCapacity;
+        const float *vertex = &m_streamVertices[slot * 6];
+        m_octree.insert({vertex[0], vertex[1], vertex[2], static_cast<uint32_t>(slot)});
+    }
+    m_octreeDirty = true;
+}
+
+void PlotView::streamAlignedFrames()
+{
+    const size_t frameCount = m_dataReceiver->takeAlignedData(m_alignedTimestamps, m_alignedValues);
+    const size_t channelCount = m_realTimeLayout == XYZ_LAYOUT ? 3 : 2;
+    if (m_alignedValues.size() < frameCount * channelCount)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < frameCount; ++i)
+    {
+        const float *frame = &m_alignedValues[i * channelCount];
+        const float x = frame[0];
+        const float y = frame[1];
+        const float z = channelCount > 2 ? frame[2] : 0.0f;
+
+        // Skip frames where a channel has not started yet
+        if (std::isnan(x) || std::isnan(y) || std::isnan(z))
+        {
+            continue;
+        }
+
+        if (m_voxelDownsampling && m_realTimeLayout == XYZ_LAYOUT)
+        {
+            appendVoxelPoint(m_alignedTimestamps[i], x, y, z);
+        }
+        else
+        {
+            appendStreamPoint(m_alignedTimestamps[i], x, y, z);
+        }
+    }
+}
+
+void PlotView::writeStreamVertex(int slot, float x, float y, float z)
+{
+    float *vertex = &m_streamVertices[slot * 6];
+    vertex[0] = x;
+    vertex[1] = y;
+    vertex[2] = z;
+    vertex[3] = 0.1f; // Blue points / trajectory
+    vertex[4] = 0.4f;
+    vertex[5] = 0.9f;
+
+    if (slot == 0)
+    {
+        // Keep the extra slot in sync with slot 0
+        std::copy(vertex, vertex + 6, &m_streamVertices[m_streamCapacity * 6]);
+        m_streamSeamDirty = true;
+    }
+}
+
+void PlotView::appendVoxelPoint(double timestamp, float x, float y, float z)
+{
+    bool created = false;
+    const size_t index = m_voxelGrid.insert(x, y, z, created);
+    if (index == VoxelGrid::npos)
+    {
+        return; // Voxel limit reached
+    }
+
+    // Only a new voxel or a moved mean touches the GPU buffer
+    if (!created && m_voxelGrid.getMode() == VoxelGrid::FIRST_POINT)
+    {
+        return;
+    }
+
+    const int slot = static_cast<int>(index);
+    const float *position = m_voxelGrid.getPosition(index);
+    writeStreamVertex(slot, position[0], position[1], position[2]);
+    m_streamTimestamps[slot] = timestamp; // Latest sample that updated the voxel
+
+    // Grow the contiguous dirty range to cover the slot
+    if (m_streamDirtyCount == 0)
+    {
+        m_streamDirtyFirst = slot;
+        m_streamDirtyCount = 1;
+    }
+    else
+    {
+        const int dirtyEnd = qMax(m_streamDirtyFirst + m_streamDirtyCount, slot + 1);
+        m_streamDirtyFirst = qMin(m_streamDirtyFirst, slot);
+        m_streamDirtyCount = dirtyEnd - m_streamDirtyFirst;
+    }
+
+    if (created)
+    {
+        m_streamCount = static_cast<int>(m_voxelGrid.size());
+        m_streamHead = m_streamCount % m_streamCapacity;
+        m_octree.insert({position[0], position[1], position[2], static_cast<uint32_t>(slot)});
+        m_octreeDirty = true;
+    }
+}
+
+void PlotView::appendStreamPoint(double timestamp, float x, float y, float z)
+{
+    const int slot = m_streamHead;
+    writeStreamVertex(slot, x, y, z);
+    m_streamTimestamps[slot] = timestamp;
+
+    if (m_streamDirtyCount == 0)
+    {
+        m_streamDirtyFirst = m_streamHead;
+    }
+    m_streamDirtyCount = qMin(m_streamDirtyCount + 1, m_streamCapacity);
+
+    m_streamHead = (m_streamHead + 1) % m_streamCapacity;
+    m_streamCount = qMin(m_streamCount + 1, m_streamCapacity);
+
+    // XY points are indexed too (z = 0) so picking works in both layouts
+    m_octree.insert({x, y, z, static_cast<uint32_t>(slot)});
+    if (m_octree.size() >= static_cast<size_t>(m_streamCapacity) + m_streamCapacity / 4 + 1)
+    {
+        rebuildOctree();
+    }
+    m_octreeDirty = true;
+}
+
+void PlotView::setClockCorrectionEnabled(bool enabled)
+{
+    if (m_dataReceiver && m_dataReceiver->isClockCorrectionEnabled() != enabled)
+    {
+        // Old and corrected timestamps do not mix: the receiver restarts
+        // alignment, trigger, statistics and event detection, and every
+        // view of past samples starts over here
+        m_dataReceiver->setClockCorrectionEnabled(enabled);
+        m_realTimeBuffer.clear();
+        m_triggerFrame.clear();
+        m_triggerTime = 0.0;
+        m_channelStatistics.clear();
+        m_eventIndex.clear();
+        resetStream();
+        update();
+    }
+}
+
+void PlotView::setStatisticsOverlay(bool enabled, double windowSeconds)
+{
+    m_statisticsOverlay = enabled;
+    m_statisticsWindow = windowSeconds;
+    if (!enabled)
+    {
+        m_channelStatistics.clear();
+    }
+    if (m_dataReceiver)
+    {
+        m_dataReceiver->setStatisticsWindow(windowSeconds);
+        m_dataReceiver->setStatisticsEnabled(enabled);
+    }
+    update();
+}
+
+void PlotView::setStatisticsBands(bool enabled)
+{
+    m_statisticsBands = enabled;
+    update();
+}
+
+void PlotView::setEventMarkers(bool enabled, const EventDetector::Settings &settings)
+{
+    m_eventMarkers = enabled;
+    m_eventSettings = settings;
+    m_eventIndex.clear();
+    if (m_dataReceiver)
+    {
+        m_dataReceiver->setEventDetection(enabled, settings);
+    }
+    update();
+}
+
+void PlotView::setTriggerSettings(const TriggerEngine::Settings &settings)
+{
+    m_triggerSettings = settings;
+    if (m_dataReceiver)
+    {
+        m_dataReceiver->setTriggerSettings(settings);
     }
 }
 
-void PlotView::keyPressEvent(QKeyEvent *event)
+void PlotView::armTrigger()
 {
-    switch (event->key())
+    if (m_dataReceiver)
     {
-    case Qt::Key_Z:
-        m_interactionMode = ZOOM_MODE;
-        setCursor(Qt::SizeVerCursor);
-        update();
-        break;
-    case Qt::Key_P:
-        m_interactionMode = PAN_MODE;
-        setCursor(Qt::OpenHandCursor);
-        update();
-        break;
-    case Qt::Key_R:
-    case Qt::Key_Escape:
-        m_interactionMode = ROTATE_MODE;
-        setCursor(Qt::ArrowCursor);
+        m_dataReceiver->armTrigger();
+        m_triggerDisplay = true;
         update();
-        break;
-    case Qt::Key_V:
-        toggleProjectionMode();
-        break;
-    case Qt::Key_N:
-        decreaseFOV();
-        break;
-    case Qt::Key_M:
-        increaseFOV();
-        break;
-    default:
-        QOpenGLWidget::keyPressEvent(event);
-        break;
     }
 }
 
-void PlotView::keyReleaseEvent(QKeyEvent *event)
+void PlotView::disableTrigger()
 {
-    QOpenGLWidget::keyReleaseEvent(event);
+    if (m_dataReceiver)
+    {
+        m_dataReceiver->disarmTrigger();
+    }
+    m_triggerDisplay = false;
+    m_triggerFrame.clear();
+    update();
 }
 
-void PlotView::renderInteractionMode(QPainter &painter)
+bool PlotView::isReceivingData() const
 {
-    painter.setPen(QPen(Qt::yellow, 1));
-    painter.setFont(QFont("Arial", 12, QFont::Bold));
+    return m_dataReceiver && m_dataReceiver->isConnected();
+}
 
-    QString modeText;
-    switch (m_interactionMode)
+void PlotView::onNewDataReceived()
+{
+    TRACE_ZONE("PlotView::onNewDataReceived");
+    const StageTimer stageTimer(m_frameStats, m_frameClock, FrameStats::DATA_UPDATE_STAGE);
+
+    if (!m_realTimeMode || !m_dataReceiver)
     {
-    case ROTATE_MODE:
-        modeText = "ROTATE (R) - Drag to rotate view";
-        break;
-    case ZOOM_MODE:
-        modeText = "ZOOM (Z) - Drag up/down to zoom";
-        break;
-    case PAN_MODE:
-        modeText = "PAN (P) - Drag to pan view";
-        break;
+        return;
     }
 
-    // Add projection mode info to the mode text
-    QString projectionInfo = QString(" | %1 | FOV: %2°")
-                                 .arg(m_projectionMode == PERSPECTIVE_PROJECTION ? "Perspective" : "Orthographic")
-                                 .arg(QString::number(m_fov, 'f', 1));
-    modeText += projectionInfo;
+    m_dataReceiver->getClockDriftInfo(m_clockDriftInfo);
+    if (m_statisticsOverlay)
+    {
+        m_channelStatistics = m_dataReceiver->getChannelStatistics();
+    }
+    if (m_eventMarkers)
+    {
+        m_newEvents.clear();
+        m_dataReceiver->takeEvents(m_newEvents);
+        for (const auto &event : m_newEvents)
+        {
+            m_eventIndex.insert(event);
+        }
+    }
 
-    // Draw mode indicator in top-left corner
-    QRect textRect = painter.fontMetrics().boundingRect(modeText);
-    painter.fillRect(5, 5, textRect.width() + 10, textRect.height() + 6,
-                     QColor(0, 0, 0, 128)); // Semi-transparent background
-    painter.drawText(10, 20, modeText);
+    // The histogram is counted on the receiver thread; only merge it here
+    if (m_realTimeLayout == HISTOGRAM_LAYOUT)
+    {
+        m_dataReceiver->getHistogram(m_histogram);
+        m_histogramDirty = true;
+        m_dataReceiver->discardLatestData(); // Raw samples are not shown here
+        update();
+        return;
+    }
 
-    // Show view angles when in rotate mode with left mouse button pressed
-    if (m_interactionMode == ROTATE_MODE && m_mousePressed)
+    // Channel-mapped layouts stream aligned frames straight into the GPU buffer
+    if (m_realTimeLayout != TIME_SERIES_LAYOUT)
     {
-        painter.setPen(QPen(Qt::white, 1));
-        painter.setFont(QFont("Arial", 12, QFont::Bold));
+        streamAlignedFrames();
+        m_dataReceiver->discardLatestData(); // Raw samples are not shown here
+        if (m_hoverPick.valid)
+        {
+            m_hoverPick = pickNearest(m_lastMousePos);
+        }
+        update();
+        return;
+    }
 
-        QString angleText = QString("(%1°, %2°)")
-                                .arg(QString::number(m_viewAngles.getAzimuth() * 180.0 / M_PI, 'f', 1))
-                                .arg(QString::number(m_viewAngles.getElevation() * 180.0 / M_PI, 'f', 1));
+    // Append the latest data to the real-time buffer
+    m_dataReceiver->takeLatestData(m_realTimeBuffer);
 
-        QRect angleRect = painter.fontMetrics().boundingRect(angleText);
-        int angleX = width() - angleRect.width() - 15;
-        int angleY = height() - 30;
+    // Limit buffer size, dropping the oldest points in one move
+    if (m_realTimeBuffer.size() > static_cast<size_t>(m_maxRealTimePoints))
+    {
+        m_realTimeBuffer.erase(m_realTimeBuffer.begin(), m_realTimeBuffer.end() - m_maxRealTimePoints);
+    }
 
-        // Semi-transparent background for better readability
-        painter.fillRect(angleX - 5, angleY - angleRect.height() - 5, angleRect.width() + 10, angleRect.height() + 6,
-                         QColor(0, 0, 0, 128));
-        painter.drawText(angleX, angleY - 5, angleText);
+    // Update visualization
+    if (m_triggerDisplay && !m_triggerFrame.empty())
+    {
+        // Keep showing the frozen capture while ingest continues
+        showTriggerCapture();
     }
-    else
+    else if (!m_realTimeBuffer.empty())
     {
-        // Show keyboard shortcuts in bottom-left corner when not showing view angles
-        painter.setPen(QPen(Qt::lightGray, 1));
-        painter.setFont(QFont("Arial", 9));
+        // Convert to plot format with newest data at x=0, reusing the
+        // scratch columns and vertex storage of the previous update
+        m_seriesX.clear();
+        m_seriesY.clear();
+        m_seriesZ.clear();
 
-        QStringList shortcuts = {
-            "R - Rotate mode",
-            "Z - Zoom mode",
-            "P - Pan mode",
-            "V - Toggle projection",
-            "N/M - FOV (perspective)",
-            "ESC - Reset to rotate"};
+        // Get the timestamp of the most recent data point
+        double latestTimestamp = m_realTimeBuffer.back().timestamp;
 
-        int y = height() - 100;
-        for (const QString &shortcut : shortcuts)
+        for (const auto &point : m_realTimeBuffer)
         {
-            painter.drawText(10, y, shortcut);
-            y += 15;
+            // Calculate age of each point relative to the latest data
+            float age = static_cast<float>(latestTimestamp - point.timestamp);
+            m_seriesX.push_back(age); // Age 0 = newest data at x=0, older data at positive x
+            m_seriesY.push_back(point.value);
+            m_seriesZ.push_back(static_cast<float>(point.channel)); // Use channel as Z
+        }
+
+        // Replace existing data with the real-time series
+        setSingleDataSeries(m_seriesX, m_seriesY, m_seriesZ, 2.0f); // Thicker line for real-time data
+        updatePickIndex(m_realTimeBuffer);
+
+        if (m_statisticsOverlay && m_statisticsBands)
+        {
+            const double span = latestTimestamp - m_realTimeBuffer.front().timestamp;
+            addStatisticsBands(static_cast<float>(qMin(span, m_statisticsWindow)));
         }
     }
+
+    // The data moved under a resting cursor
+    if (m_hoverPick.valid)
+    {
+        m_hoverPick = pickNearest(m_lastMousePos);
+    }
 }
 
-// Real-time data methods
-void PlotView::startDataReceiver(quint16 port)
+void PlotView::onTriggerCaptured()
 {
-    if (m_dataReceiver)
+    if (!m_dataReceiver || !m_triggerDisplay)
     {
-        stopDataReceiver();
+        return;
     }
 
-    m_dataThread = new QThread(this);
-    m_dataReceiver = new DataReceiver();
-    m_dataReceiver->moveToThread(m_dataThread);
+    if (m_dataReceiver->takeTriggerCapture(m_triggerFrame, m_triggerTime))
+    {
+        showTriggerCapture();
+    }
+}
 
-    // Connect signals
-    connect(m_dataThread, &QThread::started, m_dataReceiver, &DataReceiver::startReceiving);
-    connect(m_dataReceiver, &DataReceiver::newDataAvailable, this, &PlotView::onNewDataReceived);
-    connect(m_dataReceiver, &DataReceiver::connectionStatusChanged, this, &PlotView::onDataReceiverConnected);
-    connect(m_dataReceiver, &DataReceiver::errorOccurred, this, &PlotView::onDataReceiverError);
+void PlotView::showTriggerCapture()
+{
+    // Time relative to the trigger point, so the trigger sits at x=0
+    m_seriesX.clear();
+    m_seriesY.clear();
+    m_seriesZ.clear();
 
-    // Start server
-    m_dataReceiver->startServer(port);
-    m_dataThread->start();
+    for (const auto &point : m_triggerFrame)
+    {
+        m_seriesX.push_back(static_cast<float>(point.timestamp - m_triggerTime));
+        m_seriesY.push_back(point.value);
+        m_seriesZ.push_back(static_cast<float>(point.channel));
+    }
 
-    qDebug() << "Started data receiver on port" << port;
+    setSingleDataSeries(m_seriesX, m_seriesY, m_seriesZ, 2.0f);
+    updatePickIndex(m_triggerFrame);
 }
 
-void PlotView::stopDataReceiver()
+PlotView::PickResult PlotView::pickNearest(const QPoint &pos)
 {
-    if (m_dataThread && m_dataReceiver)
+    PickResult result;
+    if (!m_realTimeMode || width() <= 0 || height() <= 0)
     {
-        m_dataReceiver->stopReceiving();
-        m_dataThread->quit();
-        m_dataThread->wait(3000);
-
-        delete m_dataReceiver;
-        delete m_dataThread;
-        m_dataReceiver = nullptr;
-        m_dataThread = nullptr;
+        return result;
+    }
 
-        qDebug() << "Stopped data receiver";
+    const QMatrix4x4 mvp = getProjectionMatrix() * getViewMatrix();
+    if (m_realTimeLayout == TIME_SERIES_LAYOUT)
+    {
+        pickTimeSeries(mvp, pos, result);
     }
+    else if (m_realTimeLayout != HISTOGRAM_LAYOUT)
+    {
+        pickStream(mvp, pos, result);
+    }
+    return result;
 }
 
-void PlotView::connectToDataSource(const QString &host, quint16 port)
+PlotView::PickResult PlotView::getPinnedPick() const
 {
-    if (m_dataReceiver)
+    return m_pinnedPick;
+}
+
+void PlotView::updatePickIndex(const std::vector<DataPoint> &series)
+{
+    m_pickSeriesSorted = std::is_sorted(series.begin(), series.end(),
+                                        [](const DataPoint &a, const DataPoint &b) { return a.timestamp < b.timestamp; });
+
+    m_pickMinChannel = 0;
+    m_pickMaxChannel = 0;
+    if (!series.empty())
     {
-        m_dataReceiver->connectToHost(host, port);
-        qDebug() << "Connecting to data source at" << host << ":" << port;
+        const auto range = std::minmax_element(series.begin(), series.end(),
+                                               [](const DataPoint &a, const DataPoint &b) { return a.channel < b.channel; });
+        m_pickMinChannel = range.first->channel;
+        m_pickMaxChannel = range.second->channel;
     }
 }
 
-void PlotView::setRealTimeMode(bool enabled)
+bool PlotView::projectToScreen(const QMatrix4x4 &mvp, const QVector3D &worldPos, QPointF &screenPos) const
 {
-    m_realTimeMode = enabled;
-    if (!enabled)
+    const QVector4D clipPos = mvp * QVector4D(worldPos, 1.0f);
+    if (clipPos.w() <= 1e-6f || std::fabs(clipPos.z()) > clipPos.w())
     {
-        m_realTimeBuffer.clear();
+        return false; // Behind the camera or clipped
     }
-    qDebug() << "Real-time mode" << (enabled ? "enabled" : "disabled");
+
+    screenPos.setX((clipPos.x() / clipPos.w() + 1.0f) * 0.5f * width());
+    screenPos.setY((1.0f - clipPos.y() / clipPos.w()) * 0.5f * height());
+    return true;
 }
 
-void PlotView::setMaxRealTimePoints(int maxPoints)
+bool PlotView::timeSeriesMapping(double &origin, double &direction) const
 {
-    m_maxRealTimePoints = maxPoints;
-
-    // Trim buffer if necessary
-    while (m_realTimeBuffer.size() > m_maxRealTimePoints)
+    // The plotted series is either the frozen trigger capture (x = time since
+    // the trigger) or the live buffer (x = age of the sample)
+    const bool triggerFrame = m_triggerDisplay && !m_triggerFrame.empty();
+    const std::vector<DataPoint> &series = triggerFrame ? m_triggerFrame : m_realTimeBuffer;
+    if (series.empty())
     {
-        m_realTimeBuffer.erase(m_realTimeBuffer.begin());
+        return false;
     }
+    origin = triggerFrame ? m_triggerTime : series.back().timestamp;
+    direction = triggerFrame ? 1.0 : -1.0; // x = direction * (timestamp - origin)
+    return true;
 }
 
-bool PlotView::isReceivingData() const
+bool PlotView::screenRectToTimeRange(const QMatrix4x4 &mvp, const QRectF &rect, double origin, double direction,
+                                     double &first, double &last) const
 {
-    return m_dataReceiver && m_dataReceiver->isConnected();
+    // Intersect the rays through the corners of the rectangle with the
+    // outermost channel planes. The x range they span bounds the time range
+    // that can appear inside the rectangle.
+    bool invertible = false;
+    const QMatrix4x4 inverse = mvp.inverted(&invertible);
+    if (!invertible)
+    {
+        return false;
+    }
+
+    float minX = std::numeric_limits<float>::max();
+    float maxX = std::numeric_limits<float>::lowest();
+    for (const QPointF &corner : {rect.topLeft(), rect.topRight(), rect.bottomLeft(), rect.bottomRight()})
+    {
+        const float ndcX = 2.0f * corner.x() / width() - 1.0f;
+        const float ndcY = 1.0f - 2.0f * corner.y() / height();
+
+        const QVector4D nearPoint = inverse * QVector4D(ndcX, ndcY, -1.0f, 1.0f);
+        const QVector4D farPoint = inverse * QVector4D(ndcX, ndcY, 1.0f, 1.0f);
+        const QVector3D rayStart = nearPoint.toVector3DAffine();
+        const QVector3D rayDirection = farPoint.toVector3DAffine() - rayStart;
+
+        if (std::fabs(rayDirection.z()) < 1e-6f)
+        {
+            return false; // Viewed edge-on, the channel planes do not bound x
+        }
+
+        for (int channel : {m_pickMinChannel, m_pickMaxChannel})
+        {
+            const float t = (channel - rayStart.z()) / rayDirection.z();
+            const float x = rayStart.x() + t * rayDirection.x();
+            minX = qMin(minX, x);
+            maxX = qMax(maxX, x);
+        }
+    }
+
+    const double t0 = origin + direction * minX;
+    const double t1 = origin + direction * maxX;
+    first = qMin(t0, t1);
+    last = qMax(t0, t1);
+    return true;
 }
 
-void PlotView::onNewDataReceived()
+bool PlotView::pickTimeSeries(const QMatrix4x4 &mvp, const QPointF &pos, PickResult &result) const
 {
-    if (!m_realTimeMode || !m_dataReceiver)
+    double origin = 0.0;
+    double direction = 0.0;
+    if (!timeSeriesMapping(origin, direction))
     {
-        return;
+        return false;
     }
+    const std::vector<DataPoint> &series = m_triggerDisplay && !m_triggerFrame.empty() ? m_triggerFrame : m_realTimeBuffer;
 
-    // Get latest data from receiver
-    std::vector<DataPoint> newData = m_dataReceiver->getLatestData();
+    auto first = series.begin();
+    auto last = series.end();
 
-    // Add to real-time buffer
-    for (const auto &point : newData)
+    // Only the time range under the pick square is worth testing; binary
+    // search finds it when the series is sorted
+    double firstTime = 0.0;
+    double lastTime = 0.0;
+    const QRectF pickRect(pos.x() - m_pickRadius, pos.y() - m_pickRadius, 2 * m_pickRadius, 2 * m_pickRadius);
+    if (m_pickSeriesSorted && screenRectToTimeRange(mvp, pickRect, origin, direction, firstTime, lastTime))
     {
-        m_realTimeBuffer.push_back(point);
+        first = std::lower_bound(series.begin(), series.end(), firstTime,
+                                 [](const DataPoint &point, double t) { return point.timestamp < t; });
+        last = std::upper_bound(first, series.end(), lastTime,
+                                [](double t, const DataPoint &point) { return t < point.timestamp; });
     }
 
-    // Limit buffer size
-    while (m_realTimeBuffer.size() > m_maxRealTimePoints)
+    float bestDistanceSquared = m_pickRadius * m_pickRadius;
+    const DataPoint *best = nullptr;
+    QVector3D bestPosition;
+    for (auto it = first; it != last; ++it)
     {
-        m_realTimeBuffer.erase(m_realTimeBuffer.begin());
+        const QVector3D worldPos(static_cast<float>(direction * (it->timestamp - origin)), it->value,
+                                 static_cast<float>(it->channel));
+        QPointF screenPos;
+        if (!projectToScreen(mvp, worldPos, screenPos))
+        {
+            continue;
+        }
+
+        const QPointF delta = screenPos - pos;
+        const float distanceSquared = static_cast<float>(QPointF::dotProduct(delta, delta));
+        if (distanceSquared < bestDistanceSquared)
+        {
+            bestDistanceSquared = distanceSquared;
+            best = &*it;
+            bestPosition = worldPos;
+        }
     }
 
-    // Update visualization
-    if (!m_realTimeBuffer.empty())
+    if (!best)
     {
-        // Convert to plot format with newest data at x=0
-        std::vector<float> xData, yData, zData;
+        return false;
+    }
 
-        // Get the timestamp of the most recent data point
-        double latestTimestamp = m_realTimeBuffer.back().timestamp;
+    result.valid = true;
+    result.streamPoint = false;
+    result.timestamp = best->timestamp;
+    result.value = best->value;
+    result.channel = best->channel;
+    result.position = bestPosition;
+    return true;
+}
 
-        for (const auto &point : m_realTimeBuffer)
+bool PlotView::pickStream(const QMatrix4x4 &mvp, const QPointF &pos, PickResult &result) const
+{
+    const bool voxels = m_voxelDownsampling && m_realTimeLayout == XYZ_LAYOUT;
+
+    // Between rebuilds the octree still holds evicted points whose ring slot
+    // has been reused; those no longer match the slot. Voxel slots are never
+    // reused, but running means move away from the indexed position.
+    const auto current = [this, voxels](const PointOctree::Point &point) {
+        const int slot = static_cast<int>(point.id);
+        if (slot >= m_streamCount)
         {
-            // Calculate age of each point relative to the latest data
-            float age = static_cast<float>(latestTimestamp - point.timestamp);
-            xData.push_back(age); // Age 0 = newest data at x=0, older data at positive x
-            yData.push_back(point.value);
-            zData.push_back(static_cast<float>(point.channel)); // Use channel as Z
+            return false;
+        }
+        const float *vertex = &m_streamVertices[slot * 6];
+        return voxels || (vertex[0] == point.x && vertex[1] == point.y && vertex[2] == point.z);
+    };
+
+    PointOctree::Point point;
+    if (!m_octree.findNearestOnScreen(mvp.constData(), width(), height(), pos.x(), pos.y(), m_pickRadius,
+                                      current, point))
+    {
+        return false;
+    }
+
+    const float *vertex = &m_streamVertices[point.id * 6];
+    result.valid = true;
+    result.streamPoint = true;
+    result.timestamp = m_streamTimestamps[point.id];
+    result.position = QVector3D(vertex[0], vertex[1], vertex[2]);
+    return true;
+}
+
+void PlotView::renderPickInfo(QPainter &painter)
+{
+    const auto describe = [this](const PickResult &pick) {
+        QString text = QString("t = %1 s").arg(pick.timestamp, 0, 'f', 4);
+        if (pick.streamPoint)
+        {
+            const int channelCount = m_realTimeLayout == XYZ_LAYOUT ? 3 : 2;
+            for (int i = 0; i < channelCount; ++i)
+            {
+                text += QString("\nch %1 = %2").arg(m_layoutChannels[i]).arg(pick.position[i], 0, 'g', 6);
+            }
         }
+        else
+        {
+            text += QString("\nch %1 = %2").arg(pick.channel).arg(pick.value, 0, 'g', 6);
+        }
+        return text;
+    };
+
+    painter.setFont(QFont("Arial", 9));
 
-        // Clear existing data and add real-time series
-        clearData();
-        addDataSeries(xData, yData, zData, 2.0f); // Thicker line for real-time data
+    if (m_hoverPick.valid)
+    {
+        QPointF marker;
+        if (projectToScreen(getProjectionMatrix() * getViewMatrix(), m_hoverPick.position, marker))
+        {
+            painter.setPen(QPen(QColor(255, 140, 0), 2));
+            painter.setBrush(Qt::NoBrush);
+            painter.drawEllipse(marker, 5.0, 5.0);
+
+            // Label next to the marker, kept inside the widget
+            const QString text = describe(m_hoverPick);
+            QRect textRect = painter.fontMetrics().boundingRect(QRect(0, 0, width(), height()), Qt::AlignLeft, text);
+            textRect.moveTopLeft(QPoint(qMin(static_cast<int>(marker.x()) + 12, width() - textRect.width() - 10),
+                                        qMin(static_cast<int>(marker.y()) + 12, height() - textRect.height() - 10)));
+            painter.fillRect(textRect.adjusted(-5, -3, 5, 3), QColor(0, 0, 0, 160));
+            painter.setPen(QPen(Qt::white, 1));
+            painter.drawText(textRect, Qt::AlignLeft, text);
+        }
     }
 
-    // Clear receiver buffer to avoid accumulation
-    m_dataReceiver->clearData();
+    if (m_pinnedPick.valid)
+    {
+        // Pinned sample stays readable in the bottom-right corner
+        const QString text = "Pinned\n" + describe(m_pinnedPick);
+        QRect textRect = painter.fontMetrics().boundingRect(QRect(0, 0, width(), height()), Qt::AlignLeft, text);
+        textRect.moveTopLeft(QPoint(width() - textRect.width() - 15, height() - textRect.height() - 55));
+        painter.fillRect(textRect.adjusted(-5, -3, 5, 3), QColor(0, 0, 0, 128));
+        painter.setPen(QPen(Qt::white, 1));
+        painter.drawText(textRect, Qt::AlignLeft, text);
+    }
 }
 
 void PlotView::onDataReceiverConnected(bool connected)
@@ -1485,28 +3351,3 @@ float PlotView::getVisibleWorldSize() const
         return baseSizeFromFOV * m_zoom;                            // Same direction as orthographic
     }
 }
-
-float PlotView::calculateOptimalGridStep() const
-{
-    const float visibleSize = getVisibleWorldSize();
-    const int targetGridLines = 10; // Target number of grid lines visible
-
-    // Calculate raw step size to get target number of lines
-    float rawStep = visibleSize / targetGridLines;
-
-    // Round to "nice" numbers (1, 2, 5, 10, 20, 50, etc.)
-    float magnitude = pow(10.0f, floor(log10(rawStep)));
-    float normalizedStep = rawStep / magnitude;
-
-    float niceStep;
-    if (normalizedStep <= 1.0f)
-        niceStep = 1.0f;
-    else if (normalizedStep <= 2.0f)
-        niceStep = 2.0f;
-    else if (normalizedStep <= 5.0f)
-        niceStep = 5.0f;
-    else
-        niceStep = 10.0f;
-
-    return niceStep * magnitude;
-}
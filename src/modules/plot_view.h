@@ -2,6 +2,7 @@
 
 #include <QOpenGLWidget>
 #include <QOpenGLFunctions>
+#include <QOpenGLExtraFunctions>
 #include <QOpenGLShaderProgram>
 #include <QOpenGLBuffer>
 #include <QOpenGLVertexArrayObject>
@@ -12,9 +13,20 @@
 #include <QKeyEvent>
 #include <QPainter>
 #include <QVector3D>
+#include <QElapsedTimer>
+#include <QStringList>
+#if !QT_CONFIG(opengles2)
+#include <QOpenGLTimerQuery>
+#endif
 #include <vector>
 #include "view_angles.h"
 #include "data_receiver.h"
+#include "point_octree.h"
+#include "voxel_grid.h"
+#include "event_index.h"
+#include "plot_geometry.h"
+#include "frame_stats.h"
+#include "frame_writer.h"
 
 class PlotView : public QOpenGLWidget, protected QOpenGLFunctions
 {
@@ -44,6 +56,30 @@ public:
         ORTHOGRAPHIC_PROJECTION
     };
 
+    enum RealTimeLayout {
+        TIME_SERIES_LAYOUT,  // x = age, y = value, z = channel
+        XY_LAYOUT,           // x and y from two time-aligned channels
+        XYZ_LAYOUT,          // x, y and z from three time-aligned channels
+        HISTOGRAM_LAYOUT     // value distribution of one channel (x = value)
+    };
+
+    enum RealTimeStyle {
+        POINT_CLOUD_STYLE,
+        TRAJECTORY_STYLE
+    };
+
+    // Sample found under the mouse. In channel-mapped layouts position
+    // holds one value per mapped channel; otherwise value and channel
+    // describe a single time-series sample.
+    struct PickResult {
+        bool valid = false;
+        bool streamPoint = false;
+        double timestamp = 0.0;
+        float value = 0.0f;
+        int channel = 0;
+        QVector3D position;
+    };
+
     explicit PlotView(QWidget *parent = nullptr);
     ~PlotView() override;
 
@@ -64,6 +100,8 @@ public:
     // View control
     void resetView();
     void setViewAngles(double azimuth, double elevation);
+    void setZoom(float zoom);
+    float getZoom() const { return m_zoom; }
     
     // Projection control
     void toggleProjectionMode();
@@ -75,13 +113,67 @@ public:
     float getFOV() const;
     
     // Real-time data
-    void startDataReceiver(quint16 port = 8080);
+    void startDataReceiver(quint16 port = 8080, DataReceiver::InputFormat format = DataReceiver::TEXT_INPUT);
     void stopDataReceiver();
     void connectToDataSource(const QString& host, quint16 port);
     void setRealTimeMode(bool enabled);
     void setMaxRealTimePoints(int maxPoints);
+    void setClockCorrectionEnabled(bool enabled);
+    
+    // Channel mapping for real-time data
+    void setRealTimeLayout(RealTimeLayout layout, int xChannel = 0, int yChannel = 1, int zChannel = 2);
+    RealTimeLayout getRealTimeLayout() const;
+    void setRealTimeStyle(RealTimeStyle style);
+    void setAlignmentPeriod(double seconds);
+    void setVoxelDownsampling(bool enabled, float voxelSize = 0.01f,
+                              VoxelGrid::Mode mode = VoxelGrid::RUNNING_MEAN);
+    
+    // Trigger capture
+    void setTriggerSettings(const TriggerEngine::Settings& settings);
+    void armTrigger();
+    void disableTrigger();
+    
+    // Rolling statistics per channel, shown as text and optionally as
+    // mean/stddev/min/max bands behind the time series
+    void setStatisticsOverlay(bool enabled, double windowSeconds = 1.0);
+    void setStatisticsBands(bool enabled);
+    
+    // Peak and threshold-crossing markers on the time series
+    void setEventMarkers(bool enabled, const EventDetector::Settings& settings = EventDetector::Settings());
+    
+    // Frame time, stage breakdown, GPU time and throughput overlay
+    void setPerformanceHud(bool enabled);
+    bool isPerformanceHudEnabled() const { return m_performanceHud; }
+    
+    // Frame statistics are recorded with the HUD off too
+    FrameStats::Summary getFrameStats() const { return m_frameStats.summarize(); }
+    void resetFrameStats() { m_frameStats.reset(); }
+    quint64 getReceivedSampleCount() const;
+    int getReceiveQueueDepth() const;
+    
+    // Video capture at a fixed rate into a Y4M file (path ending in .y4m)
+    // or a directory of PPM frames. Frames are dropped, never waited for,
+    // when the GPU copy or the writer thread falls behind.
+    bool startCapture(const QString& path, int fps = 30);
+    void stopCapture();
+    bool isCapturing() const { return m_capturing; }
+    quint64 getCapturedFrameCount() const { return m_frameWriter.getWrittenCount(); }
+    quint64 getDroppedCaptureCount() const { return m_frameWriter.getDroppedCount(); }
+    
+    // Picking (screen position in widget pixels)
+    PickResult pickNearest(const QPoint& pos);
+    PickResult getPinnedPick() const;
     
     bool isReceivingData() const;
+    
+    // Headless rendering (see HeadlessRenderer). The caller keeps its own
+    // context current and binds a framebuffer of the view's size; the
+    // widget is never shown. replayData() feeds recorded stream bytes
+    // through a socketless receiver and updates the view at once, with
+    // arrivalTime standing in for the host clock.
+    void initializeOffscreen();
+    void renderOffscreen(QPaintDevice* overlayDevice);
+    void replayData(const QByteArray& data, double arrivalTime);
 
 protected:
     void initializeGL() override;
@@ -91,6 +183,7 @@ protected:
     void mousePressEvent(QMouseEvent* event) override;
     void mouseMoveEvent(QMouseEvent* event) override;
     void mouseReleaseEvent(QMouseEvent* event) override;
+    void leaveEvent(QEvent* event) override;
     void wheelEvent(QWheelEvent* event) override;
     void keyPressEvent(QKeyEvent* event) override;
     void keyReleaseEvent(QKeyEvent* event) override;
@@ -100,6 +193,7 @@ private slots:
     void onNewDataReceived();
     void onDataReceiverConnected(bool connected);
     void onDataReceiverError(const QString& error);
+    void onTriggerCaptured();
 
 private:
     void setupShaders();
@@ -113,16 +207,52 @@ private:
     void renderOriginPlanes();
     void renderBackgroundPlanes();
     void renderData();
+    void renderOverlay(QPainter& painter);
     void renderAxisNumbers(QPainter& painter);
     void renderAxisLabels(QPainter& painter);
     void renderInteractionMode(QPainter& painter);
+    void renderPerformanceHud(QPainter& painter);
+    void beginGpuTimer();
+    void endGpuTimer();
+    void renderClockDrift(QPainter& painter);
+    void renderTriggerStatus(QPainter& painter);
+    void renderStatistics(QPainter& painter);
+    void addStatisticsBands(float maxAge);
+    void showTriggerCapture();
+    void setSingleDataSeries(const std::vector<float>& xData, const std::vector<float>& yData,
+                             const std::vector<float>& zData, float lineWidth);
+    void createDataReceiver();
+    void applyRealTimeLayout();
+    void resetStream();
+    void streamAlignedFrames();
+    void appendStreamPoint(double timestamp, float x, float y, float z);
+    void appendVoxelPoint(double timestamp, float x, float y, float z);
+    void writeStreamVertex(int slot, float x, float y, float z);
+    void uploadStreamVertices();
+    void renderStream();
+    void rebuildOctree();
+    void renderOctreeLod();
+    void renderHistogram();
+    void renderEventMarkers();
+    void updatePickIndex(const std::vector<DataPoint>& series);
+    bool timeSeriesMapping(double& origin, double& direction) const;
+    bool screenRectToTimeRange(const QMatrix4x4& mvp, const QRectF& rect, double origin, double direction,
+                               double& first, double& last) const;
+    bool pickTimeSeries(const QMatrix4x4& mvp, const QPointF& pos, PickResult& result) const;
+    bool pickStream(const QMatrix4x4& mvp, const QPointF& pos, PickResult& result) const;
+    bool projectToScreen(const QMatrix4x4& mvp, const QVector3D& worldPos, QPointF& screenPos) const;
+    void renderPickInfo(QPainter& painter);
+    void dumpTrace();
+    void captureFrame();
+    bool captureReadbackReady(int slot);
+    void handOverCapture(int slot);
     
     QMatrix4x4 getViewMatrix() const;
     QMatrix4x4 getProjectionMatrix() const;
     QVector3D worldToScreen(const QVector3D& worldPos) const;
+    QVector3D worldToScreen(const QMatrix4x4& mvpMatrix, const QVector3D& worldPos) const;
     
-    // Dynamic grid helpers
-    float calculateOptimalGridStep() const;
+    // Dynamic grid helper
     float getVisibleWorldSize() const;
 
     // OpenGL resources
@@ -142,10 +272,35 @@ private:
     
     QOpenGLBuffer m_backgroundPlaneVertexBuffer;
     QOpenGLVertexArrayObject m_backgroundPlaneVAO;
+    
+    // Persistent streaming buffer for channel-mapped real-time data
+    QOpenGLBuffer m_streamVertexBuffer;
+    QOpenGLVertexArrayObject m_streamVAO;
+    
+    // Level-of-detail selection of large 3D point clouds
+    QOpenGLBuffer m_lodVertexBuffer;
+    QOpenGLVertexArrayObject m_lodVAO;
+    
+    // Histogram bars: one unit quad drawn per bin instance, or expanded on
+    // the CPU when instancing is unavailable
+    QOpenGLShaderProgram* m_barShaderProgram;
+    QOpenGLBuffer m_barQuadBuffer;
+    QOpenGLBuffer m_barInstanceBuffer;
+    QOpenGLVertexArrayObject m_barVAO;
+    bool m_instancingSupported;
+    bool m_barBuffersReady;
+    
+    // Event markers: a glyph outline in pixels drawn once per marker instance
+    QOpenGLShaderProgram* m_glyphShaderProgram;
+    QOpenGLBuffer m_glyphMeshBuffer;
+    QOpenGLBuffer m_glyphInstanceBuffer;
+    QOpenGLVertexArrayObject m_glyphVAO;
+    bool m_glyphBuffersReady;
 
     // Plot data
     std::vector<PlotData> m_plotDataSeries;
     std::vector<float> m_gridVertices;
+    std::vector<GridTick> m_gridTicks; // Reused by renderAxisNumbers()
     std::vector<float> m_axisVertices;
     std::vector<float> m_originPlaneVertices;
     std::vector<float> m_backgroundPlaneVertices;
@@ -164,6 +319,7 @@ private:
     
     // Mouse interaction
     QPoint m_lastMousePos;
+    QPoint m_pressMousePos;
     bool m_mousePressed;
     InteractionMode m_interactionMode;
     
@@ -180,4 +336,119 @@ private:
     bool m_realTimeMode;
     int m_maxRealTimePoints;
     std::vector<DataPoint> m_realTimeBuffer;
+    std::vector<float> m_seriesX, m_seriesY, m_seriesZ;  // Scratch columns, reused per update
+    std::vector<ClockDriftInfo> m_clockDriftInfo;
+    
+    // Rolling statistics
+    bool m_statisticsOverlay;
+    bool m_statisticsBands;
+    double m_statisticsWindow;
+    std::vector<ChannelStatistics> m_channelStatistics;
+    
+    // Trigger capture
+    TriggerEngine::Settings m_triggerSettings;
+    bool m_triggerDisplay;
+    std::vector<DataPoint> m_triggerFrame;
+    double m_triggerTime;
+    
+    // Channel-mapped real-time layouts. Vertices live in a ring mirrored in
+    // m_streamVertices; only the slots written since the last frame are
+    // uploaded. One extra slot repeats slot 0 so trajectories join across
+    // the wrap-around.
+    RealTimeLayout m_realTimeLayout;
+    RealTimeStyle m_realTimeStyle;
+    int m_layoutChannels[3];
+    double m_alignmentPeriod;
+    std::vector<double> m_alignedTimestamps;
+    std::vector<float> m_alignedValues;
+    std::vector<float> m_streamVertices;
+    int m_streamCapacity;
+    int m_streamHead;
+    int m_streamCount;
+    int m_streamDirtyFirst;
+    int m_streamDirtyCount;
+    bool m_streamSeamDirty;
+    int m_streamAllocatedSlots;
+    
+    // Octree over the streamed 3D points. It is rebuilt from the ring once
+    // evicted points make up a quarter of it, which keeps insertion
+    // amortized O(1). Above m_lodPointThreshold points, culling and LOD
+    // selection replace drawing the ring directly.
+    PointOctree m_octree;
+    bool m_octreeDirty;
+    QMatrix4x4 m_lodMVP;
+    std::vector<PointOctree::Point> m_lodPoints;
+    std::vector<float> m_lodVertices;
+    int m_lodVertexCount;
+    size_t m_lodPointThreshold;
+    float m_lodPixelThreshold;
+    
+    // Optional voxel downsampling of XYZ data. Stream slots then hold one
+    // representative per voxel instead of a ring of samples.
+    bool m_voxelDownsampling;
+    VoxelGrid m_voxelGrid;
+    
+    // Histogram layout, merged from the receiver once per update. Bar
+    // heights are normalized to the fullest bin.
+    ConcurrentHistogram::Snapshot m_histogram;
+    std::vector<float> m_barInstances;
+    std::vector<float> m_barVertices;
+    int m_barCount;
+    bool m_histogramDirty;
+    float m_histogramHeight;
+    
+    // Detected events, indexed by time so each frame only fetches the ones
+    // in view
+    bool m_eventMarkers;
+    EventDetector::Settings m_eventSettings;
+    EventIndex m_eventIndex;
+    std::vector<DetectedEvent> m_newEvents;
+    std::vector<DetectedEvent> m_visibleEvents;
+    std::vector<float> m_glyphInstances;
+    
+    // Picking. Stream slots remember the timestamp of the sample they
+    // hold; the octree answers screen-space queries for XY/XYZ layouts and
+    // the time series is searched by timestamp, which needs it sorted.
+    std::vector<double> m_streamTimestamps;
+    bool m_pickSeriesSorted;
+    int m_pickMinChannel;
+    int m_pickMaxChannel;
+    float m_pickRadius;
+    PickResult m_hoverPick;
+    PickResult m_pinnedPick;
+    
+    // Performance HUD. Stats are recorded into fixed rings every frame;
+    // the text is rebuilt a few times per second. GPU timer queries are
+    // read back GPU_TIMER_COUNT frames later so they never stall.
+    bool m_performanceHud;
+    FrameStats m_frameStats;
+    QElapsedTimer m_frameClock;
+    qint64 m_hudRefreshTime;
+    quint64 m_hudReceivedCount;
+    QStringList m_hudLines;
+    bool m_gpuTimersSupported;
+    bool m_gpuTimerActive;
+#if !QT_CONFIG(opengles2)
+    static const int GPU_TIMER_COUNT = 4;
+    QOpenGLTimerQuery* m_gpuTimers[GPU_TIMER_COUNT];
+    bool m_gpuTimerPending[GPU_TIMER_COUNT];
+    int m_gpuTimerIndex;
+#endif
+    
+    // Video capture. Each captured frame is read into the next pixel buffer
+    // of a ring and mapped only once its fence has signalled (or, without
+    // fences, once the ring comes round to it), so readback never stalls;
+    // the frame is then copied into a FrameWriter buffer.
+    static const int CAPTURE_PBO_COUNT = 3;
+    FrameWriter m_frameWriter;
+    bool m_capturing;
+    qint64 m_capturePeriod;
+    qint64 m_nextCaptureTime;
+    QOpenGLBuffer m_capturePbos[CAPTURE_PBO_COUNT];
+    bool m_capturePending[CAPTURE_PBO_COUNT];
+    int m_captureIndex;   // Next slot to fill; the oldest one when all are pending
+#if !QT_CONFIG(opengles2)
+    bool m_captureFencesSupported;
+    GLsync m_captureFences[CAPTURE_PBO_COUNT];
+#endif
 };
\ No newline at end of file
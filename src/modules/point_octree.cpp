@@ -0,0 +1,397 @@
+#include "point_octree.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+bool contains(const float center[3], float halfSize, float x, float y, float z)
+{
+    return std::fabs(x - center[0]) <= halfSize &&
+           std::fabs(y - center[1]) <= halfSize &&
+           std::fabs(z - center[2]) <= halfSize;
+}
+
+// Clip-space transform of a point with a column-major matrix
+void transform(const float* m, float x, float y, float z, float out[4])
+{
+    for (int row = 0; row < 4; ++row) {
+        out[row] = m[row] * x + m[4 + row] * y + m[8 + row] * z + m[12 + row];
+    }
+}
+
+// True when the box is entirely outside one of the six frustum planes
+bool outsideFrustum(const float* m, const float boundsMin[3], const float boundsMax[3])
+{
+    // Planes are row4 +/- row1..3 of the matrix (Gribb & Hartmann)
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int side = -1; side <= 1; side += 2) {
+            const float a = m[3] + side * m[axis];
+            const float b = m[7] + side * m[4 + axis];
+            const float c = m[11] + side * m[8 + axis];
+            const float d = m[15] + side * m[12 + axis];
+
+            // Corner furthest along the plane normal
+            const float px = a >= 0.0f ? boundsMax[0] : boundsMin[0];
+            const float py = b >= 0.0f ? boundsMax[1] : boundsMin[1];
+            const float pz = c >= 0.0f ? boundsMax[2] : boundsMin[2];
+            if (a * px + b * py + c * pz + d < 0.0f) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Screen rectangle of the box in pixels (origin top-left). Returns false
+// if the box crosses the camera plane and has no finite projection.
+bool projectedRect(const float* m, const float boundsMin[3], const float boundsMax[3],
+                   float viewportWidth, float viewportHeight, float rect[4])
+{
+    float minX = std::numeric_limits<float>::max();
+    float minY = std::numeric_limits<float>::max();
+    float maxX = std::numeric_limits<float>::lowest();
+    float maxY = std::numeric_limits<float>::lowest();
+
+    for (int corner = 0; corner < 8; ++corner) {
+        float clip[4];
+        transform(m,
+                  (corner & 1) ? boundsMax[0] : boundsMin[0],
+                  (corner & 2) ? boundsMax[1] : boundsMin[1],
+                  (corner & 4) ? boundsMax[2] : boundsMin[2],
+                  clip);
+        if (clip[3] <= 1e-6f) {
+            return false;
+        }
+        const float x = clip[0] / clip[3];
+        const float y = clip[1] / clip[3];
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+    }
+
+    rect[0] = (minX + 1.0f) * 0.5f * viewportWidth;
+    rect[1] = (1.0f - maxY) * 0.5f * viewportHeight;
+    rect[2] = (maxX + 1.0f) * 0.5f * viewportWidth;
+    rect[3] = (1.0f - minY) * 0.5f * viewportHeight;
+    return true;
+}
+
+// Largest screen extent of the box in pixels, or infinity if it crosses
+// the camera plane
+float projectedSize(const float* m, const float boundsMin[3], const float boundsMax[3],
+                    float viewportWidth, float viewportHeight)
+{
+    float rect[4];
+    if (!projectedRect(m, boundsMin, boundsMax, viewportWidth, viewportHeight, rect)) {
+        return std::numeric_limits<float>::infinity();
+    }
+    return std::max(rect[2] - rect[0], rect[3] - rect[1]);
+}
+
+// Lower bound of the screen distance from (x, y) to anything in the box
+float screenDistanceBound(const float* m, const float boundsMin[3], const float boundsMax[3],
+                          float viewportWidth, float viewportHeight, float x, float y)
+{
+    float rect[4];
+    if (!projectedRect(m, boundsMin, boundsMax, viewportWidth, viewportHeight, rect)) {
+        return 0.0f;
+    }
+    const float dx = std::max({rect[0] - x, 0.0f, x - rect[2]});
+    const float dy = std::max({rect[1] - y, 0.0f, y - rect[3]});
+    return std::sqrt(dx * dx + dy * dy);
+}
+}
+
+PointOctree::PointOctree()
+    : m_root(-1)
+    , m_pointCount(0)
+    , m_leafCapacity(256)
+    , m_sampleCount(16)
+    , m_maxDepth(20)
+    , m_randomState(0x9E3779B9u)
+{
+}
+
+void PointOctree::setLeafCapacity(size_t points)
+{
+    m_leafCapacity = std::max<size_t>(1, points);
+}
+
+void PointOctree::setSampleCount(size_t points)
+{
+    m_sampleCount = std::max<size_t>(1, points);
+}
+
+void PointOctree::clear()
+{
+    m_nodes.clear();
+    m_root = -1;
+    m_pointCount = 0;
+}
+
+void PointOctree::insert(const Point& point)
+{
+    if (!std::isfinite(point.x) || !std::isfinite(point.y) || !std::isfinite(point.z)) {
+        return;
+    }
+
+    if (m_root < 0) {
+        const float center[3] = {point.x, point.y, point.z};
+        m_root = createNode(center, 1.0f);
+    }
+    growToContain(point);
+
+    int nodeIndex = m_root;
+    int depth = 0;
+    while (true) {
+        addToNode(nodeIndex, point);
+
+        if (m_nodes[nodeIndex].isLeaf) {
+            Node& leaf = m_nodes[nodeIndex];
+            leaf.points.push_back(point);
+            if (leaf.points.size() > m_leafCapacity && depth < m_maxDepth) {
+                split(nodeIndex);
+            }
+            break;
+        }
+
+        nodeIndex = m_nodes[nodeIndex].children[childFor(m_nodes[nodeIndex], point)];
+        ++depth;
+    }
+
+    ++m_pointCount;
+}
+
+size_t PointOctree::selectVisible(const float* mvp, float viewportWidth, float viewportHeight,
+                                  float lodPixelThreshold, std::vector<Point>& out) const
+{
+    if (m_root < 0) {
+        return 0;
+    }
+
+    const size_t before = out.size();
+    m_stack.clear();
+    m_stack.push_back(m_root);
+
+    while (!m_stack.empty()) {
+        const Node& node = m_nodes[m_stack.back()];
+        m_stack.pop_back();
+
+        if (node.count == 0 || outsideFrustum(mvp, node.boundsMin, node.boundsMax)) {
+            continue;
+        }
+
+        if (node.isLeaf) {
+            const bool small = projectedSize(mvp, node.boundsMin, node.boundsMax,
+                                             viewportWidth, viewportHeight) < lodPixelThreshold;
+            const std::vector<Point>& source = small ? node.samples : node.points;
+            out.insert(out.end(), source.begin(), source.end());
+            continue;
+        }
+
+        if (projectedSize(mvp, node.boundsMin, node.boundsMax, viewportWidth, viewportHeight) < lodPixelThreshold) {
+            out.insert(out.end(), node.samples.begin(), node.samples.end());
+            continue;
+        }
+
+        for (int child : node.children) {
+            m_stack.push_back(child);
+        }
+    }
+
+    return out.size() - before;
+}
+
+bool PointOctree::findNearestOnScreen(const float* mvp, float viewportWidth, float viewportHeight,
+                                      float screenX, float screenY, float maxPixelDistance,
+                                      const std::function<bool(const Point&)>& accept, Point& result) const
+{
+    if (m_root < 0) {
+        return false;
+    }
+
+    const auto closerFirst = [](const std::pair<float, int>& a, const std::pair<float, int>& b) {
+        return a.first > b.first;
+    };
+
+    float bestDistanceSquared = maxPixelDistance * maxPixelDistance;
+    bool found = false;
+
+    m_queue.clear();
+    m_queue.emplace_back(0.0f, m_root);
+
+    while (!m_queue.empty()) {
+        std::pop_heap(m_queue.begin(), m_queue.end(), closerFirst);
+        const std::pair<float, int> entry = m_queue.back();
+        m_queue.pop_back();
+
+        // Everything left is further away than the best match
+        if (entry.first * entry.first > bestDistanceSquared) {
+            break;
+        }
+
+        const Node& node = m_nodes[entry.second];
+        if (node.isLeaf) {
+            for (const Point& point : node.points) {
+                float clip[4];
+                transform(mvp, point.x, point.y, point.z, clip);
+                if (clip[3] <= 1e-6f || std::fabs(clip[2]) > clip[3]) {
+                    continue;
+                }
+                const float x = (clip[0] / clip[3] + 1.0f) * 0.5f * viewportWidth;
+                const float y = (1.0f - clip[1] / clip[3]) * 0.5f * viewportHeight;
+                const float distanceSquared = (x - screenX) * (x - screenX) + (y - screenY) * (y - screenY);
+                if (distanceSquared < bestDistanceSquared && (!accept || accept(point))) {
+                    bestDistanceSquared = distanceSquared;
+                    result = point;
+                    found = true;
+                }
+            }
+            continue;
+        }
+
+        for (int child : node.children) {
+            const Node& childNode = m_nodes[child];
+            if (childNode.count == 0 || outsideFrustum(mvp, childNode.boundsMin, childNode.boundsMax)) {
+                continue;
+            }
+            const float bound = screenDistanceBound(mvp, childNode.boundsMin, childNode.boundsMax,
+                                                    viewportWidth, viewportHeight, screenX, screenY);
+            if (bound * bound <= bestDistanceSquared) {
+                m_queue.emplace_back(bound, child);
+                std::push_heap(m_queue.begin(), m_queue.end(), closerFirst);
+            }
+        }
+    }
+
+    return found;
+}
+
+int PointOctree::createNode(const float center[3], float halfSize)
+{
+    Node node;
+    for (int axis = 0; axis < 3; ++axis) {
+        node.center[axis] = center[axis];
+        node.boundsMin[axis] = std::numeric_limits<float>::max();
+        node.boundsMax[axis] = std::numeric_limits<float>::lowest();
+    }
+    node.halfSize = halfSize;
+    std::fill(std::begin(node.children), std::end(node.children), -1);
+
+    m_nodes.push_back(std::move(node));
+    return static_cast<int>(m_nodes.size()) - 1;
+}
+
+void PointOctree::growToContain(const Point& point)
+{
+    // Double the root towards the point until it fits; the old root
+    // becomes one octant of the new one
+    while (!contains(m_nodes[m_root].center, m_nodes[m_root].halfSize, point.x, point.y, point.z)) {
+        const Node& oldRoot = m_nodes[m_root];
+        const float half = oldRoot.halfSize;
+        const float coordinates[3] = {point.x, point.y, point.z};
+
+        float center[3];
+        int octant = 0;
+        for (int axis = 0; axis < 3; ++axis) {
+            const bool towardsPositive = coordinates[axis] >= oldRoot.center[axis];
+            center[axis] = oldRoot.center[axis] + (towardsPositive ? half : -half);
+            // The old root sits on the opposite side of the new center
+            if (!towardsPositive) {
+                octant |= 1 << axis;
+            }
+        }
+
+        const int oldRootIndex = m_root;
+        const int newRoot = createNode(center, half * 2.0f);
+        Node& root = m_nodes[newRoot];
+        const Node& previous = m_nodes[oldRootIndex];
+        root.isLeaf = false;
+        root.count = previous.count;
+        root.samples = previous.samples;
+        for (int axis = 0; axis < 3; ++axis) {
+            root.boundsMin[axis] = previous.boundsMin[axis];
+            root.boundsMax[axis] = previous.boundsMax[axis];
+        }
+
+        for (int child = 0; child < 8; ++child) {
+            if (child == octant) {
+                m_nodes[newRoot].children[child] = oldRootIndex;
+                continue;
+            }
+            float childCenter[3];
+            for (int axis = 0; axis < 3; ++axis) {
+                const float offset = (child & (1 << axis)) ? half : -half;
+                childCenter[axis] = center[axis] + offset;
+            }
+            const int childIndex = createNode(childCenter, half);
+            m_nodes[newRoot].children[child] = childIndex;
+        }
+
+        m_root = newRoot;
+    }
+}
+
+void PointOctree::addToNode(int nodeIndex, const Point& point)
+{
+    Node& node = m_nodes[nodeIndex];
+    node.boundsMin[0] = std::min(node.boundsMin[0], point.x);
+    node.boundsMin[1] = std::min(node.boundsMin[1], point.y);
+    node.boundsMin[2] = std::min(node.boundsMin[2], point.z);
+    node.boundsMax[0] = std::max(node.boundsMax[0], point.x);
+    node.boundsMax[1] = std::max(node.boundsMax[1], point.y);
+    node.boundsMax[2] = std::max(node.boundsMax[2], point.z);
+    ++node.count;
+
+    // Reservoir sampling keeps a uniform subsample of everything below
+    if (node.samples.size() < m_sampleCount) {
+        node.samples.push_back(point);
+    }
+    else {
+        const uint64_t slot = nextRandom() % node.count;
+        if (slot < m_sampleCount) {
+            node.samples[slot] = point;
+        }
+    }
+}
+
+void PointOctree::split(int nodeIndex)
+{
+    const float half = m_nodes[nodeIndex].halfSize * 0.5f;
+    for (int child = 0; child < 8; ++child) {
+        float childCenter[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            const float offset = (child & (1 << axis)) ? half : -half;
+            childCenter[axis] = m_nodes[nodeIndex].center[axis] + offset;
+        }
+        const int childIndex = createNode(childCenter, half);
+        m_nodes[nodeIndex].children[child] = childIndex;
+    }
+
+    std::vector<Point> points;
+    points.swap(m_nodes[nodeIndex].points);
+    m_nodes[nodeIndex].isLeaf = false;
+
+    for (const Point& point : points) {
+        const int childIndex = m_nodes[nodeIndex].children[childFor(m_nodes[nodeIndex], point)];
+        addToNode(childIndex, point);
+        m_nodes[childIndex].points.push_back(point);
+    }
+}
+
+int PointOctree::childFor(const Node& node, const Point& point) const
+{
+    return (point.x >= node.center[0] ? 1 : 0) |
+           (point.y >= node.center[1] ? 2 : 0) |
+           (point.z >= node.center[2] ? 4 : 0);
+}
+
+uint32_t PointOctree::nextRandom()
+{
+    // xorshift32
+    m_randomState ^= m_randomState << 13;
+    m_randomState ^= m_randomState >> 17;
+    m_randomState ^= m_randomState << 5;
+    return m_randomState;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Incrementally built octree over 3D points for culling and level of detail.
+//
+// Every node keeps a tight bounding box of the points below it and a
+// representative subsample (reservoir sample) of them. Leaves split once
+// they exceed the leaf capacity, and the root grows outwards when a point
+// lands outside it, so points can be inserted as they stream in without
+// knowing the extent up front.
+//
+// selectVisible() walks the tree with a model-view-projection matrix:
+// nodes outside the view frustum are skipped, and nodes that project to
+// fewer pixels than the LOD threshold contribute only their subsample.
+// findNearestOnScreen() uses the same projected bounds for a best-first
+// search of the point closest to a screen position.
+class PointOctree
+{
+public:
+    struct Point {
+        float x;
+        float y;
+        float z;
+        uint32_t id;  // Caller-defined, e.g. a vertex slot
+    };
+
+    PointOctree();
+
+    void setLeafCapacity(size_t points);
+    void setSampleCount(size_t points);
+
+    void clear();
+    void insert(const Point& point);
+    size_t size() const { return m_pointCount; }
+
+    // mvp is a column-major 4x4 matrix (as QMatrix4x4::constData()).
+    // Selected points are appended to out; returns how many were added.
+    size_t selectVisible(const float* mvp, float viewportWidth, float viewportHeight,
+                         float lodPixelThreshold, std::vector<Point>& out) const;
+
+    // Nearest point to the screen position (pixels, origin top-left) within
+    // maxPixelDistance. Points rejected by accept (if given) are skipped.
+    bool findNearestOnScreen(const float* mvp, float viewportWidth, float viewportHeight,
+                             float screenX, float screenY, float maxPixelDistance,
+                             const std::function<bool(const Point&)>& accept, Point& result) const;
+
+private:
+    struct Node {
+        float center[3];
+        float halfSize;
+        float boundsMin[3];
+        float boundsMax[3];
+        int children[8];
+        bool isLeaf = true;
+        uint64_t count = 0;
+        std::vector<Point> points;   // Leaf contents
+        std::vector<Point> samples;  // Representative subsample
+    };
+
+    int createNode(const float center[3], float halfSize);
+    void growToContain(const Point& point);
+    void addToNode(int nodeIndex, const Point& point);
+    void split(int nodeIndex);
+    int childFor(const Node& node, const Point& point) const;
+    uint32_t nextRandom();
+
+    std::vector<Node> m_nodes;
+    int m_root;
+    size_t m_pointCount;
+    size_t m_leafCapacity;
+    size_t m_sampleCount;
+    int m_maxDepth;
+    uint32_t m_randomState;
+
+    // Traversal stack and best-first queue reused between queries
+    mutable std::vector<int> m_stack;
+    mutable std::vector<std::pair<float, int>> m_queue;
+};
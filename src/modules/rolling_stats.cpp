@@ -0,0 +1,297 @@
+#include "rolling_stats.h"
+#include <algorithm>
+#include <cmath>
+
+RollingStats::RollingStats()
+    : m_window(1.0)
+    , m_maxSamples(1 << 20)
+    , m_quantileLevels({0.05, 0.5, 0.95})
+{
+    clear();
+}
+
+void RollingStats::setWindow(double seconds)
+{
+    m_window = std::max(seconds, 1e-6);
+    clear();
+}
+
+void RollingStats::setQuantileLevels(const std::vector<double>& levels)
+{
+    m_quantileLevels.clear();
+    for (double level : levels) {
+        m_quantileLevels.push_back(std::clamp(level, 0.0, 1.0));
+    }
+    clear();
+}
+
+void RollingStats::setMaxSamples(size_t maxSamples)
+{
+    m_maxSamples = std::max<size_t>(maxSamples, 1);
+    clear();
+}
+
+void RollingStats::clear()
+{
+    m_samples.clear();
+    m_nextSequence = 0;
+    m_newestTimestamp = 0.0;
+
+    m_mean = 0.0;
+    m_m2 = 0.0;
+    m_removalsSinceRecompute = 0;
+
+    m_minQueue.clear();
+    m_maxQueue.clear();
+
+    m_estimators.clear();
+    for (double level : m_quantileLevels) {
+        m_estimators.emplace_back(level);
+    }
+    m_completedQuantiles.assign(m_quantileLevels.size(), 0.0f);
+    m_hasCompletedQuantiles = false;
+    m_quantileWindowStarted = false;
+    m_quantileWindowStart = 0.0;
+}
+
+void RollingStats::add(double timestamp, float value)
+{
+    if (!std::isfinite(value)) {
+        return;
+    }
+
+    const Sample sample = {m_nextSequence++, timestamp, value};
+    if (m_samples.empty() || timestamp > m_newestTimestamp) {
+        m_newestTimestamp = timestamp;
+    }
+
+    // Welford insertion
+    m_samples.pushBack(sample);
+    const double delta = value - m_mean;
+    m_mean += delta / static_cast<double>(m_samples.size);
+    m_m2 += delta * (value - m_mean);
+
+    // Drop dominated entries so the queue fronts stay the extremes
+    while (!m_minQueue.empty() && m_minQueue.back().value >= value) {
+        m_minQueue.popBack();
+    }
+    m_minQueue.pushBack(sample);
+    while (!m_maxQueue.empty() && m_maxQueue.back().value <= value) {
+        m_maxQueue.popBack();
+    }
+    m_maxQueue.pushBack(sample);
+
+    // Evict by arrival order; late samples leave with their neighbours
+    const double cutoff = m_newestTimestamp - m_window;
+    while (m_samples.size > m_maxSamples ||
+           (m_samples.size > 1 && m_samples.front().timestamp < cutoff)) {
+        removeOldest();
+    }
+
+    // Tumbling quantile windows
+    if (!m_quantileWindowStarted) {
+        m_quantileWindowStarted = true;
+        m_quantileWindowStart = timestamp;
+    } else if (timestamp - m_quantileWindowStart >= m_window) {
+        for (size_t i = 0; i < m_estimators.size(); ++i) {
+            m_completedQuantiles[i] = static_cast<float>(m_estimators[i].value());
+            m_estimators[i].reset();
+        }
+        m_hasCompletedQuantiles = true;
+
+        // Stay on the window grid across gaps
+        m_quantileWindowStart += std::floor((timestamp - m_quantileWindowStart) / m_window) * m_window;
+    }
+    for (auto& estimator : m_estimators) {
+        estimator.add(value);
+    }
+}
+
+void RollingStats::removeOldest()
+{
+    const Sample oldest = m_samples.front();
+    m_samples.popFront();
+
+    if (!m_minQueue.empty() && m_minQueue.front().sequence == oldest.sequence) {
+        m_minQueue.popFront();
+    }
+    if (!m_maxQueue.empty() && m_maxQueue.front().sequence == oldest.sequence) {
+        m_maxQueue.popFront();
+    }
+
+    // Welford removal
+    if (m_samples.empty()) {
+        m_mean = 0.0;
+        m_m2 = 0.0;
+        m_removalsSinceRecompute = 0;
+        return;
+    }
+    const double delta = oldest.value - m_mean;
+    m_mean -= delta / static_cast<double>(m_samples.size);
+    m_m2 = std::max(0.0, m_m2 - delta * (oldest.value - m_mean));
+
+    if (++m_removalsSinceRecompute >= m_samples.size) {
+        recomputeMoments();
+    }
+}
+
+void RollingStats::SampleQueue::pushBack(const Sample& sample)
+{
+    if (size == samples.size()) {
+        // Unroll into a ring twice the size
+        std::vector<Sample> grown(std::max<size_t>(16, samples.size() * 2));
+        for (size_t i = 0; i < size; ++i) {
+            grown[i] = at(i);
+        }
+        samples.swap(grown);
+        head = 0;
+    }
+    samples[(head + size) & (samples.size() - 1)] = sample;
+    ++size;
+}
+
+void RollingStats::SampleQueue::popFront()
+{
+    head = (head + 1) & (samples.size() - 1);
+    --size;
+}
+
+void RollingStats::recomputeMoments()
+{
+    m_mean = 0.0;
+    m_m2 = 0.0;
+    size_t count = 0;
+    for (size_t i = 0; i < m_samples.size; ++i) {
+        const Sample& sample = m_samples.at(i);
+        ++count;
+        const double delta = sample.value - m_mean;
+        m_mean += delta / static_cast<double>(count);
+        m_m2 += delta * (sample.value - m_mean);
+    }
+    m_removalsSinceRecompute = 0;
+}
+
+RollingStats::Summary RollingStats::getSummary() const
+{
+    Summary summary;
+    summary.count = m_samples.size;
+    summary.quantileLevels = m_quantileLevels;
+    if (m_samples.empty()) {
+        summary.quantiles.assign(m_quantileLevels.size(), 0.0f);
+        return summary;
+    }
+
+    summary.mean = m_mean;
+    summary.stddev = m_samples.size > 1 ? std::sqrt(m_m2 / static_cast<double>(m_samples.size - 1)) : 0.0;
+    summary.min = m_minQueue.front().value;
+    summary.max = m_maxQueue.front().value;
+
+    if (m_hasCompletedQuantiles) {
+        summary.quantiles = m_completedQuantiles;
+    } else {
+        for (const auto& estimator : m_estimators) {
+            summary.quantiles.push_back(static_cast<float>(estimator.value()));
+        }
+    }
+    return summary;
+}
+
+RollingStats::P2Quantile::P2Quantile(double level)
+    : m_level(level)
+{
+    reset();
+}
+
+void RollingStats::P2Quantile::reset()
+{
+    m_count = 0;
+    const double p = m_level;
+    for (int i = 0; i < 5; ++i) {
+        m_heights[i] = 0.0;
+        m_positions[i] = i;
+    }
+    m_desired[0] = 0.0;
+    m_desired[1] = 2.0 * p;
+    m_desired[2] = 4.0 * p;
+    m_desired[3] = 2.0 + 2.0 * p;
+    m_desired[4] = 4.0;
+    m_increments[0] = 0.0;
+    m_increments[1] = p / 2.0;
+    m_increments[2] = p;
+    m_increments[3] = (1.0 + p) / 2.0;
+    m_increments[4] = 1.0;
+}
+
+void RollingStats::P2Quantile::add(double x)
+{
+    // The first five samples initialise the markers
+    if (m_count < 5) {
+        m_heights[m_count++] = x;
+        if (m_count == 5) {
+            std::sort(m_heights, m_heights + 5);
+        }
+        return;
+    }
+    ++m_count;
+
+    // Cell containing x, extending the extremes if needed
+    int k;
+    if (x < m_heights[0]) {
+        m_heights[0] = x;
+        k = 0;
+    } else if (x >= m_heights[4]) {
+        m_heights[4] = x;
+        k = 3;
+    } else {
+        k = 0;
+        while (x >= m_heights[k + 1]) {
+            ++k;
+        }
+    }
+
+    for (int i = k + 1; i < 5; ++i) {
+        m_positions[i] += 1.0;
+    }
+    for (int i = 0; i < 5; ++i) {
+        m_desired[i] += m_increments[i];
+    }
+
+    // Move the middle markers towards their desired positions
+    for (int i = 1; i < 4; ++i) {
+        const double d = m_desired[i] - m_positions[i];
+        if ((d >= 1.0 && m_positions[i + 1] - m_positions[i] > 1.0) ||
+            (d <= -1.0 && m_positions[i - 1] - m_positions[i] < -1.0)) {
+            const int step = d > 0.0 ? 1 : -1;
+
+            // Piecewise-parabolic prediction, linear if it breaks monotonicity
+            const double parabolic = m_heights[i] + step / (m_positions[i + 1] - m_positions[i - 1]) *
+                ((m_positions[i] - m_positions[i - 1] + step) * (m_heights[i + 1] - m_heights[i]) /
+                     (m_positions[i + 1] - m_positions[i]) +
+                 (m_positions[i + 1] - m_positions[i] - step) * (m_heights[i] - m_heights[i - 1]) /
+                     (m_positions[i] - m_positions[i - 1]));
+            if (m_heights[i - 1] < parabolic && parabolic < m_heights[i + 1]) {
+                m_heights[i] = parabolic;
+            } else {
+                m_heights[i] += step * (m_heights[i + step] - m_heights[i]) /
+                                (m_positions[i + step] - m_positions[i]);
+            }
+            m_positions[i] += step;
+        }
+    }
+}
+
+double RollingStats::P2Quantile::value() const
+{
+    if (m_count == 0) {
+        return 0.0;
+    }
+    if (m_count < 5) {
+        // Exact quantile of the few samples seen so far
+        double sorted[5];
+        std::copy(m_heights, m_heights + m_count, sorted);
+        std::sort(sorted, sorted + m_count);
+        const size_t rank = static_cast<size_t>(std::round(m_level * static_cast<double>(m_count - 1)));
+        return sorted[rank];
+    }
+    return m_heights[2];
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Statistics of one channel over a sliding time window, updated per sample:
+//  - mean and variance with Welford's method, including removal of samples
+//    that leave the window
+//  - min and max from monotonic queues (amortized O(1))
+//  - quantiles from P² estimators, which cannot forget samples and are
+//    therefore restarted every window length (tumbling). Reported
+//    quantiles belong to the last completed window, or to the current one
+//    until a window has completed.
+class RollingStats
+{
+public:
+    struct Summary {
+        size_t count = 0;
+        double mean = 0.0;
+        double stddev = 0.0;
+        float min = 0.0f;
+        float max = 0.0f;
+        std::vector<double> quantileLevels;
+        std::vector<float> quantiles;  // One per level, same order
+    };
+
+    RollingStats();
+
+    // Configuration (clears all state)
+    void setWindow(double seconds);
+    void setQuantileLevels(const std::vector<double>& levels);
+    void setMaxSamples(size_t maxSamples);
+
+    double getWindow() const { return m_window; }
+    const std::vector<double>& getQuantileLevels() const { return m_quantileLevels; }
+
+    void clear();
+
+    // Samples older than the window, relative to the newest timestamp seen,
+    // are evicted on every call
+    void add(double timestamp, float value);
+
+    size_t getCount() const { return m_samples.size; }
+    Summary getSummary() const;
+
+private:
+    // P² single quantile estimator (Jain & Chlamtac), O(1) memory
+    class P2Quantile
+    {
+    public:
+        explicit P2Quantile(double level = 0.5);
+        void reset();
+        void add(double x);
+        bool empty() const { return m_count == 0; }
+        double value() const;
+
+    private:
+        double m_level;
+        size_t m_count;
+        double m_heights[5];
+        double m_positions[5];
+        double m_desired[5];
+        double m_increments[5];
+    };
+
+    struct Sample {
+        uint64_t sequence;
+        double timestamp;
+        float value;
+    };
+
+    // Double-ended queue in one growable ring. Unlike std::deque it keeps
+    // its storage while sliding, so a full window stops allocating.
+    struct SampleQueue {
+        std::vector<Sample> samples;  // Capacity is a power of two
+        size_t head = 0;
+        size_t size = 0;
+
+        bool empty() const { return size == 0; }
+        const Sample& at(size_t i) const { return samples[(head + i) & (samples.size() - 1)]; }
+        const Sample& front() const { return at(0); }
+        const Sample& back() const { return at(size - 1); }
+
+        void pushBack(const Sample& sample);
+        void popFront();
+        void popBack() { --size; }
+        void clear() { head = 0; size = 0; }
+    };
+
+    void removeOldest();
+    void recomputeMoments();
+
+    double m_window;
+    size_t m_maxSamples;
+
+    // Samples in the window, oldest first
+    SampleQueue m_samples;
+    uint64_t m_nextSequence;
+    double m_newestTimestamp;
+
+    // Welford moments. Removal accumulates rounding error, so the moments
+    // are recomputed exactly once as many samples were removed as the
+    // window holds (amortized O(1)).
+    double m_mean;
+    double m_m2;
+    size_t m_removalsSinceRecompute;
+
+    // Monotonic queues: values increasing (min at front) and decreasing
+    // (max at front)
+    SampleQueue m_minQueue;
+    SampleQueue m_maxQueue;
+
+    // Tumbling-window quantiles
+    std::vector<double> m_quantileLevels;
+    std::vector<P2Quantile> m_estimators;
+    std::vector<float> m_completedQuantiles;
+    bool m_hasCompletedQuantiles;
+    bool m_quantileWindowStarted;
+    double m_quantileWindowStart;
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+
+// Reports changes to individual files, including replacement through a
+// rename (how editors and SettingsHandler save). Changes arriving in quick
+// succession are reported once. Callbacks run on the watcher's own thread.
+class FileWatcher {
+public:
+    virtual ~FileWatcher() = default;
+
+    // Files may be added before or after start()
+    virtual bool addFile(const std::string& path) = 0;
+    virtual bool start(std::function<void(const std::string& path)> onChanged) = 0;
+    virtual void stop() = 0;
+
+    // Factory method to create the platform implementation; its start()
+    // fails where watching is not supported
+    static std::unique_ptr<FileWatcher> create();
+};
@@ -0,0 +1,173 @@
+#include "file_watcher.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+// Watches the directories containing the files rather than the files
+// themselves: a rename replaces the inode, which would end a watch on the
+// file. Only completed writes (close after writing) and renames into place
+// count, so half-written files are never reported.
+class LinuxFileWatcher : public FileWatcher {
+public:
+    LinuxFileWatcher()
+        : inotifyFd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+        , wakeFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+        if (inotifyFd < 0 || wakeFd < 0) {
+            std::cerr << "Failed to initialize inotify" << std::endl;
+        }
+    }
+
+    ~LinuxFileWatcher() override {
+        stop();
+        if (inotifyFd >= 0) {
+            ::close(inotifyFd);
+        }
+        if (wakeFd >= 0) {
+            ::close(wakeFd);
+        }
+    }
+
+    bool addFile(const std::string& path) override {
+        if (inotifyFd < 0) {
+            return false;
+        }
+
+        const std::filesystem::path filePath = std::filesystem::absolute(path).lexically_normal();
+        const std::string directory = filePath.parent_path().string();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        const int wd = inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd < 0) {
+            std::cerr << "Failed to watch directory: " << directory << std::endl;
+            return false;
+        }
+        directories[wd] = directory;
+        files[filePath.string()] = path;
+        return true;
+    }
+
+    bool start(std::function<void(const std::string&)> onChanged) override {
+        if (inotifyFd < 0 || wakeFd < 0) {
+            return false;
+        }
+        if (thread.joinable()) {
+            return true;
+        }
+        callback = std::move(onChanged);
+        thread = std::thread(&LinuxFileWatcher::run, this);
+        return true;
+    }
+
+    void stop() override {
+        if (!thread.joinable()) {
+            return;
+        }
+        const uint64_t one = 1;
+        if (::write(wakeFd, &one, sizeof(one)) < 0) {
+            std::cerr << "Failed to wake file watcher" << std::endl;
+        }
+        thread.join();
+
+        uint64_t count;
+        while (::read(wakeFd, &count, sizeof(count)) > 0) {
+        }
+    }
+
+private:
+    // Time to wait for further events before reporting, so an editor's
+    // save sequence is reported once. A file that keeps changing is still
+    // reported at least every MAX_DELAY_MS.
+    static constexpr int SETTLE_MS = 50;
+    static constexpr int MAX_DELAY_MS = 500;
+
+    const int inotifyFd;
+    const int wakeFd;
+    std::thread thread;
+    std::function<void(const std::string&)> callback;
+
+    std::mutex mutex;  // Guards the maps, which addFile() changes while running
+    std::map<int, std::string> directories;
+    std::map<std::string, std::string> files;  // Normalized path to path as added
+
+    void run() {
+        std::set<std::string> changed;
+        std::chrono::steady_clock::time_point deadline;
+        while (true) {
+            int timeout = -1;
+            if (!changed.empty()) {
+                const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now());
+                timeout = static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(SETTLE_MS, remaining.count())));
+            }
+
+            pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+            const int ready = ::poll(fds, 2, timeout);
+            if (ready < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                std::cerr << "File watcher stopped: poll failed" << std::endl;
+                return;
+            }
+            if (fds[1].revents & POLLIN) {
+                return;
+            }
+
+            if (fds[0].revents & POLLIN) {
+                const bool wasEmpty = changed.empty();
+                readEvents(changed);
+                if (wasEmpty && !changed.empty()) {
+                    deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(MAX_DELAY_MS);
+                }
+            }
+
+            // Settled, or changing for too long to wait any more
+            if (!changed.empty() && (ready == 0 || std::chrono::steady_clock::now() >= deadline)) {
+                for (const auto& path : changed) {
+                    callback(path);
+                }
+                changed.clear();
+            }
+        }
+    }
+
+    void readEvents(std::set<std::string>& changed) {
+        alignas(inotify_event) char buffer[4096];
+        while (true) {
+            const ssize_t length = ::read(inotifyFd, buffer, sizeof(buffer));
+            if (length <= 0) {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            for (ssize_t offset = 0; offset < length;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += sizeof(inotify_event) + event->len;
+
+                const auto directory = directories.find(event->wd);
+                if (event->len == 0 || directory == directories.end()) {
+                    continue;
+                }
+                const auto file = files.find(directory->second + "/" + event->name);
+                if (file != files.end()) {
+                    changed.insert(file->second);
+                }
+            }
+        }
+    }
+};
+
+std::unique_ptr<FileWatcher> FileWatcher::create() {
+    return std::make_unique<LinuxFileWatcher>();
+}
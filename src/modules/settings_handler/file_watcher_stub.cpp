@@ -0,0 +1,23 @@
+#include "file_watcher.h"
+#include <iostream>
+
+// Platforms without a watcher implementation: settings are only reloaded
+// through loadSettings()
+class UnsupportedFileWatcher : public FileWatcher {
+public:
+    bool addFile(const std::string&) override {
+        return false;
+    }
+
+    bool start(std::function<void(const std::string&)>) override {
+        std::cerr << "Watching settings files is not supported on this platform" << std::endl;
+        return false;
+    }
+
+    void stop() override {
+    }
+};
+
+std::unique_ptr<FileWatcher> FileWatcher::create() {
+    return std::make_unique<UnsupportedFileWatcher>();
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+// Typed setting declared once in code, with its default:
+//
+//   const SettingKey<int> FPS_LIMIT_KEY("/view/fps_limit", 60);
+//   const SettingKey<std::string> THEME_KEY("theme", "light");
+//
+// Paths starting with '/' are JSON pointers into grouped settings, other
+// paths name a top-level key. SettingsHandler::bind() resolves a key once
+// to a slot that always holds the current value.
+template<typename T>
+struct SettingKey {
+    SettingKey(std::string path, T defaultValue)
+        : path(std::move(path)), defaultValue(std::move(defaultValue)) {}
+
+    std::string path;
+    T defaultValue;
+};
+
+namespace settings_detail {
+
+// Value storage of a slot. Trivially copyable values are a single atomic,
+// so reading one is a plain load; others are swapped as immutable copies.
+template<typename T, bool = std::is_trivially_copyable<T>::value>
+class SlotValue {
+public:
+    explicit SlotValue(const T& value) : value(value) {}
+    T load() const { return value.load(std::memory_order_acquire); }
+    void store(const T& next) { value.store(next, std::memory_order_release); }
+
+private:
+    std::atomic<T> value;
+};
+
+template<typename T>
+class SlotValue<T, false> {
+public:
+    explicit SlotValue(const T& value) : value(std::make_shared<const T>(value)) {}
+    T load() const { return *std::atomic_load(&value); }
+    void store(const T& next) { std::atomic_store(&value, std::make_shared<const T>(next)); }
+
+private:
+    std::shared_ptr<const T> value;
+};
+
+// One resolved key. refresh() and the subscriber list are only used with
+// the handler's mutex held; the value is read from any thread.
+class SlotBase {
+public:
+    explicit SlotBase(nlohmann::json::json_pointer pointer) : pointer(std::move(pointer)) {}
+    virtual ~SlotBase() = default;
+
+    // Takes the value at the pointer from a new snapshot. Returns whether
+    // it changed, adding the subscriber calls to make if so.
+    virtual bool refresh(const nlohmann::json& snapshot, std::vector<std::function<void()>>& notifications) = 0;
+    virtual bool removeSubscriber(uint64_t id) = 0;
+
+    const nlohmann::json::json_pointer pointer;
+};
+
+template<typename T>
+class TypedSlot : public SlotBase {
+public:
+    TypedSlot(nlohmann::json::json_pointer pointer, const T& defaultValue)
+        : SlotBase(std::move(pointer)), defaultValue(defaultValue), value(defaultValue), resolved(false) {}
+
+    T load() const { return value.load(); }
+
+    bool refresh(const nlohmann::json& snapshot, std::vector<std::function<void()>>& notifications) override {
+        nlohmann::json current;  // null when missing
+        if (snapshot.contains(pointer)) {
+            current = snapshot.at(pointer);
+        }
+        if (resolved && current == source) {
+            return false;
+        }
+        source = std::move(current);
+        resolved = true;
+
+        // Values of the wrong type read as the default, like getSetting()
+        T next = defaultValue;
+        if (!source.is_null()) {
+            try {
+                next = source.template get<T>();
+            } catch (const std::exception&) {
+                next = defaultValue;
+            }
+        }
+        value.store(next);
+
+        for (const auto& subscriber : subscribers) {
+            const std::function<void(const T&)>& callback = subscriber.second;
+            notifications.push_back([callback, next]() { callback(next); });
+        }
+        return true;
+    }
+
+    void addSubscriber(uint64_t id, std::function<void(const T&)> callback) {
+        subscribers.emplace_back(id, std::move(callback));
+    }
+
+    bool removeSubscriber(uint64_t id) override {
+        for (auto it = subscribers.begin(); it != subscribers.end(); ++it) {
+            if (it->first == id) {
+                subscribers.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    const T defaultValue;
+    SlotValue<T> value;
+    nlohmann::json source;  // JSON the value was converted from
+    bool resolved;
+    std::vector<std::pair<uint64_t, std::function<void(const T&)>>> subscribers;
+};
+
+} // namespace settings_detail
@@ -1,23 +1,187 @@
 #include "settings_handler.h"
+#include "file_watcher.h"
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <filesystem>
+#include <iterator>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Writes contents next to path, forces them to disk and renames over
+// path, so readers and crashes only ever see a complete file
+bool writeFileAtomically(const std::string& path, const std::string& contents) {
+    const std::string tempPath = path + ".tmp";
+    
+#ifdef _WIN32
+    const int fd = _open(tempPath.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    const int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+    if (fd < 0) {
+        std::cerr << "Failed to open settings file for writing: " << tempPath << std::endl;
+        return false;
+    }
+    
+    bool ok = true;
+    size_t written = 0;
+    while (ok && written < contents.size()) {
+#ifdef _WIN32
+        const int result = _write(fd, contents.data() + written, static_cast<unsigned int>(contents.size() - written));
+#else
+        const ssize_t result = ::write(fd, contents.data() + written, contents.size() - written);
+#endif
+        if (result < 0) {
+            ok = false;
+        } else {
+            written += static_cast<size_t>(result);
+        }
+    }
+#ifdef _WIN32
+    ok = ok && _commit(fd) == 0;
+    ok = _close(fd) == 0 && ok;
+#else
+    ok = ok && ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+#endif
+    
+    std::error_code error;
+    if (ok) {
+        std::filesystem::rename(tempPath, path, error);
+    }
+    if (!ok || error) {
+        std::cerr << "Failed to write settings file: " << path << std::endl;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    
+#ifndef _WIN32
+    // Make the rename itself durable
+    const std::string directory = std::filesystem::path(path).parent_path().string();
+    const int directoryFd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (directoryFd >= 0) {
+        ::fsync(directoryFd);
+        ::close(directoryFd);
+    }
+#endif
+    return true;
+}
+
+// Applies a patch from nlohmann::json::diff() to settings that may have
+// changed since: values are set whether or not their path still holds the
+// old value, and removals of paths that are already gone are skipped
+void applyDiff(nlohmann::json& target, const nlohmann::json& patch) {
+    for (const auto& operation : patch) {
+        const nlohmann::json::json_pointer pointer(operation["path"].get<std::string>());
+        try {
+            if (operation["op"] != "remove") {
+                target[pointer] = operation["value"];
+            } else if (!pointer.empty() && target.contains(pointer)) {
+                nlohmann::json& parent = target[pointer.parent_pointer()];
+                if (parent.is_array()) {
+                    parent.erase(std::stoul(pointer.back()));
+                } else {
+                    parent.erase(pointer.back());
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to apply settings change at " << pointer.to_string() << ": " << e.what() << std::endl;
+        }
+    }
+}
+
+bool readFile(const std::string& path, std::string& contents) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    // One read into a buffer of the file's size
+    const std::streamoff size = file.tellg();
+    if (size < 0) {
+        return false;
+    }
+    contents.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    file.read(&contents[0], size);
+    contents.resize(static_cast<size_t>(file.gcount()));
+    return !file.bad();
+}
+
+// FNV-1a over 8-byte words, then the remaining bytes. Sidecars outlive
+// builds, and std::hash may differ between them.
+uint64_t contentHash(const std::string& contents) {
+    const uint64_t prime = 1099511628211ull;
+    uint64_t hash = 14695981039346656037ull;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= contents.size(); i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, contents.data() + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+    }
+    for (; i < contents.size(); ++i) {
+        hash = (hash ^ static_cast<unsigned char>(contents[i])) * prime;
+    }
+    return hash;
+}
+
+// Hashes of writes the watcher has not reported yet; more than a few
+// means those writes failed or their events were lost
+const size_t RECENT_WRITE_LIMIT = 8;
+
+std::atomic<uint64_t> nextInstanceId(1);
+
+} // namespace
 
 SettingsHandler::SettingsHandler(const std::string& appName) 
-    : applicationName(appName) {
+    : applicationName(appName)
+    , settings(std::make_shared<const nlohmann::json>(nlohmann::json::object()))
+    , settingsVersion(0)
+    , instanceId(nextInstanceId.fetch_add(1))
+    , saveDelay(250)
+    , dirty(false)
+    , flushRequested(false)
+    , stopping(false)
+    , changeGeneration(0)
+    , savedGeneration(0)
+    , lastWriteSucceeded(true)
+    , writeCount(0)
+    , nextSubscriptionId(1)
+    , fileBaseline(settings)
+    , reloadCount(0) {
     platformPath = PlatformPath::create();
     
     // Determine settings file path
     std::string settingsDir = platformPath->getSettingsDirectory(applicationName);
     settingsFilePath = settingsDir + "/settings.json";
+    sidecarFilePath = settingsDir + "/settings.cbor";
     
     // Load existing settings
     loadSettings();
+    
+    writerThread = std::thread(&SettingsHandler::writerLoop, this);
 }
 
 SettingsHandler::~SettingsHandler() {
-    // Auto-save settings on destruction
-    saveSettings();
+    stopWatching();
+    
+    // Write pending changes before the writer goes away
+    flush();
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    writerCondition.notify_one();
+    writerThread.join();
 }
 
 bool SettingsHandler::loadSettings() {
@@ -26,18 +190,268 @@ bool SettingsHandler::loadSettings() {
 }
 
 bool SettingsHandler::saveSettings() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        markDirty();
+    }
+    return flush();
+}
+
+void SettingsHandler::setSaveDelay(std::chrono::milliseconds delay) {
+    std::lock_guard<std::mutex> lock(mutex);
+    saveDelay = delay;
+}
+
+bool SettingsHandler::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    const uint64_t target = changeGeneration;
+    if (savedGeneration >= target) {
+        return lastWriteSucceeded;
+    }
+    
+    // Skip the rest of the save delay; a write already in progress is
+    // simply waited for
+    if (dirty) {
+        flushRequested = true;
+        writerCondition.notify_one();
+    }
+    flushCondition.wait(lock, [this, target] { return savedGeneration >= target; });
+    return lastWriteSucceeded;
+}
+
+std::shared_ptr<const nlohmann::json> SettingsHandler::getSnapshot() const {
+    struct Cache {
+        uint64_t instanceId = 0;
+        uint64_t version = 0;
+        std::shared_ptr<const nlohmann::json> snapshot;
+    };
+    thread_local Cache cache;
+    
+    // The snapshot is stored before the version is bumped, so a matching
+    // version means the cached snapshot is current
+    const uint64_t version = settingsVersion.load(std::memory_order_acquire);
+    if (cache.instanceId != instanceId || cache.version != version || !cache.snapshot) {
+        cache.snapshot = std::atomic_load(&settings);
+        cache.instanceId = instanceId;
+        cache.version = version;
+    }
+    return cache.snapshot;
+}
+
+void SettingsHandler::updateSettings(const std::function<void(nlohmann::json&)>& edit) {
+    std::vector<std::function<void()>> notifications;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        nlohmann::json edited = *settings;
+        edit(edited);
+        publish(std::move(edited), notifications);
+        markDirty();
+    }
+    
+    // Outside the lock, so subscribers may read and change settings
+    for (const auto& notify : notifications) {
+        notify();
+    }
+}
+
+void SettingsHandler::publish(nlohmann::json&& next, std::vector<std::function<void()>>& notifications) {
+    std::atomic_store(&settings, std::make_shared<const nlohmann::json>(std::move(next)));
+    settingsVersion.fetch_add(1, std::memory_order_release);
+    
+    for (const auto& entry : slots) {
+        entry.second->refresh(*settings, notifications);
+    }
+}
+
+void SettingsHandler::unsubscribe(uint64_t subscriptionId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& entry : slots) {
+        if (entry.second->removeSubscriber(subscriptionId)) {
+            return;
+        }
+    }
+}
+
+uint64_t SettingsHandler::getWriteCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return writeCount;
+}
+
+bool SettingsHandler::startWatching() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fileWatcher) {
+        return true;
+    }
+    
+    std::unique_ptr<FileWatcher> watcher = FileWatcher::create();
+    if (!watcher->start([this](const std::string& path) { onFileChanged(path); })) {
+        return false;
+    }
+    bool watching = watcher->addFile(settingsFilePath);
+    for (const auto& entry : importBaselines) {
+        watching = watcher->addFile(entry.first) && watching;
+    }
+    if (!watching) {
+        return false;
+    }
+    fileWatcher = std::move(watcher);
+    return true;
+}
+
+void SettingsHandler::stopWatching() {
+    // Stopped without the lock, which a running reload may be waiting for
+    std::unique_ptr<FileWatcher> watcher;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        watcher = std::move(fileWatcher);
+        recentWriteHashes.clear();
+    }
+    if (watcher) {
+        watcher->stop();
+    }
+}
+
+uint64_t SettingsHandler::getReloadCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return reloadCount;
+}
+
+void SettingsHandler::onFileChanged(const std::string& path) {
+    std::string contents;
+    if (!readFile(path, contents)) {
+        return;  // Removed again, or not readable yet
+    }
+    
+    const bool isSettingsFile = path == settingsFilePath;
+    if (isSettingsFile) {
+        const size_t hash = std::hash<std::string>{}(contents);
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto written = std::find(recentWriteHashes.rbegin(), recentWriteHashes.rend(), hash);
+        if (written != recentWriteHashes.rend()) {
+            // Our write, and the file is past every write before it, so
+            // none of them can be reported any more. An external edit that
+            // restores an earlier state then no longer looks like ours.
+            recentWriteHashes.erase(recentWriteHashes.begin(), written.base());
+            return;
+        }
+    }
+    
+    nlohmann::json changed;
+    try {
+        changed = nlohmann::json::parse(contents);
+    } catch (const std::exception& e) {
+        std::cerr << "Ignoring invalid settings file " << path << ": " << e.what() << std::endl;
+        return;
+    }
+    
+    std::vector<std::function<void()>> notifications;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        nlohmann::json patch;
+        if (isSettingsFile) {
+            patch = nlohmann::json::diff(*fileBaseline, changed);
+            fileBaseline = std::make_shared<const nlohmann::json>(std::move(changed));
+        } else {
+            nlohmann::json& baseline = importBaselines[path];
+            patch = nlohmann::json::diff(baseline, changed);
+            baseline = std::move(changed);
+        }
+        if (patch.empty()) {
+            return;
+        }
+        
+        nlohmann::json edited = *settings;
+        applyDiff(edited, patch);
+        ++reloadCount;
+        publish(std::move(edited), notifications);
+        
+        // settings.json already holds the edit; imports are merged into it
+        if (!isSettingsFile) {
+            markDirty();
+        }
+    }
+    for (const auto& notify : notifications) {
+        notify();
+    }
+}
+
+void SettingsHandler::markDirty() {
+    dirty = true;
+    ++changeGeneration;
+    writerCondition.notify_one();
+}
+
+void SettingsHandler::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        writerCondition.wait(lock, [this] { return dirty || stopping; });
+        if (!dirty) {
+            break;
+        }
+        
+        // Collect the changes that follow within the save delay
+        writerCondition.wait_for(lock, saveDelay, [this] { return flushRequested || stopping; });
+        
+        const std::shared_ptr<const nlohmann::json> snapshot = settings;
+        const uint64_t generation = changeGeneration;
+        dirty = false;
+        flushRequested = false;
+        
+        // Serialize and write without blocking the setters
+        lock.unlock();
+        const bool written = writeSettingsFile(snapshot);
+        lock.lock();
+        
+        savedGeneration = generation;
+        lastWriteSucceeded = written;
+        if (written) {
+            ++writeCount;
+        }
+        flushCondition.notify_all();
+    }
+}
+
+bool SettingsHandler::writeSettingsFile(const std::shared_ptr<const nlohmann::json>& snapshot) {
     ensureSettingsDirectory();
     
     try {
-        std::ofstream file(settingsFilePath);
-        if (!file.is_open()) {
-            std::cerr << "Failed to open settings file for writing: " << settingsFilePath << std::endl;
+        const std::string contents = snapshot->dump(4); // Pretty print with 4-space indentation
+        {
+            // Recorded before the rename, which the watcher may report
+            // right away. Without a watcher nobody would consume the hash.
+            std::lock_guard<std::mutex> lock(mutex);
+            if (fileWatcher) {
+                recentWriteHashes.push_back(std::hash<std::string>{}(contents));
+                if (recentWriteHashes.size() > RECENT_WRITE_LIMIT) {
+                    recentWriteHashes.pop_front();
+                }
+            }
+            fileBaseline = snapshot;
+        }
+        if (!writeFileAtomically(settingsFilePath, contents)) {
             return false;
         }
         
-        file << settings.dump(4); // Pretty print with 4-space indentation
-        file.close();
-        
+        // Written second, with the fingerprint of the JSON it mirrors, so it
+        // is only used while settings.json is exactly that file. A failed
+        // sidecar only costs load time, but a stale one must go.
+        std::error_code error;
+        const auto jsonTime = std::filesystem::last_write_time(settingsFilePath, error);
+        std::string binary;
+        if (!error) {
+            nlohmann::json sidecar = {
+                {"json", {
+                    {"size", contents.size()},
+                    {"mtime", static_cast<int64_t>(jsonTime.time_since_epoch().count())},
+                    {"hash", contentHash(contents)}
+                }}
+            };
+            sidecar["settings"] = *snapshot;
+            nlohmann::json::to_cbor(sidecar, binary);
+        }
+        if (binary.empty() || !writeFileAtomically(sidecarFilePath, binary)) {
+            std::filesystem::remove(sidecarFilePath, error);
+        }
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Failed to save settings: " << e.what() << std::endl;
@@ -53,26 +467,74 @@ void SettingsHandler::ensureSettingsDirectory() {
 }
 
 bool SettingsHandler::loadSettingsFromFile() {
-    if (!platformPath->fileExists(settingsFilePath)) {
-        // File doesn't exist, start with empty settings
-        settings = nlohmann::json::object();
-        return true;
+    nlohmann::json loadedSettings = nlohmann::json::object();
+    bool loaded = true;
+    
+    // A missing file means empty settings
+    if (loadSidecar(loadedSettings)) {
+        // Up to date with settings.json
+    } else if (platformPath->fileExists(settingsFilePath)) {
+        try {
+            std::ifstream file(settingsFilePath);
+            if (!file.is_open()) {
+                std::cerr << "Failed to open settings file: " << settingsFilePath << std::endl;
+                return false;
+            }
+            
+            file >> loadedSettings;
+            file.close();
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to load settings: " << e.what() << std::endl;
+            loadedSettings = nlohmann::json::object();
+            loaded = false;
+        }
     }
     
+    std::vector<std::function<void()>> notifications;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        publish(std::move(loadedSettings), notifications);
+        fileBaseline = settings;
+    }
+    for (const auto& notify : notifications) {
+        notify();
+    }
+    return loaded;
+}
+
+bool SettingsHandler::loadSidecar(nlohmann::json& loaded) const {
+    std::string contents;
+    if (!readFile(sidecarFilePath, contents)) {
+        return false;
+    }
     try {
-        std::ifstream file(settingsFilePath);
-        if (!file.is_open()) {
-            std::cerr << "Failed to open settings file: " << settingsFilePath << std::endl;
+        nlohmann::json sidecar = nlohmann::json::from_cbor(contents);
+        const auto fingerprint = sidecar.find("json");
+        const auto sidecarSettings = sidecar.find("settings");
+        if (fingerprint == sidecar.end() || !fingerprint->is_object() || sidecarSettings == sidecar.end()) {
             return false;
         }
         
-        file >> settings;
-        file.close();
+        // Only while settings.json is the file it was written with: size
+        // and mtime rule out most edits cheaply, the hash the rest
+        std::error_code error;
+        const auto jsonSize = std::filesystem::file_size(settingsFilePath, error);
+        if (error || fingerprint->value("size", uint64_t(0)) != jsonSize) {
+            return false;
+        }
+        const auto jsonTime = std::filesystem::last_write_time(settingsFilePath, error);
+        if (error || fingerprint->value("mtime", int64_t(0)) != static_cast<int64_t>(jsonTime.time_since_epoch().count())) {
+            return false;
+        }
+        std::string json;
+        if (!readFile(settingsFilePath, json) || fingerprint->value("hash", uint64_t(0)) != contentHash(json)) {
+            return false;
+        }
         
+        loaded = std::move(*sidecarSettings);
         return true;
     } catch (const std::exception& e) {
-        std::cerr << "Failed to load settings: " << e.what() << std::endl;
-        settings = nlohmann::json::object();
+        std::cerr << "Ignoring invalid settings sidecar: " << e.what() << std::endl;
         return false;
     }
 }
@@ -113,23 +575,31 @@ void SettingsHandler::setBool(const std::string& key, bool value) {
 
 // Settings management
 bool SettingsHandler::hasSetting(const std::string& key) const {
-    return settings.contains(key);
+    return getSnapshot()->contains(key);
 }
 
 void SettingsHandler::removeSetting(const std::string& key) {
-    if (settings.contains(key)) {
-        settings.erase(key);
+    if (hasSetting(key)) {
+        updateSettings([&key](nlohmann::json& edited) {
+            edited.erase(key);
+        });
     }
 }
 
 void SettingsHandler::clearAllSettings() {
-    settings.clear();
+    updateSettings([](nlohmann::json& edited) {
+        edited.clear();
+    });
 }
 
 std::string SettingsHandler::getSettingsFilePath() const {
     return settingsFilePath;
 }
 
+std::string SettingsHandler::getSidecarFilePath() const {
+    return sidecarFilePath;
+}
+
 // Export/Import functionality
 bool SettingsHandler::exportSettings(const std::string& filePath) const {
     try {
@@ -139,7 +609,7 @@ bool SettingsHandler::exportSettings(const std::string& filePath) const {
             return false;
         }
         
-        file << settings.dump(4);
+        file << getSnapshot()->dump(4);
         file.close();
         
         return true;
@@ -162,7 +632,18 @@ bool SettingsHandler::importSettings(const std::string& filePath) {
         file.close();
         
         // Merge imported settings with existing ones
-        settings.update(importedSettings);
+        updateSettings([&importedSettings](nlohmann::json& edited) {
+            edited.update(importedSettings);
+        });
+        
+        // Later edits of the file are merged too while watching
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            importBaselines[filePath] = std::move(importedSettings);
+            if (fileWatcher) {
+                fileWatcher->addFile(filePath);
+            }
+        }
         
         // Save the merged settings
         return saveSettings();
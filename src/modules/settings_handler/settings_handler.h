@@ -2,29 +2,145 @@
 
 #include <string>
 #include <memory>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <map>
+#include <thread>
+#include <typeindex>
+#include <vector>
 #include <nlohmann/json.hpp>
+#include "setting_key.h"
 
+class FileWatcher;
 class PlatformPath;
+class SettingsHandler;
+
+// Handle to a bound SettingKey. get() reads the slot directly, without
+// looking the key up, so it is cheap enough for every frame. Valid for the
+// lifetime of the handler that created it.
+template<typename T>
+class Setting {
+public:
+    Setting() = default;
+    
+    T get() const { return slot->load(); }
+    void set(const T& value);
+    
+    // Called with the new value on the thread that made the change, after
+    // readers can see it. Returns an id for SettingsHandler::unsubscribe().
+    uint64_t subscribe(std::function<void(const T&)> callback);
+    
+private:
+    friend class SettingsHandler;
+    Setting(SettingsHandler* handler, settings_detail::TypedSlot<T>* slot) : handler(handler), slot(slot) {}
+    
+    SettingsHandler* handler = nullptr;
+    settings_detail::TypedSlot<T>* slot = nullptr;
+};
 
 class SettingsHandler {
 private:
     std::unique_ptr<PlatformPath> platformPath;
     std::string applicationName;
-    nlohmann::json settings;
     std::string settingsFilePath;
+    std::string sidecarFilePath;  // Binary (CBOR) copy of settings.json
+    
+    // Immutable snapshot of all settings. Writers build a changed copy and
+    // publish it with atomic_store under the mutex, then bump the version;
+    // readers revalidate a per-thread cached snapshot against the version,
+    // so a read without intervening changes takes no lock.
+    std::shared_ptr<const nlohmann::json> settings;
+    std::atomic<uint64_t> settingsVersion;
+    const uint64_t instanceId;  // Tells handlers apart in the reader cache
+    
+    // Write-behind persistence, writers and bound keys (guarded by mutex)
+    mutable std::mutex mutex;
+    std::condition_variable writerCondition;
+    std::condition_variable flushCondition;
+    std::thread writerThread;
+    std::chrono::milliseconds saveDelay;
+    bool dirty;
+    bool flushRequested;
+    bool stopping;
+    uint64_t changeGeneration;
+    uint64_t savedGeneration;   // Newest change a write was attempted for
+    bool lastWriteSucceeded;
+    uint64_t writeCount;
+    
+    // Slots of bound keys, by path and type. Every published snapshot
+    // refreshes them, and only slots whose value changed notify.
+    std::map<std::pair<std::string, std::type_index>, std::unique_ptr<settings_detail::SlotBase>> slots;
+    uint64_t nextSubscriptionId;
+    
+    // Hot reload (guarded by mutex). Each watched file keeps the JSON it
+    // held last, so an external edit applies as the difference to it.
+    std::unique_ptr<FileWatcher> fileWatcher;
+    std::shared_ptr<const nlohmann::json> fileBaseline;      // settings.json as last read or written
+    std::map<std::string, nlohmann::json> importBaselines;    // Imported files, by path
+    std::deque<size_t> recentWriteHashes;                    // Recognizes our own writes
+    uint64_t reloadCount;
+    
+    template<typename T> friend class Setting;
     
     void ensureSettingsDirectory();
     bool loadSettingsFromFile();
+    bool loadSidecar(nlohmann::json& loaded) const;
+    bool writeSettingsFile(const std::shared_ptr<const nlohmann::json>& snapshot);
+    void publish(nlohmann::json&& next, std::vector<std::function<void()>>& notifications);  // Caller holds mutex
+    void markDirty();  // Caller holds mutex
+    void writerLoop();
+    void onFileChanged(const std::string& path);
     
 public:
     SettingsHandler(const std::string& appName);
     ~SettingsHandler();
     
-    // Core functionality
+    // Core functionality. saveSettings() writes the current settings now
+    // and waits for the write. Every write also stores a CBOR sidecar,
+    // which loads several times faster than the JSON; loadSettings() uses
+    // it while settings.json still has the size, mtime and content hash
+    // recorded in it. The JSON stays the form to edit.
     bool loadSettings();
     bool saveSettings();
     
-    // Generic getters and setters
+    // Setters only mark the settings dirty. A background thread writes
+    // them at most once per save delay, collecting all changes made in
+    // between, and replaces the file atomically (temp file, fsync, rename)
+    // so a crash leaves either the old or the new settings. flush() writes
+    // pending changes and waits; the destructor calls it.
+    void setSaveDelay(std::chrono::milliseconds delay);
+    bool flush();
+    uint64_t getWriteCount() const;
+    
+    // Hot reload. While watching, edits other programs save to the settings
+    // file or to imported files are applied live: only keys that differ from
+    // the file's previous contents change, so unsaved changes made here
+    // survive, and only subscribers of changed keys are notified (on the
+    // watcher's thread). Uses inotify; fails on platforms other than Linux.
+    bool startWatching();
+    void stopWatching();
+    uint64_t getReloadCount() const;
+    
+    // Consistent view of all settings, safe to use from any thread and
+    // unaffected by later changes
+    std::shared_ptr<const nlohmann::json> getSnapshot() const;
+    
+    // Applies several changes as one copy-on-write update, which readers
+    // see either completely or not at all. If edit throws, nothing changes.
+    void updateSettings(const std::function<void(nlohmann::json&)>& edit);
+    
+    // Typed keys. bind() looks the key up once; binding the same path and
+    // type again returns the same slot (and keeps the first default).
+    template<typename T>
+    Setting<T> bind(const SettingKey<T>& key);
+    void unsubscribe(uint64_t subscriptionId);
+    
+    // Generic getters and setters, safe to call from any thread
     template<typename T>
     T getSetting(const std::string& key, const T& defaultValue = T{}) const;
     
@@ -50,6 +166,7 @@ public:
     
     // File path information
     std::string getSettingsFilePath() const;
+    std::string getSidecarFilePath() const;
     
     // Export/Import functionality
     bool exportSettings(const std::string& filePath) const;
@@ -72,9 +189,11 @@ public:
 // Template implementations must be in header
 template<typename T>
 T SettingsHandler::getSetting(const std::string& key, const T& defaultValue) const {
-    if (settings.contains(key)) {
+    const std::shared_ptr<const nlohmann::json> current = getSnapshot();
+    const auto it = current->find(key);
+    if (it != current->end()) {
         try {
-            return settings[key].get<T>();
+            return it->template get<T>();
         } catch (const std::exception&) {
             return defaultValue;
         }
@@ -84,5 +203,38 @@ T SettingsHandler::getSetting(const std::string& key, const T& defaultValue) con
 
 template<typename T>
 void SettingsHandler::setSetting(const std::string& key, const T& value) {
-    settings[key] = value;
+    updateSettings([&key, &value](nlohmann::json& edited) {
+        edited[key] = value;
+    });
+}
+
+template<typename T>
+Setting<T> SettingsHandler::bind(const SettingKey<T>& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<settings_detail::SlotBase>& slot = slots[{key.path, std::type_index(typeid(T))}];
+    if (!slot) {
+        const nlohmann::json::json_pointer pointer = !key.path.empty() && key.path[0] == '/' ?
+            nlohmann::json::json_pointer(key.path) : nlohmann::json::json_pointer() / key.path;
+        auto typedSlot = std::make_unique<settings_detail::TypedSlot<T>>(pointer, key.defaultValue);
+        std::vector<std::function<void()>> notifications;  // No subscribers yet
+        typedSlot->refresh(*settings, notifications);
+        slot = std::move(typedSlot);
+    }
+    return Setting<T>(this, static_cast<settings_detail::TypedSlot<T>*>(slot.get()));
+}
+
+template<typename T>
+void Setting<T>::set(const T& value) {
+    const nlohmann::json::json_pointer& pointer = slot->pointer;
+    handler->updateSettings([&pointer, &value](nlohmann::json& edited) {
+        edited[pointer] = value;
+    });
+}
+
+template<typename T>
+uint64_t Setting<T>::subscribe(std::function<void(const T&)> callback) {
+    std::lock_guard<std::mutex> lock(handler->mutex);
+    const uint64_t id = handler->nextSubscriptionId++;
+    slot->addSubscriber(id, std::move(callback));
+    return id;
 }
\ No newline at end of file
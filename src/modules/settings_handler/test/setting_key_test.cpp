@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include "settings_test_fixture.h"
+#include <memory>
+#include <vector>
+
+namespace {
+
+const SettingKey<int> FPS_LIMIT_KEY("/view/fps_limit", 60);
+const SettingKey<std::string> THEME_KEY("/view/theme", "light");
+const SettingKey<double> SAMPLE_RATE_KEY("sample_rate", 1000.0);
+const SettingKey<bool> GRID_KEY("show_grid", true);
+
+} // namespace
+
+class SettingKeyTest : public SettingsHandlerFixture {};
+
+TEST_F(SettingKeyTest, DefaultsUntilSet) {
+    const Setting<int> fpsLimit = settings->bind(FPS_LIMIT_KEY);
+    const Setting<std::string> theme = settings->bind(THEME_KEY);
+    EXPECT_EQ(fpsLimit.get(), 60);
+    EXPECT_EQ(theme.get(), "light");
+    EXPECT_TRUE(settings->bind(GRID_KEY).get());
+}
+
+TEST_F(SettingKeyTest, NestedPathsGroupSettings) {
+    Setting<int> fpsLimit = settings->bind(FPS_LIMIT_KEY);
+    Setting<std::string> theme = settings->bind(THEME_KEY);
+    fpsLimit.set(144);
+    theme.set("dark");
+
+    EXPECT_EQ(fpsLimit.get(), 144);
+    EXPECT_EQ(theme.get(), "dark");
+
+    const std::shared_ptr<const nlohmann::json> snapshot = settings->getSnapshot();
+    EXPECT_EQ((*snapshot)["view"]["fps_limit"].get<int>(), 144);
+    EXPECT_EQ((*snapshot)["view"]["theme"].get<std::string>(), "dark");
+}
+
+TEST_F(SettingKeyTest, SlotsFollowStringKeyedChanges) {
+    const Setting<double> sampleRate = settings->bind(SAMPLE_RATE_KEY);
+    settings->setDouble("sample_rate", 250.0);
+    EXPECT_DOUBLE_EQ(sampleRate.get(), 250.0);
+
+    // Wrong types and removal fall back to the default
+    settings->setString("sample_rate", "fast");
+    EXPECT_DOUBLE_EQ(sampleRate.get(), 1000.0);
+    settings->setDouble("sample_rate", 500.0);
+    settings->removeSetting("sample_rate");
+    EXPECT_DOUBLE_EQ(sampleRate.get(), 1000.0);
+}
+
+TEST_F(SettingKeyTest, BindingTwiceSharesTheSlot) {
+    Setting<int> first = settings->bind(FPS_LIMIT_KEY);
+    const Setting<int> second = settings->bind(SettingKey<int>("/view/fps_limit", 30));
+    first.set(75);
+    EXPECT_EQ(second.get(), 75);
+}
+
+TEST_F(SettingKeyTest, OnlyAffectedSubscribersAreNotified) {
+    Setting<int> fpsLimit = settings->bind(FPS_LIMIT_KEY);
+    Setting<std::string> theme = settings->bind(THEME_KEY);
+
+    std::vector<int> fpsChanges;
+    int themeChanges = 0;
+    const uint64_t fpsSubscription = fpsLimit.subscribe([&fpsChanges](const int& value) {
+        fpsChanges.push_back(value);
+    });
+    theme.subscribe([&themeChanges](const std::string&) {
+        ++themeChanges;
+    });
+
+    fpsLimit.set(120);
+    fpsLimit.set(120);  // Unchanged, no notification
+    settings->setInt("unrelated", 1);
+    fpsLimit.set(90);
+    EXPECT_EQ(fpsChanges, (std::vector<int>{120, 90}));
+    EXPECT_EQ(themeChanges, 0);
+
+    settings->unsubscribe(fpsSubscription);
+    fpsLimit.set(30);
+    EXPECT_EQ(fpsChanges.size(), 2u);
+}
+
+TEST_F(SettingKeyTest, SubscribersMayChangeSettings) {
+    Setting<int> fpsLimit = settings->bind(FPS_LIMIT_KEY);
+    Setting<bool> grid = settings->bind(GRID_KEY);
+    fpsLimit.subscribe([&grid](const int& value) {
+        grid.set(value >= 60);
+    });
+
+    fpsLimit.set(30);
+    EXPECT_FALSE(grid.get());
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include "settings_test_fixture.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class SettingsHandlerConcurrencyTest : public SettingsHandlerFixture {};
+
+TEST_F(SettingsHandlerConcurrencyTest, SnapshotsDoNotChange) {
+    settings->setInt("rate", 100);
+    const std::shared_ptr<const nlohmann::json> before = settings->getSnapshot();
+
+    settings->setInt("rate", 200);
+    EXPECT_EQ((*before)["rate"].get<int>(), 100);
+    EXPECT_EQ(settings->getInt("rate"), 200);
+
+    // Without changes the same snapshot is handed out again
+    EXPECT_EQ(settings->getSnapshot(), settings->getSnapshot());
+}
+
+TEST_F(SettingsHandlerConcurrencyTest, BatchesAreSeenWhole) {
+    settings->updateSettings([](nlohmann::json& edited) {
+        edited["port"] = 8080;
+        edited["host"] = "localhost";
+    });
+    EXPECT_EQ(settings->getInt("port"), 8080);
+    EXPECT_EQ(settings->getString("host"), "localhost");
+
+    // A failing batch leaves everything as it was
+    EXPECT_THROW(settings->updateSettings([](nlohmann::json& edited) {
+        edited["port"] = 9090;
+        throw std::runtime_error("rejected");
+    }), std::runtime_error);
+    EXPECT_EQ(settings->getInt("port"), 8080);
+}
+
+TEST_F(SettingsHandlerConcurrencyTest, ReadersAndWritersStress) {
+    const int readerCount = 4;
+    const int writerCount = 2;
+    const int updatesPerWriter = 2000;
+    settings->setSaveDelay(std::chrono::milliseconds(5));
+    settings->updateSettings([](nlohmann::json& edited) {
+        edited["filter_low"] = 0;
+        edited["filter_high"] = 0;
+    });
+
+    std::atomic<bool> done(false);
+    std::atomic<int> tornReads(0);
+    std::atomic<int> backwardReads(0);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < readerCount; ++r) {
+        readers.emplace_back([&]() {
+            int last = 0;
+            while (!done.load()) {
+                // Both filter ends change in one batch, so a snapshot
+                // always holds a matching pair
+                const std::shared_ptr<const nlohmann::json> snapshot = settings->getSnapshot();
+                const int low = (*snapshot)["filter_low"].get<int>();
+                const int high = (*snapshot)["filter_high"].get<int>();
+                if (high != low * 2) {
+                    ++tornReads;
+                }
+
+                // Versions only move forward
+                const int count = settings->getInt("update_count");
+                if (count < last) {
+                    ++backwardReads;
+                }
+                last = count;
+            }
+        });
+    }
+
+    std::atomic<int> updateCount(0);
+    std::vector<std::thread> writers;
+    for (int w = 0; w < writerCount; ++w) {
+        writers.emplace_back([&, w]() {
+            for (int i = 1; i <= updatesPerWriter; ++i) {
+                const int value = w * updatesPerWriter + i;
+                settings->updateSettings([&](nlohmann::json& edited) {
+                    edited["filter_low"] = value;
+                    edited["filter_high"] = value * 2;
+                    edited["update_count"] = ++updateCount;
+                });
+                settings->setInt("writer_" + std::to_string(w), i);
+            }
+        });
+    }
+
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(tornReads.load(), 0);
+    EXPECT_EQ(backwardReads.load(), 0);
+    EXPECT_EQ(settings->getInt("update_count"), writerCount * updatesPerWriter);
+    for (int w = 0; w < writerCount; ++w) {
+        EXPECT_EQ(settings->getInt("writer_" + std::to_string(w)), updatesPerWriter);
+    }
+    EXPECT_TRUE(settings->flush());
+}
@@ -3,6 +3,7 @@
 #include <filesystem>
 #include <fstream>
 #include <memory>
+#include <nlohmann/json.hpp>
 
 class SettingsHandlerTest : public ::testing::Test {
 protected:
@@ -18,11 +19,13 @@ protected:
         // Clean up test files
         if (settings) {
             std::string filePath = settings->getSettingsFilePath();
+            std::string sidecarPath = settings->getSidecarFilePath();
             settings.reset(); // Destroy settings handler first
             
-            // Remove the test settings file and directory
+            // Remove the test settings files and directory
             if (std::filesystem::exists(filePath)) {
                 std::filesystem::remove(filePath);
+                std::filesystem::remove(sidecarPath);
                 
                 // Try to remove the directory (will only succeed if empty)
                 std::filesystem::path dir = std::filesystem::path(filePath).parent_path();
@@ -235,4 +238,61 @@ TEST_F(SettingsHandlerTest, OverwriteSettings) {
     
     // Original string getter should return default now due to type mismatch
     EXPECT_EQ(settings->getString("overwrite_test", "default"), "default");
-}
\ No newline at end of file
+}
+
+TEST_F(SettingsHandlerTest, SettersDoNotWriteOnTheCallingThread) {
+    // Settle the write from SetUp, then hold back further writes
+    EXPECT_TRUE(settings->flush());
+    settings->setSaveDelay(std::chrono::seconds(10));
+    const uint64_t writesBefore = settings->getWriteCount();
+    
+    // Hammer the setters like camera and layout changes would
+    for (int i = 0; i < 10000; ++i) {
+        settings->setDouble("camera_azimuth", i * 0.01);
+        settings->setInt("layout_rows", i % 4);
+    }
+    EXPECT_EQ(settings->getWriteCount(), writesBefore);
+    
+    // flush() writes everything at once
+    EXPECT_TRUE(settings->flush());
+    EXPECT_EQ(settings->getWriteCount(), writesBefore + 1);
+    
+    std::ifstream file(settings->getSettingsFilePath());
+    nlohmann::json written;
+    file >> written;
+    EXPECT_DOUBLE_EQ(written["camera_azimuth"].get<double>(), 9999 * 0.01);
+    EXPECT_EQ(written["layout_rows"].get<int>(), 9999 % 4);
+}
+
+TEST_F(SettingsHandlerTest, BackgroundWritesCoalesceChanges) {
+    settings->setSaveDelay(std::chrono::milliseconds(20));
+    const uint64_t writesBefore = settings->getWriteCount();
+    
+    const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+    int changes = 0;
+    while (std::chrono::steady_clock::now() < end) {
+        settings->setInt("counter", ++changes);
+    }
+    EXPECT_TRUE(settings->flush());
+    
+    // At most one write per save delay, and no temp file left behind
+    const uint64_t writes = settings->getWriteCount() - writesBefore;
+    EXPECT_GE(writes, 1u);
+    EXPECT_LT(writes, 20u);
+    EXPECT_LT(writes, static_cast<uint64_t>(changes));
+    EXPECT_FALSE(std::filesystem::exists(settings->getSettingsFilePath() + ".tmp"));
+    
+    std::ifstream file(settings->getSettingsFilePath());
+    nlohmann::json written;
+    file >> written;
+    EXPECT_EQ(written["counter"].get<int>(), changes);
+}
+
+TEST_F(SettingsHandlerTest, PendingChangesAreWrittenOnDestruction) {
+    settings->setSaveDelay(std::chrono::seconds(10));
+    settings->setString("pending", "value");
+    
+    settings.reset();
+    settings = std::make_unique<SettingsHandler>(testAppName);
+    EXPECT_EQ(settings->getString("pending"), "value");
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include "settings_test_fixture.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+class SettingsSidecarTest : public SettingsHandlerFixture {
+protected:
+    static nlohmann::json readSidecar(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        const std::vector<uint8_t> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        return nlohmann::json::from_cbor(contents);
+    }
+
+    static void writeSidecar(const std::string& path, const nlohmann::json& sidecar) {
+        std::ofstream file(path, std::ios::binary);
+        const std::vector<uint8_t> contents = nlohmann::json::to_cbor(sidecar);
+        file.write(reinterpret_cast<const char*>(contents.data()), contents.size());
+    }
+
+    static std::string readText(const std::string& path) {
+        std::ifstream file(path);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // Rewrites settings.json and gives it back its modification time, as a
+    // quick edit within the file system's timestamp granularity would
+    void editKeepingMtime(const std::string& contents) {
+        const std::string path = settings->getSettingsFilePath();
+        const auto mtime = std::filesystem::last_write_time(path);
+        {
+            std::ofstream file(path);
+            file << contents;
+        }
+        std::filesystem::last_write_time(path, mtime);
+    }
+
+    // Dashboard sized settings (channel bindings with filter taps,
+    // colormaps and layout geometry), about minimumBytes as saved
+    static nlohmann::json makeLargeConfig(size_t minimumBytes) {
+        nlohmann::json config = nlohmann::json::object();
+        for (int i = 0; i < 32; ++i) {
+            nlohmann::json colormap = nlohmann::json::array();
+            for (int entry = 0; entry < 256; ++entry) {
+                colormap.push_back({entry / 255.0, 0.5 + entry / 1024.0, 1.0 - entry / 511.0});
+            }
+            config["colormaps"]["map_" + std::to_string(i)] = std::move(colormap);
+        }
+        int channel = 0;
+        while (channel % 64 != 0 || config.dump(4).size() < minimumBytes) {
+            nlohmann::json taps = nlohmann::json::array();
+            for (int tap = 0; tap < 64; ++tap) {
+                taps.push_back(1.0 / (tap + channel + 1));
+            }
+            nlohmann::json binding = {
+                {"name", "sensor_" + std::to_string(channel)},
+                {"source", "udp://10.0.0." + std::to_string(channel % 250) + ":5000"},
+                {"colormap", "map_" + std::to_string(channel % 32)},
+                {"filter", {{"type", "lowpass"}, {"cutoff", 12.5 + channel}, {"taps", std::move(taps)}}},
+                {"layout", {{"x", channel % 8 * 240}, {"y", channel / 8 * 180}, {"width", 240}, {"height", 180}}}
+            };
+            config["channels"].push_back(std::move(binding));
+            ++channel;
+        }
+        return config;
+    }
+};
+
+TEST_F(SettingsSidecarTest, WritesMirrorSettingsInSidecar) {
+    settings->setString("theme", "dark");
+    settings->setInt("fps_limit", 120);
+    ASSERT_TRUE(settings->flush());
+
+    ASSERT_TRUE(std::filesystem::exists(settings->getSidecarFilePath()));
+    const nlohmann::json sidecar = readSidecar(settings->getSidecarFilePath());
+    EXPECT_EQ(sidecar["settings"], *settings->getSnapshot());
+    EXPECT_EQ(sidecar["json"]["size"].get<uint64_t>(), std::filesystem::file_size(settings->getSettingsFilePath()));
+}
+
+TEST_F(SettingsSidecarTest, SidecarIsUsedWhileJsonIsUnchanged) {
+    settings->setInt("fps_limit", 120);
+    ASSERT_TRUE(settings->flush());
+
+    // Only the sidecar says 999, so loading it shows
+    nlohmann::json sidecar = readSidecar(settings->getSidecarFilePath());
+    sidecar["settings"]["fps_limit"] = 999;
+    writeSidecar(settings->getSidecarFilePath(), sidecar);
+
+    ASSERT_TRUE(settings->loadSettings());
+    EXPECT_EQ(settings->getInt("fps_limit"), 999);
+}
+
+TEST_F(SettingsSidecarTest, EditedJsonWinsOverSidecar) {
+    settings->setInt("fps_limit", 120);
+    ASSERT_TRUE(settings->flush());
+
+    const auto sidecarTime = std::filesystem::last_write_time(settings->getSidecarFilePath());
+    {
+        std::ofstream file(settings->getSettingsFilePath());
+        file << R"({"fps_limit": 30})";
+    }
+    std::filesystem::last_write_time(settings->getSettingsFilePath(), sidecarTime + std::chrono::seconds(1));
+
+    ASSERT_TRUE(settings->loadSettings());
+    EXPECT_EQ(settings->getInt("fps_limit"), 30);
+}
+
+TEST_F(SettingsSidecarTest, EditWithUnchangedMtimeWinsOverSidecar) {
+    settings->setInt("fps_limit", 120);
+    ASSERT_TRUE(settings->flush());
+
+    editKeepingMtime(R"({"fps_limit": 30})");
+    ASSERT_TRUE(settings->loadSettings());
+    EXPECT_EQ(settings->getInt("fps_limit"), 30);
+}
+
+TEST_F(SettingsSidecarTest, EditWithUnchangedSizeAndMtimeWinsOverSidecar) {
+    settings->setInt("fps_limit", 120);
+    ASSERT_TRUE(settings->flush());
+
+    std::string contents = readText(settings->getSettingsFilePath());
+    const size_t value = contents.find("120");
+    ASSERT_NE(value, std::string::npos);
+    contents.replace(value, 3, "130");
+    editKeepingMtime(contents);
+
+    ASSERT_TRUE(settings->loadSettings());
+    EXPECT_EQ(settings->getInt("fps_limit"), 130);
+}
+
+TEST_F(SettingsSidecarTest, InvalidSidecarFallsBackToJson) {
+    settings->setInt("fps_limit", 120);
+    ASSERT_TRUE(settings->flush());
+    {
+        std::ofstream file(settings->getSidecarFilePath(), std::ios::binary);
+        file << "\xff\xff";
+    }
+
+    ASSERT_TRUE(settings->loadSettings());
+    EXPECT_EQ(settings->getInt("fps_limit"), 120);
+}
+
+TEST_F(SettingsSidecarTest, ReportsLoadTimesForLargeConfig) {
+    const nlohmann::json config = makeLargeConfig(5 * 1024 * 1024);
+    settings->updateSettings([&config](nlohmann::json& edited) {
+        edited = config;
+    });
+    ASSERT_TRUE(settings->flush());
+
+    // Best of a few loads, so the file cache is warm for both forms
+    auto timeLoads = [this]() {
+        double best = 1e9;
+        for (int i = 0; i < 3; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            EXPECT_TRUE(settings->loadSettings());
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    };
+    const double sidecarMs = timeLoads();
+    EXPECT_EQ(*settings->getSnapshot(), config);
+
+    std::filesystem::remove(settings->getSidecarFilePath());
+    const double jsonMs = timeLoads();
+    EXPECT_EQ(*settings->getSnapshot(), config);
+
+    const auto jsonBytes = std::filesystem::file_size(settings->getSettingsFilePath());
+    std::cout << "Loaded " << jsonBytes << " byte settings.json in " << jsonMs << " ms, CBOR sidecar in "
+              << sidecarMs << " ms" << std::endl;
+    RecordProperty("jsonBytes", static_cast<int>(jsonBytes));
+    RecordProperty("jsonLoadMs", std::to_string(jsonMs));
+    RecordProperty("sidecarLoadMs", std::to_string(sidecarMs));
+}
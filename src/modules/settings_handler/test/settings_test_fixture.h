@@ -0,0 +1,31 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "../settings_handler.h"
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+// Empty settings under an app name of their own for every test. The
+// settings file, its sidecar and their directory are removed afterwards.
+class SettingsHandlerFixture : public ::testing::Test {
+protected:
+    void SetUp() override {
+        testAppName = "TestApp_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        settings = std::make_unique<SettingsHandler>(testAppName);
+        settings->clearAllSettings();
+    }
+
+    void TearDown() override {
+        const std::filesystem::path filePath = settings->getSettingsFilePath();
+        const std::filesystem::path sidecarPath = settings->getSidecarFilePath();
+        settings.reset();
+        std::filesystem::remove(filePath);
+        std::filesystem::remove(sidecarPath);
+        std::filesystem::remove(filePath.parent_path());
+    }
+
+    std::unique_ptr<SettingsHandler> settings;
+    std::string testAppName;
+};
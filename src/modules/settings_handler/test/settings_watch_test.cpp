@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include "settings_test_fixture.h"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+#ifdef __linux__
+
+class SettingsWatchTest : public SettingsHandlerFixture {
+protected:
+    void TearDown() override {
+        std::filesystem::remove(std::filesystem::path(settings->getSettingsFilePath()).parent_path() / "import.json");
+        SettingsHandlerFixture::TearDown();
+    }
+
+    // Saves a file the way an editor rewriting it in place would
+    static void editExternally(const std::string& path, const nlohmann::json& contents) {
+        std::ofstream file(path);
+        file << contents.dump(2);
+    }
+
+    bool waitForReloads(uint64_t count) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (settings->getReloadCount() < count) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return true;
+    }
+};
+
+TEST_F(SettingsWatchTest, ExternalEditsNotifyOnlyChangedKeys) {
+    settings->updateSettings([](nlohmann::json& edited) {
+        edited["fps_limit"] = 60;
+        edited["theme"] = "light";
+    });
+    ASSERT_TRUE(settings->flush());
+
+    Setting<int> fpsLimit = settings->bind(SettingKey<int>("fps_limit", 0));
+    Setting<std::string> theme = settings->bind(SettingKey<std::string>("theme", ""));
+    std::atomic<int> fpsNotified(0);
+    std::atomic<int> themeNotified(0);
+    fpsLimit.subscribe([&fpsNotified](const int&) { ++fpsNotified; });
+    theme.subscribe([&themeNotified](const std::string&) { ++themeNotified; });
+
+    ASSERT_TRUE(settings->startWatching());
+    editExternally(settings->getSettingsFilePath(), {{"fps_limit", 30}, {"theme", "light"}});
+    ASSERT_TRUE(waitForReloads(1));
+
+    EXPECT_EQ(fpsLimit.get(), 30);
+    EXPECT_EQ(fpsNotified.load(), 1);
+    EXPECT_EQ(themeNotified.load(), 0);
+}
+
+TEST_F(SettingsWatchTest, UnsavedChangesSurviveExternalEdits) {
+    settings->updateSettings([](nlohmann::json& edited) {
+        edited["filter_low"] = 1;
+        edited["filter_high"] = 10;
+    });
+    ASSERT_TRUE(settings->flush());
+    ASSERT_TRUE(settings->startWatching());
+
+    // Not written yet when the file changes
+    settings->setSaveDelay(std::chrono::seconds(10));
+    settings->setInt("filter_low", 2);
+    editExternally(settings->getSettingsFilePath(), {{"filter_low", 1}, {"filter_high", 50}});
+    ASSERT_TRUE(waitForReloads(1));
+
+    EXPECT_EQ(settings->getInt("filter_low"), 2);
+    EXPECT_EQ(settings->getInt("filter_high"), 50);
+}
+
+TEST_F(SettingsWatchTest, OwnWritesAreNotReloaded) {
+    ASSERT_TRUE(settings->startWatching());
+    settings->setSaveDelay(std::chrono::milliseconds(0));
+    for (int i = 1; i <= 20; ++i) {
+        settings->setInt("rate", i);
+        ASSERT_TRUE(settings->flush());
+    }
+
+    // Longer than the watcher takes to report the writes
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_EQ(settings->getReloadCount(), 0u);
+    EXPECT_EQ(settings->getInt("rate"), 20);
+}
+
+TEST_F(SettingsWatchTest, ExternalRevertToEarlierWriteIsApplied) {
+    ASSERT_TRUE(settings->startWatching());
+    settings->setSaveDelay(std::chrono::milliseconds(0));
+    settings->setInt("fps_limit", 30);
+    ASSERT_TRUE(settings->flush());
+    std::string firstContents;
+    {
+        std::ifstream file(settings->getSettingsFilePath());
+        firstContents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    settings->setInt("fps_limit", 60);
+    ASSERT_TRUE(settings->flush());
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    // Byte for byte what this handler wrote before
+    {
+        std::ofstream file(settings->getSettingsFilePath());
+        file << firstContents;
+    }
+    ASSERT_TRUE(waitForReloads(1));
+    EXPECT_EQ(settings->getInt("fps_limit"), 30);
+}
+
+TEST_F(SettingsWatchTest, ImportedFilesAreWatched) {
+    const std::string importPath = (std::filesystem::path(settings->getSettingsFilePath()).parent_path() / "import.json").string();
+    editExternally(importPath, {{"layout", {{"width", 800}, {"height", 600}}}});
+    ASSERT_TRUE(settings->importSettings(importPath));
+
+    Setting<int> width = settings->bind(SettingKey<int>("/layout/width", 0));
+    Setting<int> height = settings->bind(SettingKey<int>("/layout/height", 0));
+    std::atomic<int> heightNotified(0);
+    height.subscribe([&heightNotified](const int&) { ++heightNotified; });
+
+    ASSERT_TRUE(settings->startWatching());
+    editExternally(importPath, {{"layout", {{"width", 1024}, {"height", 600}}}});
+    ASSERT_TRUE(waitForReloads(1));
+
+    EXPECT_EQ(width.get(), 1024);
+    EXPECT_EQ(height.get(), 600);
+    EXPECT_EQ(heightNotified.load(), 0);
+
+    // The change is merged into the settings file
+    ASSERT_TRUE(settings->flush());
+    std::ifstream file(settings->getSettingsFilePath());
+    nlohmann::json saved;
+    file >> saved;
+    EXPECT_EQ(saved["layout"]["width"].get<int>(), 1024);
+}
+
+TEST_F(SettingsWatchTest, FileRewrittenFasterThanItSettlesIsReloaded) {
+    ASSERT_TRUE(settings->startWatching());
+
+    // A writer that never pauses long enough for the file to settle
+    std::atomic<bool> writing(true);
+    std::thread writer([this, &writing]() {
+        for (int i = 0; writing; ++i) {
+            editExternally(settings->getSettingsFilePath(), {{"counter", i}});
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    });
+
+    const bool reloaded = waitForReloads(1);
+    writing = false;
+    writer.join();
+    EXPECT_TRUE(reloaded);
+}
+
+#endif // __linux__
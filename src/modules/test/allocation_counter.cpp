@@ -0,0 +1,186 @@
+#include "allocation_counter.h"
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// With glibc, malloc and friends are replaced too, so allocations that
+// bypass operator new (Qt containers allocate through QArrayData with
+// ::malloc) are counted, including those made inside shared libraries.
+// Sanitizers bring their own malloc, so those builds count operator new
+// only.
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer) || __has_feature(memory_sanitizer)
+#define ALLOCATION_COUNTER_SANITIZED
+#endif
+#endif
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define ALLOCATION_COUNTER_SANITIZED
+#endif
+#if defined(__GLIBC__) && !defined(ALLOCATION_COUNTER_SANITIZED)
+#define ALLOCATION_COUNTER_MALLOC
+#endif
+
+namespace {
+
+// Plain thread-locals with constant initialization, safe to touch from
+// inside the allocator
+thread_local bool t_counting = false;
+thread_local uint64_t t_allocations = 0;
+
+inline void countAllocation()
+{
+    if (t_counting) {
+        ++t_allocations;
+    }
+}
+
+void* allocate(std::size_t size)
+{
+#ifndef ALLOCATION_COUNTER_MALLOC
+    countAllocation();
+#endif
+    void* pointer = std::malloc(size ? size : 1);
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment)
+{
+#ifndef ALLOCATION_COUNTER_MALLOC
+    countAllocation();
+#endif
+    // aligned_alloc wants the size to be a multiple of the alignment
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    const std::size_t rounded = ((size ? size : 1) + align - 1) / align * align;
+#ifdef _WIN32
+    void* pointer = _aligned_malloc(rounded, align);
+#else
+    void* pointer = std::aligned_alloc(align, rounded);
+#endif
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void freeAligned(void* pointer)
+{
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+} // namespace
+
+AllocationCounter::AllocationCounter()
+    : m_wasCounting(t_counting)
+    , m_start(t_allocations)
+{
+    t_counting = true;
+}
+
+AllocationCounter::~AllocationCounter()
+{
+    t_counting = m_wasCounting;
+}
+
+uint64_t AllocationCounter::count() const
+{
+    return t_allocations - m_start;
+}
+
+#ifdef ALLOCATION_COUNTER_MALLOC
+// glibc's own entry points; free() needs no replacement
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* pointer, std::size_t size);
+void* __libc_memalign(std::size_t alignment, std::size_t size);
+
+void* malloc(std::size_t size)
+{
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size)
+{
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, std::size_t size)
+{
+    // Growing may move the block; shrinking to nothing frees it
+    if (size) {
+        countAllocation();
+    }
+    return __libc_realloc(pointer, size);
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size)
+{
+    countAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+void* memalign(std::size_t alignment, std::size_t size)
+{
+    countAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pointer, std::size_t alignment, std::size_t size)
+{
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    countAllocation();
+    void* block = __libc_memalign(alignment, size);
+    if (!block) {
+        return ENOMEM;
+    }
+    *pointer = block;
+    return 0;
+}
+}
+#endif
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { freeAligned(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { freeAligned(pointer); }
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+// Heap allocation counting for zero-allocation tests.
+//
+// Linking allocation_counter.cpp into a test executable replaces the
+// global operator new and delete and, with glibc, malloc, calloc and
+// realloc, so Qt containers and other C allocations count as well.
+// Allocations are only counted on a thread while an AllocationCounter is
+// alive on it, so worker threads and the test framework itself do not
+// disturb the count.
+class AllocationCounter
+{
+public:
+    AllocationCounter();
+    ~AllocationCounter();
+
+    AllocationCounter(const AllocationCounter&) = delete;
+    AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+    // Allocations on this thread since construction
+    uint64_t count() const;
+
+private:
+    bool m_wasCounting;
+    uint64_t m_start;
+};
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include "allocation_counter.h"
+#include "../clock_model.h"
+#include "../concurrent_histogram.h"
+#include "../event_detector.h"
+#include "../rolling_stats.h"
+#include "../time_aligner.h"
+#include "../trigger_engine.h"
+#include <cmath>
+#include <map>
+
+// After a warm-up the per-batch and per-frame paths must reuse their
+// buffers and never touch the heap. Each test runs the same work twice:
+// once to grow every container to its steady-state size, then counted.
+// Real PlotView frames are counted in render_allocation_test.cpp.
+
+class IngestAllocationTest : public ::testing::Test {
+protected:
+    static constexpr int CHANNEL_COUNT = 3;
+    static constexpr size_t BATCH_SIZE = 96;  // Points per batch, all channels
+    static constexpr size_t MAX_PENDING = 1000;
+
+    void SetUp() override {
+        aligner.setChannels({0, 1, 2});
+        aligner.setSamplePeriod(0.001);
+
+        TriggerEngine::Settings triggerSettings;
+        triggerSettings.level = 0.5f;
+        triggerSettings.preTriggerTime = 0.01;
+        triggerSettings.postTriggerTime = 0.02;
+        trigger.setSettings(triggerSettings);
+        trigger.arm();
+
+        EventDetector::Settings eventSettings;
+        eventSettings.threshold = 0.8f;
+        eventSettings.releaseTime = 0.005;
+        detector.setSettings(eventSettings);
+
+        histogramWriter = histogram.createWriter();
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            statistics[channel].setWindow(0.5);
+        }
+        batch.resize(BATCH_SIZE);
+    }
+
+    // Interleaved 50 Hz sines, one sample per channel and millisecond
+    void fillBatch() {
+        for (size_t i = 0; i < BATCH_SIZE; ++i) {
+            const int channel = static_cast<int>(i % CHANNEL_COUNT);
+            if (channel == 0 && i > 0) {
+                time += 0.001;
+            }
+            batch[i].timestamp = time;
+            batch[i].value = static_cast<float>(std::sin(2.0 * M_PI * 50.0 * time + channel));
+            batch[i].channel = channel;
+        }
+        time += 0.001;
+    }
+
+    // The analysis DataReceiver::addDataPoints runs per batch
+    void ingestBatches(int count) {
+        for (int b = 0; b < count; ++b) {
+            fillBatch();
+            for (const auto& point : batch) {
+                clocks[point.channel].addSample(point.timestamp);
+            }
+            for (auto& entry : clocks) {
+                entry.second.endBatch(time + 0.002);
+            }
+            for (auto& point : batch) {
+                point.timestamp = clocks[point.channel].toHostTime(point.timestamp);
+                statistics[point.channel].add(point.timestamp, point.value);
+            }
+
+            detector.processBatch(batch, events);
+            if (events.size() > 2 * MAX_PENDING) {
+                events.erase(events.begin(), events.end() - MAX_PENDING);
+            }
+
+            trigger.processBatch(batch);
+            if (trigger.hasNewCapture()) {
+                double triggerTime = 0.0;
+                trigger.takeCapture(capture, triggerTime);
+            }
+
+            for (const auto& point : batch) {
+                aligner.push(point);
+                aligner.drainAligned(alignedTimestamps, alignedValues);
+                if (alignedTimestamps.size() > 2 * MAX_PENDING) {
+                    const size_t excess = alignedTimestamps.size() - MAX_PENDING;
+                    alignedTimestamps.erase(alignedTimestamps.begin(), alignedTimestamps.begin() + excess);
+                    alignedValues.erase(alignedValues.begin(), alignedValues.begin() + excess * CHANNEL_COUNT);
+                }
+                histogramWriter->add(point.value);
+            }
+        }
+    }
+
+    double time = 0.0;
+    std::vector<DataPoint> batch;
+    std::map<int, ClockModel> clocks;
+    std::map<int, RollingStats> statistics;
+    EventDetector detector;
+    std::vector<DetectedEvent> events;
+    TriggerEngine trigger;
+    std::vector<DataPoint> capture;
+    TimeAligner aligner;
+    std::vector<double> alignedTimestamps;
+    std::vector<float> alignedValues;
+    ConcurrentHistogram histogram;
+    ConcurrentHistogram::Writer* histogramWriter = nullptr;
+};
+
+TEST_F(IngestAllocationTest, SteadyStateBatchesDoNotAllocate) {
+    // Long enough to fill the statistics window and the pending limits
+    ingestBatches(1000);
+
+    uint64_t allocations = 0;
+    {
+        AllocationCounter counter;
+        ingestBatches(500);
+        allocations = counter.count();
+    }
+    EXPECT_EQ(allocations, 0u);
+    EXPECT_GT(statistics[0].getCount(), 0u);
+    EXPECT_FALSE(alignedTimestamps.empty());
+}
+
+TEST(HistogramAllocationTest, SteadyStateMergesDoNotAllocate) {
+    ConcurrentHistogram histogram;
+    ConcurrentHistogram::Writer* first = histogram.createWriter();
+    ConcurrentHistogram::Writer* second = histogram.createWriter();
+    ConcurrentHistogram::Snapshot snapshot;
+
+    // One merge per frame, as the histogram layout draws it
+    auto runFrames = [&](int count) {
+        for (int f = 0; f < count; ++f) {
+            for (int i = 0; i < 64; ++i) {
+                first->add(std::sin(0.01f * i));
+                second->add(std::cos(0.01f * i) + 2.0f);
+            }
+            histogram.merge(snapshot);
+        }
+    };
+    runFrames(10);
+
+    uint64_t allocations = 0;
+    {
+        AllocationCounter counter;
+        runFrames(300);
+        allocations = counter.count();
+    }
+    EXPECT_EQ(allocations, 0u);
+    EXPECT_EQ(snapshot.total, 310u * 128u);
+}
+
+TEST(AllocationCounterTest, CountsOnlyInsideTheScope) {
+    std::vector<int> before(16);
+    uint64_t allocations = 0;
+    {
+        AllocationCounter counter;
+        std::vector<int> inside(16);
+        allocations = counter.count();
+    }
+    EXPECT_EQ(allocations, 1u);
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include "../clock_model.h"
+#include <cmath>
+
+class ClockModelTest : public ::testing::Test {
+protected:
+    // Device clock running 50 ppm fast, started 1000 s after the host's
+    static double hostTimeOf(double deviceTime) {
+        return 1000.0 + deviceTime / (1.0 + 50e-6);
+    }
+
+    ClockModel model;
+};
+
+TEST_F(ClockModelTest, PassesTimestampsThroughWithoutObservations) {
+    EXPECT_FALSE(model.hasObservations());
+    EXPECT_FALSE(model.isValid());
+    EXPECT_DOUBLE_EQ(model.toHostTime(12.5), 12.5);
+}
+
+TEST_F(ClockModelTest, OneObservationGivesAnOffsetButNoRate) {
+    model.addObservation(10.0, 1010.0);
+    EXPECT_TRUE(model.hasObservations());
+    EXPECT_FALSE(model.isValid());
+    EXPECT_DOUBLE_EQ(model.getRate(), 1.0);
+    EXPECT_DOUBLE_EQ(model.toHostTime(11.0), 1011.0);
+}
+
+TEST_F(ClockModelTest, RecoversOffsetAndDrift) {
+    for (int i = 0; i < 10000; ++i) {
+        const double device = i * 0.01;
+        model.addObservation(device, hostTimeOf(device));
+    }
+
+    ASSERT_TRUE(model.isValid());
+    EXPECT_NEAR(model.getDriftPpm(), -50.0, 0.1);
+    EXPECT_NEAR(model.getOffset(), 1000.0, 1e-6);
+    EXPECT_NEAR(model.toHostTime(200.0), hostTimeOf(200.0), 1e-6);
+}
+
+TEST_F(ClockModelTest, DelayedBatchesDoNotPullTheFit) {
+    // One batch in a hundred is held up 50 ms in transport
+    for (int i = 0; i < 10000; ++i) {
+        const double device = i * 0.01;
+        const double delay = i % 100 == 99 ? 0.05 : 0.0;
+        model.addObservation(device, hostTimeOf(device) + delay);
+    }
+
+    // Plain least squares would be 0.5 ms late on average
+    EXPECT_NEAR(model.toHostTime(100.0), hostTimeOf(100.0), 1e-5);
+    EXPECT_NEAR(model.getDriftPpm(), -50.0, 0.1);
+}
+
+TEST_F(ClockModelTest, BatchUsesItsNewestSample) {
+    model.addSample(1.0);
+    model.addSample(1.2);
+    model.addSample(1.1);
+    model.endBatch(1001.2);
+
+    EXPECT_EQ(model.getObservationCount(), 1u);
+    EXPECT_DOUBLE_EQ(model.toHostTime(1.2), 1001.2);
+
+    // An empty batch adds nothing
+    model.endBatch(1002.0);
+    EXPECT_EQ(model.getObservationCount(), 1u);
+}
+
+TEST_F(ClockModelTest, ResetForgetsTheFit) {
+    for (int i = 0; i < 100; ++i) {
+        model.addObservation(i * 0.01, hostTimeOf(i * 0.01));
+    }
+    ASSERT_TRUE(model.isValid());
+
+    model.reset();
+    EXPECT_FALSE(model.hasObservations());
+    EXPECT_FALSE(model.isValid());
+    EXPECT_DOUBLE_EQ(model.toHostTime(3.0), 3.0);
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "../concurrent_histogram.h"
+#include <numeric>
+#include <thread>
+
+TEST(ConcurrentHistogramTest, CountsEverySample) {
+    ConcurrentHistogram histogram(64, 0.01);
+    ConcurrentHistogram::Writer* writer = histogram.createWriter();
+    for (int i = 0; i < 1000; ++i) {
+        writer->add(static_cast<float>(i % 10) * 0.1f);
+    }
+
+    ConcurrentHistogram::Snapshot snapshot;
+    histogram.merge(snapshot);
+    EXPECT_EQ(snapshot.total, 1000u);
+    EXPECT_EQ(std::accumulate(snapshot.counts.begin(), snapshot.counts.end(), uint64_t(0)), 1000u);
+    EXPECT_LE(snapshot.counts.size(), histogram.getBinCount());
+}
+
+TEST(ConcurrentHistogramTest, WidensBinsToFitTheRange) {
+    ConcurrentHistogram histogram(16, 0.001);
+    ConcurrentHistogram::Writer* writer = histogram.createWriter();
+    writer->add(0.0f);
+    writer->add(1000.0f);
+    writer->add(-1000.0f);
+
+    ConcurrentHistogram::Snapshot snapshot;
+    histogram.merge(snapshot);
+    EXPECT_EQ(snapshot.total, 3u);
+    EXPECT_LE(snapshot.firstEdge, -1000.0);
+    EXPECT_GE(snapshot.firstEdge + snapshot.binWidth * snapshot.counts.size(), 1000.0);
+}
+
+TEST(ConcurrentHistogramTest, ResetClearsAllWriters) {
+    ConcurrentHistogram histogram;
+    ConcurrentHistogram::Writer* writer = histogram.createWriter();
+    writer->add(1.0f);
+    histogram.reset();
+    writer->add(2.0f);
+
+    ConcurrentHistogram::Snapshot snapshot;
+    histogram.merge(snapshot);
+    EXPECT_EQ(snapshot.total, 1u);
+}
+
+TEST(ConcurrentHistogramTest, ParallelWritersMergeExactly) {
+    ConcurrentHistogram histogram(128, 0.001);
+    const int threadCount = 4;
+    const int samplesPerThread = 20000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&histogram, t]() {
+            ConcurrentHistogram::Writer* writer = histogram.createWriter();
+            for (int i = 0; i < samplesPerThread; ++i) {
+                writer->add(static_cast<float>((i * (t + 1)) % 1000) * 0.01f);
+            }
+        });
+    }
+
+    // Merging while writers run must never see more than was added
+    ConcurrentHistogram::Snapshot snapshot;
+    for (int i = 0; i < 100; ++i) {
+        histogram.merge(snapshot);
+        EXPECT_LE(snapshot.total, static_cast<uint64_t>(threadCount * samplesPerThread));
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    histogram.merge(snapshot);
+    EXPECT_EQ(snapshot.total, static_cast<uint64_t>(threadCount * samplesPerThread));
+}
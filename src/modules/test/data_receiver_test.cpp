@@ -0,0 +1,262 @@
+#include <gtest/gtest.h>
+#include "../data_receiver.h"
+#include "allocation_counter.h"
+#include <QtEndian>
+#include <cmath>
+
+TEST(DataReceiverTest, ParsesCsvRecords) {
+    DataPoint point;
+    ASSERT_TRUE(DataReceiver::parseMessage("1.5,2.25", point));
+    EXPECT_DOUBLE_EQ(point.timestamp, 1.5);
+    EXPECT_FLOAT_EQ(point.value, 2.25f);
+    EXPECT_EQ(point.channel, 0);
+
+    ASSERT_TRUE(DataReceiver::parseMessage("3,-1,7\r", point));
+    EXPECT_DOUBLE_EQ(point.timestamp, 3.0);
+    EXPECT_FLOAT_EQ(point.value, -1.0f);
+    EXPECT_EQ(point.channel, 7);
+}
+
+TEST(DataReceiverTest, ParsesJsonRecords) {
+    DataPoint point;
+    ASSERT_TRUE(DataReceiver::parseMessage(R"({"timestamp": 0.5, "value": 4, "channel": 2})", point));
+    EXPECT_DOUBLE_EQ(point.timestamp, 0.5);
+    EXPECT_FLOAT_EQ(point.value, 4.0f);
+    EXPECT_EQ(point.channel, 2);
+
+    ASSERT_TRUE(DataReceiver::parseMessage(R"({ "value" : -2.5E-1 , "unit" : 3, "timestamp" : 1e3 })", point));
+    EXPECT_DOUBLE_EQ(point.timestamp, 1000.0);
+    EXPECT_FLOAT_EQ(point.value, -0.25f);
+    EXPECT_EQ(point.channel, 0);
+
+    // Beyond flat numbers the full parser decides, with the same results
+    ASSERT_TRUE(DataReceiver::parseMessage(R"({"timestamp": 2, "value": 1, "channel": 3, "unit": "V"})", point));
+    EXPECT_DOUBLE_EQ(point.timestamp, 2.0);
+    EXPECT_EQ(point.channel, 3);
+    ASSERT_TRUE(DataReceiver::parseMessage(R"({"timestamp": 2, "value": 1, "channel": 1.5})", point));
+    EXPECT_EQ(point.channel, 0);
+}
+
+TEST(DataReceiverTest, RejectsMalformedRecords) {
+    DataPoint point;
+    EXPECT_FALSE(DataReceiver::parseMessage("", point));
+    EXPECT_FALSE(DataReceiver::parseMessage("abc,def", point));
+    EXPECT_FALSE(DataReceiver::parseMessage("1.0", point));
+    EXPECT_FALSE(DataReceiver::parseMessage(R"({"timestamp": 1.0})", point));
+    EXPECT_FALSE(DataReceiver::parseMessage(R"({"timestamp": 1.0, "value": 2,})", point));
+    EXPECT_FALSE(DataReceiver::parseMessage(R"({"timestamp": 1.0, "value": 2} 3)", point));
+}
+
+TEST(DataReceiverTest, FeedDataFramesRecordsAcrossChunks) {
+    DataReceiver receiver;
+
+    // The second record is split between two reads
+    receiver.feedData("0.0,1.0,0\n0.1,", 0.0);
+    receiver.feedData("2.0,1\n0.2,3.0,0\n", 0.1);
+
+    const std::vector<DataPoint> points = receiver.getLatestData();
+    ASSERT_EQ(points.size(), 3u);
+    EXPECT_FLOAT_EQ(points[0].value, 1.0f);
+    EXPECT_FLOAT_EQ(points[1].value, 2.0f);
+    EXPECT_EQ(points[1].channel, 1);
+    EXPECT_FLOAT_EQ(points[2].value, 3.0f);
+    EXPECT_EQ(receiver.getReceivedCount(), 3u);
+}
+
+namespace {
+
+// One record as load_generator --format binary writes it
+QByteArray binaryRecord(double timestamp, float value, qint32 channel)
+{
+    QByteArray record(DataReceiver::BINARY_RECORD_SIZE, Qt::Uninitialized);
+    qToLittleEndian(timestamp, record.data());
+    qToLittleEndian(value, record.data() + 8);
+    qToLittleEndian(channel, record.data() + 12);
+    return record;
+}
+
+enum RecordEncoding {
+    CSV_RECORDS,
+    JSON_RECORDS,
+    BINARY_RECORDS
+};
+
+// Two interleaved channels at 1 kHz, 64 records per read
+std::vector<QByteArray> makeSteadyStateReads(RecordEncoding encoding)
+{
+    std::vector<QByteArray> reads;
+    double time = 0.0;
+    for (int r = 0; r < 1500; ++r) {
+        QByteArray read;
+        for (int i = 0; i < 32; ++i, time += 0.001) {
+            const double value = std::sin(2.0 * M_PI * 5.0 * time);
+            for (int channel = 0; channel < 2; ++channel) {
+                const double channelValue = channel ? -value : value;
+                if (encoding == BINARY_RECORDS) {
+                    read += binaryRecord(time, static_cast<float>(channelValue), channel);
+                } else if (encoding == JSON_RECORDS) {
+                    read += "{\"timestamp\":" + QByteArray::number(time, 'f', 6) + ",\"value\":" +
+                            QByteArray::number(channelValue, 'f', 4) + ",\"channel\":" + QByteArray::number(channel) + "}\n";
+                } else {
+                    read += QByteArray::number(time, 'f', 6) + ',' + QByteArray::number(channelValue, 'f', 4) + ',' +
+                            QByteArray::number(channel) + '\n';
+                }
+            }
+        }
+        reads.push_back(read);
+    }
+    return reads;
+}
+
+// Heap allocations, counted by malloc as well as operator new, over the
+// last 500 reads once the first 1000 have filled the queue, statistics
+// window and pending-frame limits
+uint64_t countSteadyStateAllocations(RecordEncoding encoding)
+{
+    DataReceiver receiver;
+    receiver.setInputFormat(encoding == BINARY_RECORDS ? DataReceiver::BINARY_INPUT : DataReceiver::TEXT_INPUT);
+    receiver.setAlignment({0, 1}, 0.001);
+    receiver.setStatisticsEnabled(true);
+    receiver.setEventDetection(true);
+    receiver.setHistogramChannel(0);
+    const std::vector<QByteArray> reads = makeSteadyStateReads(encoding);
+
+    std::vector<DataPoint> taken;
+    for (int r = 0; r < 1000; ++r) {
+        receiver.feedData(reads[r], r * 0.032);
+    }
+    receiver.takeLatestData(taken);
+    taken.reserve(taken.size() + 64 * 500);
+
+    uint64_t allocations = 0;
+    {
+        AllocationCounter counter;
+        for (int r = 1000; r < 1500; ++r) {
+            receiver.feedData(reads[r], r * 0.032);
+        }
+        receiver.takeLatestData(taken);
+        allocations = counter.count();
+    }
+    EXPECT_EQ(receiver.getReceivedCount(), 1500u * 64u);
+    return allocations;
+}
+
+} // namespace
+
+TEST(DataReceiverTest, ParsesBinaryRecords) {
+    DataPoint point;
+    ASSERT_TRUE(DataReceiver::parseBinaryRecord(binaryRecord(1.5, -2.25f, 3).constData(), point));
+    EXPECT_DOUBLE_EQ(point.timestamp, 1.5);
+    EXPECT_FLOAT_EQ(point.value, -2.25f);
+    EXPECT_EQ(point.channel, 3);
+
+    EXPECT_FALSE(DataReceiver::parseBinaryRecord(binaryRecord(NAN, 0.0f, 0).constData(), point));
+}
+
+TEST(DataReceiverTest, FeedDataFramesBinaryRecordsAcrossChunks) {
+    DataReceiver receiver;
+    receiver.setInputFormat(DataReceiver::BINARY_INPUT);
+
+    // The second record is split between two reads
+    const QByteArray stream = binaryRecord(0.0, 1.0f, 0) + binaryRecord(0.1, 2.0f, 1) + binaryRecord(0.2, 3.0f, 0);
+    receiver.feedData(stream.left(20), 0.0);
+    EXPECT_EQ(receiver.getReceivedCount(), 1u);
+    receiver.feedData(stream.mid(20), 0.1);
+
+    const std::vector<DataPoint> points = receiver.getLatestData();
+    ASSERT_EQ(points.size(), 3u);
+    EXPECT_FLOAT_EQ(points[0].value, 1.0f);
+    EXPECT_FLOAT_EQ(points[1].value, 2.0f);
+    EXPECT_EQ(points[1].channel, 1);
+    EXPECT_DOUBLE_EQ(points[2].timestamp, 0.2);
+}
+
+TEST(DataReceiverTest, FormatChangeDropsThePartialRecord) {
+    DataReceiver receiver;
+    receiver.feedData("0.0,1.0,0\n0.1,", 0.0);
+
+    receiver.setInputFormat(DataReceiver::BINARY_INPUT);
+    receiver.feedData(binaryRecord(0.2, 3.0f, 0), 0.1);
+
+    const std::vector<DataPoint> points = receiver.getLatestData();
+    ASSERT_EQ(points.size(), 2u);
+    EXPECT_DOUBLE_EQ(points[1].timestamp, 0.2);
+    EXPECT_FLOAT_EQ(points[1].value, 3.0f);
+}
+
+TEST(DataReceiverTest, ClearDataEmptiesTheQueue) {
+    DataReceiver receiver;
+    receiver.feedData("0.0,1.0\n0.1,2.0\n", 0.0);
+    receiver.clearData();
+
+    EXPECT_TRUE(receiver.getLatestData().empty());
+    EXPECT_EQ(receiver.getQueueDepth(), 0);
+}
+
+TEST(DataReceiverTest, AlignedFramesAreHandedOutOnce) {
+    DataReceiver receiver;
+    receiver.setAlignment({0, 1}, 0.01);
+    auto feed = [&receiver](double begin, double end) {
+        for (double t = begin; t < end; t += 0.01) {
+            const QByteArray time = QByteArray::number(t, 'f', 6);
+            receiver.feedData(time + ",1.0,0\n" + time + ",2.0,1\n", t);
+        }
+    };
+
+    std::vector<double> timestamps;
+    std::vector<float> values;
+    feed(0.0, 1.0);
+    const size_t first = receiver.takeAlignedData(timestamps, values);
+    ASSERT_GT(first, 0u);
+    EXPECT_EQ(values.size(), first * 2);
+    const double lastTaken = timestamps.back();
+
+    EXPECT_EQ(receiver.takeAlignedData(timestamps, values), 0u);
+    EXPECT_TRUE(timestamps.empty());
+
+    // Raw samples can be dropped without losing frames not yet taken
+    feed(1.0, 2.0);
+    receiver.discardLatestData();
+    ASSERT_GT(receiver.takeAlignedData(timestamps, values), 0u);
+    EXPECT_GT(timestamps.front(), lastTaken);
+}
+
+TEST(DataReceiverTest, ClockCorrectionToggleRestartsAlignment) {
+    DataReceiver receiver;
+    receiver.setAlignment({0, 1}, 0.01);
+
+    // Device clock 1000 s ahead of the host; one read per 10 ms
+    double deviceTime = 1000.0;
+    auto feed = [&](int reads) {
+        for (int r = 0; r < reads; ++r, deviceTime += 0.01) {
+            const QByteArray time = QByteArray::number(deviceTime, 'f', 6);
+            receiver.feedData(time + ",1.0,0\n" + time + ",2.0,1\n", deviceTime - 1000.0);
+        }
+    };
+
+    std::vector<double> timestamps;
+    std::vector<float> values;
+    feed(100);
+    ASSERT_GT(receiver.takeAlignedData(timestamps, values), 0u);
+    EXPECT_GT(timestamps.back(), 900.0);
+
+    // Corrected timestamps are far behind the device ones, which the
+    // aligner would reject as late without a restart
+    receiver.setClockCorrectionEnabled(true);
+    EXPECT_TRUE(receiver.getLatestData().empty());
+    feed(100);
+    ASSERT_GT(receiver.takeAlignedData(timestamps, values), 0u);
+    EXPECT_LT(timestamps.back(), 100.0);
+}
+
+TEST(DataReceiverTest, SteadyStateCsvIngestDoesNotAllocate) {
+    EXPECT_EQ(countSteadyStateAllocations(CSV_RECORDS), 0u);
+}
+
+TEST(DataReceiverTest, SteadyStateJsonIngestDoesNotAllocate) {
+    EXPECT_EQ(countSteadyStateAllocations(JSON_RECORDS), 0u);
+}
+
+TEST(DataReceiverTest, SteadyStateBinaryIngestDoesNotAllocate) {
+    EXPECT_EQ(countSteadyStateAllocations(BINARY_RECORDS), 0u);
+}
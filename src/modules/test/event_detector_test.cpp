@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include "../event_detector.h"
+#include <cmath>
+
+class EventDetectorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        EventDetector::Settings settings;
+        settings.threshold = 1.0f;
+        settings.hysteresis = 0.1f;
+        settings.releaseTime = 0.02;
+        settings.maxEventDuration = 1.0;
+        detector.setSettings(settings);
+    }
+
+    // 1 kHz samples of a 100 Hz ring, amplitude 3 decaying over 20 ms,
+    // struck at impactTime
+    static std::vector<DataPoint> impact(double begin, double end, double impactTime, int channel = 0) {
+        std::vector<DataPoint> points;
+        for (int i = 0; begin + i * 0.001 < end; ++i) {
+            const double t = begin + i * 0.001;
+            float value = 0.0f;
+            if (t >= impactTime) {
+                const double age = t - impactTime;
+                value = static_cast<float>(3.0 * std::exp(-age / 0.02) * std::sin(2.0 * M_PI * 100.0 * age + M_PI / 2));
+            }
+            points.emplace_back(t, value, channel);
+        }
+        return points;
+    }
+
+    EventDetector detector;
+    std::vector<DetectedEvent> events;
+};
+
+TEST_F(EventDetectorTest, RingingImpactIsOneEvent) {
+    EXPECT_EQ(detector.processBatch(impact(0.0, 1.0, 0.5), events), 1u);
+
+    ASSERT_EQ(events.size(), 1u);
+    const DetectedEvent& event = events.front();
+    EXPECT_EQ(event.channel, 0);
+    EXPECT_NEAR(event.startTime, 0.5, 1e-9);
+    EXPECT_NEAR(event.peakTime, 0.5, 1e-9);
+    EXPECT_FLOAT_EQ(event.peakValue, 3.0f);
+    EXPECT_GT(event.endTime, 0.52);
+    EXPECT_LT(event.endTime, 0.6);
+}
+
+TEST_F(EventDetectorTest, QuietSignalHasNoEvents) {
+    std::vector<DataPoint> points;
+    for (int i = 0; i < 1000; ++i) {
+        points.emplace_back(i * 0.001, 0.9f * static_cast<float>(std::sin(i * 0.1)), 0);
+    }
+    EXPECT_EQ(detector.processBatch(points, events), 0u);
+}
+
+TEST_F(EventDetectorTest, BatchBoundariesDoNotMatter) {
+    std::vector<DetectedEvent> whole;
+    detector.processBatch(impact(0.0, 1.0, 0.5), whole);
+
+    detector.reset();
+    const std::vector<DataPoint> points = impact(0.0, 1.0, 0.5);
+    for (size_t begin = 0; begin < points.size(); begin += 7) {
+        const std::vector<DataPoint> batch(points.begin() + begin, points.begin() + std::min(begin + 7, points.size()));
+        detector.processBatch(batch, events);
+    }
+
+    ASSERT_EQ(events.size(), whole.size());
+    EXPECT_EQ(events.front().startTime, whole.front().startTime);
+    EXPECT_EQ(events.front().peakValue, whole.front().peakValue);
+    EXPECT_EQ(events.front().endTime, whole.front().endTime);
+}
+
+TEST_F(EventDetectorTest, ChannelsAreDetectedSeparately) {
+    // Channel 1 is struck later, interleaved with channel 0
+    const std::vector<DataPoint> first = impact(0.0, 1.0, 0.2, 0);
+    const std::vector<DataPoint> second = impact(0.0, 1.0, 0.6, 1);
+    std::vector<DataPoint> points;
+    for (size_t i = 0; i < first.size(); ++i) {
+        points.push_back(first[i]);
+        points.push_back(second[i]);
+    }
+    detector.processBatch(points, events);
+
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].channel, 0);
+    EXPECT_NEAR(events[0].startTime, 0.2, 1e-9);
+    EXPECT_EQ(events[1].channel, 1);
+    EXPECT_NEAR(events[1].startTime, 0.6, 1e-9);
+}
+
+TEST_F(EventDetectorTest, LongExcursionsAreSplit) {
+    std::vector<DataPoint> points;
+    for (int i = 0; i < 4000; ++i) {
+        points.emplace_back(i * 0.001, i < 3500 ? 2.0f : 0.0f, 0);
+    }
+    detector.processBatch(points, events);
+
+    // Split after one, two and three seconds, then the end
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_NEAR(events[0].endTime, 1.0, 1e-9);
+    EXPECT_NEAR(events[1].startTime, 1.0, 1e-9);
+    EXPECT_NEAR(events[3].startTime, 3.0, 1e-9);
+    EXPECT_GT(events[3].endTime, 3.5);
+}
+
+TEST_F(EventDetectorTest, ResetDropsActiveEvents) {
+    // Struck just before the end of the batch, still ringing
+    detector.processBatch(impact(0.0, 0.505, 0.5), events);
+    EXPECT_TRUE(events.empty());
+
+    detector.reset();
+    std::vector<DataPoint> quiet;
+    for (int i = 0; i < 200; ++i) {
+        quiet.emplace_back(0.505 + i * 0.001, 0.0f, 0);
+    }
+    EXPECT_EQ(detector.processBatch(quiet, events), 0u);
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "../event_index.h"
+
+class EventIndexTest : public ::testing::Test {
+protected:
+    static DetectedEvent makeEvent(double startTime, double endTime, int channel = 0) {
+        DetectedEvent event;
+        event.channel = channel;
+        event.startTime = startTime;
+        event.peakTime = startTime;
+        event.endTime = endTime;
+        return event;
+    }
+
+    EventIndex index;
+    std::vector<DetectedEvent> found;
+};
+
+TEST_F(EventIndexTest, FindsEventsOverlappingTheRange) {
+    index.insert(makeEvent(0.0, 0.1));
+    index.insert(makeEvent(1.0, 1.5));
+    index.insert(makeEvent(2.0, 2.05));
+
+    // Starts before the range, ends inside it
+    EXPECT_EQ(index.query(1.2, 1.3, found), 1u);
+    ASSERT_EQ(found.size(), 1u);
+    EXPECT_EQ(found.front().startTime, 1.0);
+
+    found.clear();
+    EXPECT_EQ(index.query(0.05, 2.0, found), 3u);
+
+    found.clear();
+    EXPECT_EQ(index.query(0.2, 0.9, found), 0u);
+    EXPECT_EQ(index.query(3.0, 4.0, found), 0u);
+}
+
+TEST_F(EventIndexTest, LateEventsAreSortedIn) {
+    index.insert(makeEvent(1.0, 1.1, 0));
+    index.insert(makeEvent(3.0, 3.1, 0));
+    index.insert(makeEvent(2.0, 2.1, 1));
+
+    EXPECT_EQ(index.query(0.0, 10.0, found), 3u);
+    ASSERT_EQ(found.size(), 3u);
+    EXPECT_EQ(found[0].startTime, 1.0);
+    EXPECT_EQ(found[1].startTime, 2.0);
+    EXPECT_EQ(found[1].channel, 1);
+    EXPECT_EQ(found[2].startTime, 3.0);
+}
+
+TEST_F(EventIndexTest, DropsTheOldestAtCapacity) {
+    index.setCapacity(3);
+    for (int i = 0; i < 5; ++i) {
+        index.insert(makeEvent(i, i + 0.5));
+    }
+    EXPECT_EQ(index.size(), 3u);
+
+    index.query(0.0, 10.0, found);
+    ASSERT_EQ(found.size(), 3u);
+    EXPECT_EQ(found.front().startTime, 2.0);
+
+    // Shrinking drops more
+    index.setCapacity(1);
+    EXPECT_EQ(index.size(), 1u);
+}
+
+TEST_F(EventIndexTest, ClearEmptiesTheIndex) {
+    index.insert(makeEvent(0.0, 10.0));
+    index.clear();
+    EXPECT_EQ(index.size(), 0u);
+    EXPECT_EQ(index.query(0.0, 10.0, found), 0u);
+
+    // The longest duration is forgotten too, yet short events still match
+    index.insert(makeEvent(5.0, 5.01));
+    EXPECT_EQ(index.query(5.005, 5.006, found), 1u);
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include "../frame_stats.h"
+
+class FrameStatsTest : public ::testing::Test {
+protected:
+    static constexpr uint64_t MS = 1000000;
+
+    FrameStats stats;
+};
+
+TEST_F(FrameStatsTest, EmptyUntilAFrameCloses) {
+    EXPECT_EQ(stats.summarize().frames, 0u);
+
+    stats.beginFrame(0);
+    stats.addStageTime(FrameStats::SCENE_STAGE, 5 * MS);
+    const FrameStats::Summary summary = stats.summarize();
+    EXPECT_EQ(summary.frames, 0u);
+    EXPECT_EQ(summary.frameMs, 0.0);
+    EXPECT_FALSE(summary.gpuValid);
+}
+
+TEST_F(FrameStatsTest, AveragesFramesAndStages) {
+    // Two frames of 10 and 20 ms
+    stats.beginFrame(0);
+    stats.addStageTime(FrameStats::SCENE_STAGE, 4 * MS);
+    stats.addStageTime(FrameStats::OVERLAY_STAGE, 1 * MS);
+    stats.addVertices(100);
+    stats.addUpload(1000);
+    stats.beginFrame(10 * MS);
+    stats.addStageTime(FrameStats::SCENE_STAGE, 6 * MS);
+    stats.addStageTime(FrameStats::SCENE_STAGE, 2 * MS);
+    stats.addVertices(300);
+    stats.beginFrame(30 * MS);
+
+    const FrameStats::Summary summary = stats.summarize();
+    EXPECT_EQ(summary.frames, 2u);
+    EXPECT_DOUBLE_EQ(summary.frameMs, 15.0);
+    EXPECT_DOUBLE_EQ(summary.frameMsMax, 20.0);
+    EXPECT_DOUBLE_EQ(summary.stageMs[FrameStats::SCENE_STAGE], 6.0);
+    EXPECT_DOUBLE_EQ(summary.stageMs[FrameStats::OVERLAY_STAGE], 0.5);
+    EXPECT_DOUBLE_EQ(summary.stageMs[FrameStats::CAPTURE_STAGE], 0.0);
+    EXPECT_DOUBLE_EQ(summary.vertices, 200.0);
+    EXPECT_DOUBLE_EQ(summary.uploadBytes, 500.0);
+}
+
+TEST_F(FrameStatsTest, KeepsOnlyRecentFrames) {
+    // One slow frame, then a full history of fast ones
+    stats.beginFrame(0);
+    uint64_t now = 100 * MS;
+    stats.beginFrame(now);
+    for (size_t i = 0; i < FrameStats::FRAME_HISTORY; ++i) {
+        now += 16 * MS;
+        stats.beginFrame(now);
+    }
+
+    const FrameStats::Summary summary = stats.summarize();
+    EXPECT_EQ(summary.frames, FrameStats::FRAME_HISTORY);
+    EXPECT_DOUBLE_EQ(summary.frameMs, 16.0);
+    EXPECT_DOUBLE_EQ(summary.frameMsMax, 16.0);
+}
+
+TEST_F(FrameStatsTest, AveragesGpuTimesSeparately) {
+    stats.addGpuTime(2 * MS);
+    stats.addGpuTime(4 * MS);
+
+    const FrameStats::Summary summary = stats.summarize();
+    EXPECT_EQ(summary.frames, 0u);
+    EXPECT_TRUE(summary.gpuValid);
+    EXPECT_DOUBLE_EQ(summary.gpuMs, 3.0);
+}
+
+TEST_F(FrameStatsTest, ResetStartsOver) {
+    stats.beginFrame(0);
+    stats.beginFrame(10 * MS);
+    stats.addGpuTime(2 * MS);
+    stats.reset();
+
+    // The first frame after a reset has no interval yet
+    stats.beginFrame(50 * MS);
+    const FrameStats::Summary summary = stats.summarize();
+    EXPECT_EQ(summary.frames, 0u);
+    EXPECT_FALSE(summary.gpuValid);
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "../frame_writer.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+class FrameWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory = std::filesystem::temp_directory_path() /
+            ("frame_writer_test_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+        std::filesystem::create_directories(directory);
+    }
+
+    void TearDown() override {
+        writer.close();
+        std::filesystem::remove_all(directory);
+    }
+
+    // Bottom-up RGBA, one color everywhere
+    void submitSolidFrame(uint8_t r, uint8_t g, uint8_t b) {
+        uint8_t* buffer = nullptr;
+        while (!(buffer = writer.acquireBuffer())) {
+            std::this_thread::yield();
+        }
+        for (size_t i = 0; i < writer.getFrameBytes(); i += 4) {
+            buffer[i] = r;
+            buffer[i + 1] = g;
+            buffer[i + 2] = b;
+            buffer[i + 3] = 255;
+        }
+        writer.submitBuffer(buffer);
+    }
+
+    static std::string readFile(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    std::filesystem::path directory;
+    FrameWriter writer;
+};
+
+TEST_F(FrameWriterTest, RejectsOddSizes) {
+    EXPECT_FALSE(writer.open((directory / "odd.y4m").string(), FrameWriter::Y4M_FORMAT, 63, 32, 30));
+    EXPECT_FALSE(writer.isOpen());
+    EXPECT_FALSE(writer.errorString().empty());
+}
+
+TEST_F(FrameWriterTest, Y4mHeaderAndFrames) {
+    const std::filesystem::path path = directory / "capture.y4m";
+    ASSERT_TRUE(writer.open(path.string(), FrameWriter::Y4M_FORMAT, 8, 4, 25));
+    for (int i = 0; i < 3; ++i) {
+        submitSolidFrame(255, 255, 255);
+    }
+    writer.close();
+    EXPECT_EQ(writer.getWrittenCount(), 3u);
+
+    const std::string header = "YUV4MPEG2 W8 H4 F25:1 Ip A1:1 C420jpeg\n";
+    const std::string frameMarker = "FRAME\n";
+    const size_t frameBytes = 8 * 4 * 3 / 2;
+    const std::string contents = readFile(path);
+    ASSERT_EQ(contents.size(), header.size() + 3 * (frameMarker.size() + frameBytes));
+    EXPECT_EQ(contents.compare(0, header.size(), header), 0);
+    EXPECT_EQ(contents.compare(header.size(), frameMarker.size(), frameMarker), 0);
+
+    // White is Y 235 and neutral chroma in limited range
+    const size_t planes = header.size() + frameMarker.size();
+    EXPECT_EQ(static_cast<uint8_t>(contents[planes]), 235);
+    EXPECT_EQ(static_cast<uint8_t>(contents[planes + 8 * 4]), 128);
+    EXPECT_EQ(static_cast<uint8_t>(contents[planes + 8 * 4 + 8]), 128);
+}
+
+TEST_F(FrameWriterTest, PpmSequenceIsTopDown) {
+    ASSERT_TRUE(writer.open(directory.string(), FrameWriter::PPM_SEQUENCE_FORMAT, 2, 2, 30));
+
+    // Bottom row red, top row blue in GL order
+    uint8_t* buffer = writer.acquireBuffer();
+    ASSERT_NE(buffer, nullptr);
+    const uint8_t pixels[16] = {255, 0, 0, 255, 255, 0, 0, 255, 0, 0, 255, 255, 0, 0, 255, 255};
+    std::memcpy(buffer, pixels, sizeof(pixels));
+    writer.submitBuffer(buffer);
+    writer.close();
+
+    const std::string contents = readFile(directory / "frame_000000.ppm");
+    const std::string header = "P6\n2 2\n255\n";
+    ASSERT_EQ(contents.size(), header.size() + 12);
+    EXPECT_EQ(contents.compare(0, header.size(), header), 0);
+    EXPECT_EQ(static_cast<uint8_t>(contents[header.size() + 2]), 255);  // First row blue
+    EXPECT_EQ(static_cast<uint8_t>(contents[header.size() + 6]), 255);  // Second row red
+}
+
+TEST_F(FrameWriterTest, DropsInsteadOfBlockingWhenBuffersRunOut) {
+    ASSERT_TRUE(writer.open((directory / "capture.y4m").string(), FrameWriter::Y4M_FORMAT, 4, 2, 30, 2));
+
+    // Without submitting, the pool is exhausted after two buffers
+    EXPECT_NE(writer.acquireBuffer(), nullptr);
+    EXPECT_NE(writer.acquireBuffer(), nullptr);
+    EXPECT_EQ(writer.acquireBuffer(), nullptr);
+    EXPECT_EQ(writer.getDroppedCount(), 1u);
+}
+
+TEST_F(FrameWriterTest, WriteErrorsAreReportedOnClose) {
+    ASSERT_TRUE(writer.open((directory / "missing").string(), FrameWriter::PPM_SEQUENCE_FORMAT, 2, 2, 30));
+    submitSolidFrame(0, 0, 0);
+    writer.close();
+
+    EXPECT_EQ(writer.getWrittenCount(), 0u);
+    EXPECT_EQ(writer.getDroppedCount(), 1u);
+    EXPECT_FALSE(writer.errorString().empty());
+}
@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include "../point_octree.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <set>
+
+class PointOctreeTest : public ::testing::Test {
+protected:
+    static constexpr float VIEWPORT = 100.0f;
+
+    // Deterministic points filling [-extent, extent]^3
+    void insertPoints(size_t count, float extent) {
+        uint32_t state = 12345;
+        auto next = [&state]() {
+            state = state * 1664525u + 1013904223u;
+            return static_cast<float>(state >> 8) / static_cast<float>(1u << 24) * 2.0f - 1.0f;
+        };
+        for (size_t i = 0; i < count; ++i) {
+            const PointOctree::Point point{next() * extent, next() * extent, next() * extent, static_cast<uint32_t>(i)};
+            points.push_back(point);
+            octree.insert(point);
+        }
+    }
+
+    static bool inView(const PointOctree::Point& point) {
+        return std::fabs(point.x) <= 1.0f && std::fabs(point.y) <= 1.0f && std::fabs(point.z) <= 1.0f;
+    }
+
+    // Screen position under the identity projection
+    static void toScreen(const PointOctree::Point& point, float& x, float& y) {
+        x = (point.x + 1.0f) * 0.5f * VIEWPORT;
+        y = (1.0f - point.y) * 0.5f * VIEWPORT;
+    }
+
+    // Clip space is the [-1, 1] cube
+    const float identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+
+    PointOctree octree;
+    std::vector<PointOctree::Point> points;
+};
+
+TEST_F(PointOctreeTest, SelectsEveryPointWithoutLod) {
+    octree.setLeafCapacity(32);
+    insertPoints(5000, 1.0f);
+    EXPECT_EQ(octree.size(), 5000u);
+
+    std::vector<PointOctree::Point> visible;
+    EXPECT_EQ(octree.selectVisible(identity, VIEWPORT, VIEWPORT, 0.0f, visible), 5000u);
+
+    std::set<uint32_t> ids;
+    for (const auto& point : visible) {
+        ids.insert(point.id);
+    }
+    EXPECT_EQ(ids.size(), 5000u);
+}
+
+TEST_F(PointOctreeTest, CullsNodesOutsideTheFrustum) {
+    octree.setLeafCapacity(32);
+    insertPoints(5000, 4.0f);
+
+    std::vector<PointOctree::Point> visible;
+    octree.selectVisible(identity, VIEWPORT, VIEWPORT, 0.0f, visible);
+    EXPECT_LT(visible.size(), points.size() / 4);
+
+    std::set<uint32_t> ids;
+    for (const auto& point : visible) {
+        ids.insert(point.id);
+    }
+    for (const auto& point : points) {
+        if (inView(point)) {
+            EXPECT_EQ(ids.count(point.id), 1u) << "Point " << point.id << " is in view";
+        }
+    }
+}
+
+TEST_F(PointOctreeTest, SmallNodesContributeOnlyTheirSamples) {
+    octree.setLeafCapacity(32);
+    octree.setSampleCount(8);
+    insertPoints(5000, 1.0f);
+
+    // The whole tree covers fewer pixels than the threshold
+    std::vector<PointOctree::Point> visible;
+    EXPECT_EQ(octree.selectVisible(identity, VIEWPORT, VIEWPORT, 1000.0f, visible), 8u);
+    for (const auto& point : visible) {
+        ASSERT_LT(point.id, points.size());
+        EXPECT_EQ(point.x, points[point.id].x);
+    }
+
+    // Coarser detail as the threshold grows
+    size_t previous = points.size() + 1;
+    for (float threshold : {0.0f, 10.0f, 40.0f, 1000.0f}) {
+        visible.clear();
+        const size_t selected = octree.selectVisible(identity, VIEWPORT, VIEWPORT, threshold, visible);
+        EXPECT_LT(selected, previous) << "Threshold " << threshold;
+        previous = selected;
+    }
+}
+
+TEST_F(PointOctreeTest, GrowsToPointsOutsideTheRoot) {
+    octree.insert({0.0f, 0.0f, 0.0f, 0});
+    octree.insert({100.0f, -50.0f, 3.0f, 1});
+    octree.insert({-1e4f, 0.0f, 0.0f, 2});
+    EXPECT_EQ(octree.size(), 3u);
+
+    // Scaled to fit everything into view
+    const float scale = 1.0f / 1e4f;
+    const float mvp[16] = {scale, 0, 0, 0, 0, scale, 0, 0, 0, 0, scale, 0, 0, 0, 0, 1};
+    std::vector<PointOctree::Point> visible;
+    EXPECT_EQ(octree.selectVisible(mvp, VIEWPORT, VIEWPORT, 0.0f, visible), 3u);
+}
+
+TEST_F(PointOctreeTest, NearestOnScreenMatchesBruteForce) {
+    octree.setLeafCapacity(16);
+    insertPoints(2000, 1.0f);
+
+    for (int query = 0; query < 50; ++query) {
+        const float screenX = 7.0f + query * 1.7f;
+        const float screenY = 93.0f - query * 1.3f;
+
+        float bestDistance = std::numeric_limits<float>::max();
+        for (const auto& point : points) {
+            float x, y;
+            toScreen(point, x, y);
+            bestDistance = std::min(bestDistance, std::hypot(x - screenX, y - screenY));
+        }
+
+        PointOctree::Point found{};
+        ASSERT_TRUE(octree.findNearestOnScreen(identity, VIEWPORT, VIEWPORT, screenX, screenY, 50.0f, nullptr, found));
+        float x, y;
+        toScreen(found, x, y);
+        EXPECT_NEAR(std::hypot(x - screenX, y - screenY), bestDistance, 1e-3f) << "Query " << query;
+    }
+}
+
+TEST_F(PointOctreeTest, NearestOnScreenHonoursDistanceAndFilter) {
+    // Grid with 5 pixel spacing on screen
+    uint32_t id = 0;
+    for (int i = -10; i <= 10; ++i) {
+        for (int j = -10; j <= 10; ++j) {
+            octree.insert({i * 0.1f, j * 0.1f, 0.0f, id++});
+        }
+    }
+
+    // (0.5, 0.5) is at (75, 25)
+    PointOctree::Point found{};
+    ASSERT_TRUE(octree.findNearestOnScreen(identity, VIEWPORT, VIEWPORT, 75.5f, 25.0f, 3.0f, nullptr, found));
+    EXPECT_NEAR(found.x, 0.5f, 1e-6f);
+    EXPECT_NEAR(found.y, 0.5f, 1e-6f);
+    const uint32_t nearestId = found.id;
+
+    // The next closest is (0.6, 0.5), 4.5 pixels away
+    auto skipNearest = [nearestId](const PointOctree::Point& point) { return point.id != nearestId; };
+    ASSERT_TRUE(octree.findNearestOnScreen(identity, VIEWPORT, VIEWPORT, 75.5f, 25.0f, 5.0f, skipNearest, found));
+    EXPECT_NEAR(found.x, 0.6f, 1e-6f);
+    EXPECT_FALSE(octree.findNearestOnScreen(identity, VIEWPORT, VIEWPORT, 75.5f, 25.0f, 4.0f, skipNearest, found));
+
+    // Off the data entirely
+    EXPECT_FALSE(octree.findNearestOnScreen(identity, VIEWPORT, VIEWPORT, -20.0f, -20.0f, 10.0f, nullptr, found));
+}
+
+TEST_F(PointOctreeTest, EmptyTreeFindsNothing) {
+    std::vector<PointOctree::Point> visible;
+    EXPECT_EQ(octree.selectVisible(identity, VIEWPORT, VIEWPORT, 0.0f, visible), 0u);
+    PointOctree::Point found{};
+    EXPECT_FALSE(octree.findNearestOnScreen(identity, VIEWPORT, VIEWPORT, 50.0f, 50.0f, 100.0f, nullptr, found));
+
+    insertPoints(100, 1.0f);
+    octree.clear();
+    EXPECT_EQ(octree.size(), 0u);
+    EXPECT_EQ(octree.selectVisible(identity, VIEWPORT, VIEWPORT, 0.0f, visible), 0u);
+}
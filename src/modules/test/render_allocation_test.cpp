@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "allocation_counter.h"
+#include "../headless_renderer.h"
+#include <QApplication>
+#include <QImage>
+#include <cmath>
+#include <memory>
+
+// Feeds and draws real PlotView frames offscreen and counts the heap
+// allocations of both steps. After a warm-up, taking in a frame's samples
+// and drawing the GL scene must not allocate. The QPainter overlay and the
+// image readback are Qt's and are not counted.
+
+namespace {
+
+// Counts what the GL scene allocates while paintGL() draws it
+class CountingPlotView : public PlotView
+{
+public:
+    uint64_t sceneAllocations = 0;
+
+protected:
+    void paintGL() override
+    {
+        AllocationCounter counter;
+        PlotView::paintGL();
+        sceneAllocations += counter.count();
+    }
+};
+
+} // namespace
+
+class RenderAllocationTest : public ::testing::TestWithParam<PlotView::RealTimeLayout> {
+protected:
+    static constexpr int CHANNEL_COUNT = 2;
+    static constexpr int SAMPLES_PER_FRAME = 64;  // Per channel, about 4 kHz at 60 fps
+    static constexpr double FRAME_PERIOD = 1.0 / 60.0;
+
+    void SetUp() override {
+        renderer = std::make_unique<HeadlessRenderer>(QSize(640, 360), 0);
+        auto countingView = std::make_unique<CountingPlotView>();
+        view = countingView.get();
+        if (!renderer->initialize(std::move(countingView))) {
+            GTEST_SKIP() << "No offscreen OpenGL: " << renderer->errorString().toStdString();
+        }
+        view->setMaxRealTimePoints(2000);
+        view->setRealTimeLayout(GetParam(), 0, 1);
+    }
+
+    // Records of the next frame period, 50 Hz sines on every channel
+    void makeChunk() {
+        chunk.clear();
+        for (int i = 0; i < SAMPLES_PER_FRAME; ++i) {
+            for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                const double value = std::sin(2.0 * M_PI * 50.0 * time + channel);
+                chunk += QByteArray::number(time, 'f', 6) + ',' + QByteArray::number(value, 'f', 4) + ','
+                         + QByteArray::number(channel) + '\n';
+            }
+            time += FRAME_PERIOD / SAMPLES_PER_FRAME;
+        }
+    }
+
+    // Building the records is not counted, only the view's work
+    void runFrames(int count) {
+        for (int f = 0; f < count; ++f) {
+            makeChunk();
+            {
+                AllocationCounter counter;
+                view->replayData(chunk, time);
+                ingestAllocations += counter.count();
+            }
+            renderer->renderFrame();
+        }
+    }
+
+    std::unique_ptr<HeadlessRenderer> renderer;
+    CountingPlotView* view = nullptr;
+    QByteArray chunk;
+    double time = 0.0;
+    uint64_t ingestAllocations = 0;
+};
+
+TEST_P(RenderAllocationTest, SteadyStateFramesDoNotAllocate) {
+    // Long enough to fill the real-time buffers and the statistics window
+    runFrames(200);
+    ingestAllocations = 0;
+    view->sceneAllocations = 0;
+
+    runFrames(300);
+    EXPECT_EQ(ingestAllocations, 0u);
+    EXPECT_EQ(view->sceneAllocations, 0u);
+    EXPECT_FALSE(renderer->finish().isNull());
+}
+
+INSTANTIATE_TEST_SUITE_P(Layouts, RenderAllocationTest,
+                         ::testing::Values(PlotView::TIME_SERIES_LAYOUT, PlotView::XY_LAYOUT,
+                                           PlotView::HISTOGRAM_LAYOUT));
+
+int main(int argc, char** argv)
+{
+    // Headless with software GL unless the environment asks otherwise
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    if (!qEnvironmentVariableIsSet("LIBGL_ALWAYS_SOFTWARE")) {
+        qputenv("LIBGL_ALWAYS_SOFTWARE", "1");
+    }
+
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,270 @@
+#include <gtest/gtest.h>
+#include "../headless_renderer.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <QThread>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+// Replays the reference session through DataReceiver into an offscreen
+// PlotView and holds the results to the budgets of
+// data/replay_baseline.json.
+//
+// The paced run delivers records as a live source would at a multiple of
+// real time and measures frame time and end-to-end latency. The unpaced
+// run feeds the same frames back to back and measures throughput, which
+// pacing would cap at the replay rate.
+//
+// Budgets are the measurements recorded in the baseline on a reference
+// machine, widened by its margin (times may grow and throughput may shrink
+// by that factor), so the test catches regressions that cost multiples
+// rather than noise. Running with CALIBVIEW_RECORD_BASELINE=1 records new
+// measurements. Until a value is recorded, the baseline's absolute limit
+// for it applies; a value with neither fails.
+
+namespace {
+
+double percentile(std::vector<double> values, double level)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    const size_t index = std::min(values.size() - 1, static_cast<size_t>(level * values.size()));
+    return values[index];
+}
+
+} // namespace
+
+class ReplayRegressionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const QString dataDir = CALIBVIEW_TEST_DATA_DIR;
+        baselinePath = dataDir + "/replay_baseline.json";
+        QFile baselineFile(baselinePath);
+        ASSERT_TRUE(baselineFile.open(QIODevice::ReadOnly)) << baselinePath.toStdString();
+        baseline = QJsonDocument::fromJson(baselineFile.readAll()).object();
+        ASSERT_FALSE(baseline.isEmpty());
+
+        QFile sessionFile(dataDir + "/" + baseline["session"].toString());
+        ASSERT_TRUE(sessionFile.open(QIODevice::ReadOnly)) << sessionFile.fileName().toStdString();
+        session = sessionFile.readAll();
+
+        // Timestamp and end of every record line
+        int lineStart = 0;
+        while (lineStart < session.size()) {
+            int lineEnd = session.indexOf('\n', lineStart);
+            if (lineEnd < 0) {
+                lineEnd = session.size();
+            }
+            DataPoint point;
+            if (DataReceiver::parseMessage(session.constData() + lineStart, session.constData() + lineEnd, point)) {
+                timestamps.push_back(point.timestamp);
+                lineEnds.push_back(lineEnd);
+            }
+            lineStart = lineEnd + 1;
+        }
+        ASSERT_FALSE(timestamps.empty());
+
+        speed = baseline["speed"].toDouble(10.0);
+        framePeriod = 1.0 / baseline["frameRate"].toDouble(60.0);
+        const QJsonArray sizeValues = baseline["size"].toArray();
+        size = QSize(sizeValues.at(0).toInt(640), sizeValues.at(1).toInt(360));
+    }
+
+    static bool recording() { return qEnvironmentVariableIntValue("CALIBVIEW_RECORD_BASELINE") != 0; }
+
+    // Holds a measurement to its recorded budget, or to the absolute limit
+    // while none is recorded
+    void checkBudget(const QString& key, double value, bool higherIsBetter) {
+        RecordProperty(key.toStdString(), std::to_string(value));
+        measured[key] = value;
+
+        if (recording()) {
+            return;
+        }
+        const QJsonObject recorded = baseline["measured"].toObject();
+        const QJsonObject limits = baseline["limits"].toObject();
+        double budget = 0.0;
+        if (recorded.contains(key)) {
+            const double margin = baseline["margin"].toDouble(3.0);
+            budget = higherIsBetter ? recorded[key].toDouble() / margin : recorded[key].toDouble() * margin;
+        } else if (limits.contains(key)) {
+            budget = limits[key].toDouble();
+            unrecorded << key;
+        } else {
+            ADD_FAILURE() << "No recorded measurement or limit for " << key.toStdString() << " in "
+                          << baselinePath.toStdString();
+            return;
+        }
+
+        if (higherIsBetter) {
+            EXPECT_GE(value, budget) << key.toStdString();
+        } else {
+            EXPECT_LE(value, budget) << key.toStdString();
+        }
+    }
+
+    // Writes this test's measurements into the baseline, or notes which
+    // budgets are still absolute limits
+    void finishBudgets() {
+        if (recording()) {
+            QFile file(baselinePath);
+            ASSERT_TRUE(file.open(QIODevice::ReadOnly)) << baselinePath.toStdString();
+            QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+            file.close();
+
+            QJsonObject recorded = root["measured"].toObject();
+            for (auto it = measured.constBegin(); it != measured.constEnd(); ++it) {
+                recorded[it.key()] = it.value();
+            }
+            root["measured"] = recorded;
+            ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate)) << baselinePath.toStdString();
+            file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+            std::cout << "Recorded " << measured.size() << " measurements in " << baselinePath.toStdString() << std::endl;
+            return;
+        }
+        if (!unrecorded.isEmpty()) {
+            std::cout << "Absolute limits used for " << unrecorded.join(", ").toStdString()
+                      << "; record measurements with CALIBVIEW_RECORD_BASELINE=1 on the reference machine" << std::endl;
+        }
+    }
+
+    // Records sent by session time sessionNow, starting at next. Feeds them
+    // to the view and returns whether there were any.
+    bool feedUntil(PlotView* view, double sessionNow, double arrivalTime, size_t& next, int& chunkStart) {
+        const size_t first = next;
+        while (next < timestamps.size() && timestamps[next] <= sessionNow) {
+            ++next;
+        }
+        if (next == first) {
+            return false;
+        }
+        const int chunkEnd = lineEnds[next - 1] + 1;
+        view->replayData(session.mid(chunkStart, chunkEnd - chunkStart), arrivalTime);
+        chunkStart = chunkEnd;
+        return true;
+    }
+
+    QString baselinePath;
+    QJsonObject baseline;
+    QByteArray session;
+    std::vector<double> timestamps;
+    std::vector<int> lineEnds;
+
+    double speed = 10.0;
+    double framePeriod = 1.0 / 60.0;
+    QSize size;
+
+    QJsonObject measured;
+    QStringList unrecorded;
+};
+
+TEST_F(ReplayRegressionTest, PacedFramesStayWithinBudgets) {
+    HeadlessRenderer renderer(size, baseline["samples"].toInt(0));
+    if (!renderer.initialize()) {
+        GTEST_SKIP() << "No offscreen OpenGL: " << renderer.errorString().toStdString();
+    }
+    PlotView* view = renderer.view();
+
+    std::vector<double> frameMs;
+    std::vector<double> latencyMs;
+    size_t next = 0;
+    int chunkStart = 0;
+    double nextFrame = 0.0;
+
+    QElapsedTimer wallClock;
+    wallClock.start();
+    while (next < timestamps.size()) {
+        // Frames at the display rate; a late frame starts right away
+        double now = wallClock.nsecsElapsed() * 1e-9;
+        if (now < nextFrame) {
+            QThread::usleep(static_cast<unsigned long>((nextFrame - now) * 1e6));
+            now = wallClock.nsecsElapsed() * 1e-9;
+        }
+        nextFrame = std::max(nextFrame + framePeriod, now);
+
+        // Everything the source has sent by now
+        const size_t first = next;
+        const bool fed = feedUntil(view, timestamps.front() + now * speed, now, next, chunkStart);
+        renderer.renderFrame();
+
+        // Latency until the frame showing a record is drawn and submitted;
+        // the oldest record of the frame waited longest
+        const double frameDone = wallClock.nsecsElapsed() * 1e-9;
+        frameMs.push_back((frameDone - now) * 1e3);
+        if (fed) {
+            const double sent = (timestamps[first] - timestamps.front()) / speed;
+            latencyMs.push_back((frameDone - sent) * 1e3);
+        }
+    }
+    renderer.finish();
+
+    const double frameP50 = percentile(frameMs, 0.5);
+    const double frameP99 = percentile(frameMs, 0.99);
+    const double latencyP50 = percentile(latencyMs, 0.5);
+    const double latencyP99 = percentile(latencyMs, 0.99);
+    std::cout << "Paced replay of " << timestamps.size() << " samples in " << frameMs.size() << " frames: frame p50 "
+              << frameP50 << " ms, p99 " << frameP99 << " ms, latency p50 " << latencyP50 << " ms, p99 "
+              << latencyP99 << " ms" << std::endl;
+
+    checkBudget("frameMsP50", frameP50, false);
+    checkBudget("frameMsP99", frameP99, false);
+    checkBudget("latencyMsP50", latencyP50, false);
+    checkBudget("latencyMsP99", latencyP99, false);
+    finishBudgets();
+}
+
+TEST_F(ReplayRegressionTest, UnpacedThroughputStaysWithinBudget) {
+    HeadlessRenderer renderer(size, baseline["samples"].toInt(0));
+    if (!renderer.initialize()) {
+        GTEST_SKIP() << "No offscreen OpenGL: " << renderer.errorString().toStdString();
+    }
+    PlotView* view = renderer.view();
+
+    // The paced run's frames, each with a frame period of records, drawn
+    // as fast as the pipeline allows
+    size_t next = 0;
+    int chunkStart = 0;
+    double sessionNow = timestamps.front();
+    size_t frames = 0;
+
+    QElapsedTimer wallClock;
+    wallClock.start();
+    while (next < timestamps.size()) {
+        sessionNow += framePeriod * speed;
+        feedUntil(view, sessionNow, wallClock.nsecsElapsed() * 1e-9, next, chunkStart);
+        renderer.renderFrame();
+        ++frames;
+    }
+    renderer.finish();
+    const double elapsed = wallClock.nsecsElapsed() * 1e-9;
+
+    const double throughput = timestamps.size() / elapsed;
+    std::cout << "Unpaced replay of " << timestamps.size() << " samples in " << frames << " frames over " << elapsed
+              << " s: " << throughput << " samples/s, " << frames / elapsed << " frames/s" << std::endl;
+
+    checkBudget("throughputSamplesPerSecond", throughput, true);
+    finishBudgets();
+}
+
+int main(int argc, char** argv)
+{
+    // Headless with software GL unless the environment asks otherwise
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    if (!qEnvironmentVariableIsSet("LIBGL_ALWAYS_SOFTWARE")) {
+        qputenv("LIBGL_ALWAYS_SOFTWARE", "1");
+    }
+
+    QApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include "../rolling_stats.h"
+#include <cmath>
+
+class RollingStatsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        stats.setWindow(1.0);
+    }
+
+    RollingStats stats;
+};
+
+TEST_F(RollingStatsTest, EmptySummary) {
+    const RollingStats::Summary summary = stats.getSummary();
+    EXPECT_EQ(summary.count, 0u);
+    EXPECT_EQ(summary.mean, 0.0);
+}
+
+TEST_F(RollingStatsTest, MomentsAndExtremesOverTheWindow) {
+    // Values 1..10 within one window
+    for (int i = 0; i < 10; ++i) {
+        stats.add(i * 0.1, static_cast<float>(i + 1));
+    }
+
+    const RollingStats::Summary summary = stats.getSummary();
+    EXPECT_EQ(summary.count, 10u);
+    EXPECT_NEAR(summary.mean, 5.5, 1e-9);
+    EXPECT_NEAR(summary.stddev, std::sqrt(82.5 / 9.0), 1e-9);  // Sample standard deviation
+    EXPECT_FLOAT_EQ(summary.min, 1.0f);
+    EXPECT_FLOAT_EQ(summary.max, 10.0f);
+}
+
+TEST_F(RollingStatsTest, OldSamplesLeaveTheWindow) {
+    for (int i = 0; i < 10; ++i) {
+        stats.add(i * 0.1, static_cast<float>(i + 1));
+    }
+    stats.add(5.0, 100.0f);
+
+    const RollingStats::Summary summary = stats.getSummary();
+    EXPECT_EQ(summary.count, 1u);
+    EXPECT_NEAR(summary.mean, 100.0, 1e-9);
+    EXPECT_FLOAT_EQ(summary.min, 100.0f);
+    EXPECT_FLOAT_EQ(summary.max, 100.0f);
+}
+
+TEST_F(RollingStatsTest, MinAndMaxFollowEviction) {
+    // A spike early in the window must disappear once it slides out
+    stats.add(0.0, 50.0f);
+    for (int i = 1; i <= 20; ++i) {
+        stats.add(i * 0.1, 1.0f);
+    }
+
+    const RollingStats::Summary summary = stats.getSummary();
+    EXPECT_FLOAT_EQ(summary.max, 1.0f);
+    EXPECT_FLOAT_EQ(summary.min, 1.0f);
+}
+
+TEST_F(RollingStatsTest, MedianOfUniformValues) {
+    stats.setQuantileLevels({0.5});
+    for (int i = 0; i < 1000; ++i) {
+        stats.add(i * 0.0005, static_cast<float>(i % 100));
+    }
+
+    const RollingStats::Summary summary = stats.getSummary();
+    ASSERT_EQ(summary.quantiles.size(), 1u);
+    EXPECT_NEAR(summary.quantiles[0], 49.5f, 5.0f);
+}
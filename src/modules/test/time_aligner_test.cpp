@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include "../time_aligner.h"
+#include <cmath>
+
+class TimeAlignerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        aligner.setChannels({0, 1});
+        aligner.setSamplePeriod(0.1);
+        aligner.setLatenessTolerance(0.0);
+    }
+
+    // Channel 0 carries 10 * t, channel 1 carries -t, sampled every 50 ms
+    void pushRamps(int firstStep, int lastStep) {
+        for (int step = firstStep; step <= lastStep; ++step) {
+            const double t = step * 0.05;
+            aligner.push(DataPoint(t, static_cast<float>(10.0 * t), 0));
+            aligner.push(DataPoint(t, static_cast<float>(-t), 1));
+        }
+    }
+
+    TimeAligner aligner;
+};
+
+TEST_F(TimeAlignerTest, NoOutputUntilEveryChannelHasData) {
+    for (int step = 0; step <= 20; ++step) {
+        aligner.push(DataPoint(step * 0.05, 1.0f, 0));
+    }
+
+    std::vector<double> timestamps;
+    std::vector<float> values;
+    EXPECT_EQ(aligner.drainAligned(timestamps, values), 0u);
+    EXPECT_TRUE(timestamps.empty());
+}
+
+TEST_F(TimeAlignerTest, AlignedFramesInterpolateEveryChannel) {
+    pushRamps(0, 20);
+
+    std::vector<double> timestamps;
+    std::vector<float> values;
+    const size_t frames = aligner.drainAligned(timestamps, values);
+
+    ASSERT_GE(frames, 10u);
+    ASSERT_EQ(timestamps.size(), frames);
+    ASSERT_EQ(values.size(), frames * aligner.getChannelCount());
+    for (size_t i = 0; i < frames; ++i) {
+        EXPECT_NEAR(timestamps[i], i * 0.1, 1e-9);
+        EXPECT_NEAR(values[2 * i], 10.0 * timestamps[i], 1e-4);
+        EXPECT_NEAR(values[2 * i + 1], -timestamps[i], 1e-5);
+    }
+}
+
+TEST_F(TimeAlignerTest, DrainingContinuesWhereItStopped) {
+    pushRamps(0, 10);
+    std::vector<double> timestamps;
+    std::vector<float> values;
+    aligner.drainAligned(timestamps, values);
+    const size_t firstFrames = timestamps.size();
+    ASSERT_GT(firstFrames, 0u);
+
+    pushRamps(11, 20);
+    aligner.drainAligned(timestamps, values);
+
+    // One common clock across both calls, no repeated or skipped ticks
+    ASSERT_GT(timestamps.size(), firstFrames);
+    for (size_t i = 1; i < timestamps.size(); ++i) {
+        EXPECT_NEAR(timestamps[i] - timestamps[i - 1], 0.1, 1e-9);
+    }
+}
+
+TEST_F(TimeAlignerTest, MergedOutputIsInTimestampOrder) {
+    aligner.setMergedOutputEnabled(true);
+    aligner.push(DataPoint(1.0, 1.0f, 0));
+    aligner.push(DataPoint(2.0, 2.0f, 0));
+    aligner.push(DataPoint(1.5, 1.5f, 1));
+    aligner.push(DataPoint(2.5, 2.5f, 1));
+
+    std::vector<DataPoint> merged;
+    aligner.drainMerged(merged);
+
+    // Only up to the watermark, the newest time every channel has reached
+    ASSERT_EQ(merged.size(), 3u);
+    EXPECT_DOUBLE_EQ(merged[0].timestamp, 1.0);
+    EXPECT_DOUBLE_EQ(merged[1].timestamp, 1.5);
+    EXPECT_DOUBLE_EQ(merged[2].timestamp, 2.0);
+    EXPECT_DOUBLE_EQ(aligner.getWatermark(), 2.0);
+}
+
+TEST_F(TimeAlignerTest, SamplesOlderThanTheOutputAreDropped) {
+    aligner.setMergedOutputEnabled(true);
+    aligner.push(DataPoint(1.0, 1.0f, 0));
+    aligner.push(DataPoint(1.0, 1.0f, 1));
+    aligner.push(DataPoint(2.0, 2.0f, 0));
+    aligner.push(DataPoint(2.0, 2.0f, 1));
+
+    std::vector<DataPoint> merged;
+    aligner.drainMerged(merged);
+    ASSERT_FALSE(merged.empty());
+
+    aligner.push(DataPoint(0.5, 0.5f, 0));
+    EXPECT_EQ(aligner.getLateSampleCount(), 1u);
+}
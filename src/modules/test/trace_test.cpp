@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "../trace.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+class TraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        tracePath = (std::filesystem::temp_directory_path() /
+                     ("calibview_trace_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".json")).string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(tracePath);
+    }
+
+    std::string writeTrace() {
+        EXPECT_TRUE(Tracer::writeChromeTrace(tracePath));
+        std::ifstream file(tracePath);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    static size_t countOf(const std::string& text, const std::string& pattern) {
+        size_t count = 0;
+        for (size_t position = text.find(pattern); position != std::string::npos; position = text.find(pattern, position + 1)) {
+            ++count;
+        }
+        return count;
+    }
+
+    std::string tracePath;
+};
+
+TEST_F(TraceTest, WritesZonesInChromeTraceFormat) {
+    // Each test records on its own thread so its zones are easy to find
+    std::thread([]() {
+        Tracer::setThreadName("TraceTest \"worker\"");
+        Tracer::record("TraceTest::timed", 1000, 3500);
+    }).join();
+
+    const std::string trace = writeTrace();
+    EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(trace.find("\"name\":\"TraceTest::timed\",\"ts\":1.000,\"dur\":2.500}"), std::string::npos);
+    EXPECT_NE(trace.find("\"args\":{\"name\":\"TraceTest \\\"worker\\\"\"}"), std::string::npos);
+}
+
+TEST_F(TraceTest, KeepsTheMostRecentZonesOfEachThread) {
+    // Far more zones than a thread's ring holds
+    std::thread([]() {
+        for (uint64_t i = 0; i < 200000; ++i) {
+            Tracer::record("TraceTest::early", i, i + 1);
+        }
+        for (uint64_t i = 0; i < 100; ++i) {
+            Tracer::record("TraceTest::late", i, i + 1);
+        }
+    }).join();
+
+    const std::string trace = writeTrace();
+    EXPECT_EQ(countOf(trace, "\"TraceTest::late\""), 100u);
+    const size_t early = countOf(trace, "\"TraceTest::early\"");
+    EXPECT_GT(early, 0u);
+    EXPECT_LT(early, 200000u);
+}
+
+TEST_F(TraceTest, ZonesOfFinishedThreadsSurvive) {
+    std::thread([]() {
+        TraceZone zone("TraceTest::finished");
+    }).join();
+
+    EXPECT_EQ(countOf(writeTrace(), "\"TraceTest::finished\""), 1u);
+}
+
+#ifdef ENABLE_TRACING
+TEST_F(TraceTest, ZoneMacroRecordsTheScope) {
+    std::thread([]() {
+        TRACE_ZONE("TraceTest::macro");
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }).join();
+
+    EXPECT_EQ(countOf(writeTrace(), "\"TraceTest::macro\""), 1u);
+}
+#endif
+
+TEST_F(TraceTest, DumpRequestIsTakenOnce) {
+    EXPECT_FALSE(Tracer::takeDumpRequest());
+    Tracer::requestDump();
+    EXPECT_TRUE(Tracer::takeDumpRequest());
+    EXPECT_FALSE(Tracer::takeDumpRequest());
+}
+
+TEST_F(TraceTest, FailsOnAnUnwritablePath) {
+    EXPECT_FALSE(Tracer::writeChromeTrace("/nonexistent-directory/trace.json"));
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include "../trigger_engine.h"
+
+class TriggerEngineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        TriggerEngine::Settings settings;
+        settings.channel = 0;
+        settings.type = TriggerEngine::RISING_EDGE;
+        settings.level = 0.5f;
+        settings.hysteresis = 0.1f;
+        settings.preTriggerTime = 0.1;
+        settings.postTriggerTime = 0.2;
+        engine.setSettings(settings);
+    }
+
+    // 1 kHz square wave on channel 0 stepping from 0 to 1 at stepTime
+    std::vector<DataPoint> stepBatch(double begin, double end, double stepTime) {
+        std::vector<DataPoint> points;
+        for (double t = begin; t < end; t += 0.001) {
+            points.emplace_back(t, t >= stepTime ? 1.0f : 0.0f, 0);
+        }
+        return points;
+    }
+
+    TriggerEngine engine;
+};
+
+TEST_F(TriggerEngineTest, IdleUntilArmed) {
+    EXPECT_EQ(engine.getState(), TriggerEngine::IDLE);
+    engine.processBatch(stepBatch(0.0, 2.0, 1.0));
+    EXPECT_FALSE(engine.hasNewCapture());
+}
+
+TEST_F(TriggerEngineTest, CapturesAroundTheRisingEdge) {
+    engine.arm();
+    EXPECT_EQ(engine.getState(), TriggerEngine::ARMED);
+
+    engine.processBatch(stepBatch(0.0, 2.0, 1.0));
+    ASSERT_TRUE(engine.hasNewCapture());
+
+    std::vector<DataPoint> frame;
+    double triggerTime = 0.0;
+    ASSERT_TRUE(engine.takeCapture(frame, triggerTime));
+    EXPECT_NEAR(triggerTime, 1.0, 0.0015);
+    ASSERT_FALSE(frame.empty());
+    EXPECT_NEAR(frame.front().timestamp, triggerTime - 0.1, 0.0015);
+    EXPECT_NEAR(frame.back().timestamp, triggerTime + 0.2, 0.0015);
+    EXPECT_FALSE(engine.hasNewCapture());
+}
+
+TEST_F(TriggerEngineTest, SingleShotStopsAfterOneCapture) {
+    TriggerEngine::Settings settings = engine.getSettings();
+    settings.mode = TriggerEngine::SINGLE_SHOT_MODE;
+    engine.setSettings(settings);
+    engine.arm();
+
+    engine.processBatch(stepBatch(0.0, 2.0, 1.0));
+    EXPECT_EQ(engine.getState(), TriggerEngine::STOPPED);
+}
+
+TEST_F(TriggerEngineTest, EdgeSplitAcrossBatches) {
+    engine.arm();
+    engine.processBatch(stepBatch(0.0, 1.0, 1.0));
+    EXPECT_FALSE(engine.hasNewCapture());
+
+    engine.processBatch(stepBatch(1.0, 2.0, 1.0));
+    std::vector<DataPoint> frame;
+    double triggerTime = 0.0;
+    ASSERT_TRUE(engine.takeCapture(frame, triggerTime));
+    EXPECT_NEAR(triggerTime, 1.0, 0.0015);
+}
+
+TEST_F(TriggerEngineTest, ClearHistoryStartsOverInAnotherTimeDomain) {
+    engine.arm();
+
+    // Capture in progress on one clock...
+    engine.processBatch(stepBatch(100.0, 100.95, 100.9));
+    EXPECT_EQ(engine.getState(), TriggerEngine::CAPTURING);
+
+    // ...then timestamps switch to a clock that reads much earlier
+    engine.clearHistory();
+    EXPECT_EQ(engine.getState(), TriggerEngine::ARMED);
+    engine.processBatch(stepBatch(0.0, 2.0, 1.0));
+
+    std::vector<DataPoint> frame;
+    double triggerTime = 0.0;
+    ASSERT_TRUE(engine.takeCapture(frame, triggerTime));
+    EXPECT_NEAR(triggerTime, 1.0, 0.0015);
+    ASSERT_FALSE(frame.empty());
+    EXPECT_NEAR(frame.front().timestamp, triggerTime - 0.1, 0.0015);
+    EXPECT_NEAR(frame.back().timestamp, triggerTime + 0.2, 0.0015);
+}
+
+TEST_F(TriggerEngineTest, LevelTriggerRearmsWhileAboveTheLevel) {
+    TriggerEngine::Settings settings = engine.getSettings();
+    settings.type = TriggerEngine::LEVEL;
+    engine.setSettings(settings);
+    engine.arm();
+
+    // Constantly above the level: every capture is followed by another
+    std::vector<DataPoint> frame;
+    double triggerTime = 0.0;
+    int captures = 0;
+    for (int batch = 0; batch < 20; ++batch) {
+        engine.processBatch(stepBatch(batch * 0.5, (batch + 1) * 0.5, 0.0));
+        if (engine.takeCapture(frame, triggerTime)) {
+            ++captures;
+        }
+    }
+    EXPECT_GE(captures, 15);
+}
+
+TEST_F(TriggerEngineTest, FallingEdgeRearmsAfterRisingAgain) {
+    TriggerEngine::Settings settings = engine.getSettings();
+    settings.type = TriggerEngine::FALLING_EDGE;
+    engine.setSettings(settings);
+    engine.arm();
+
+    // High with a drop at 1 s, back up at 1.5 s and down again at 2 s
+    std::vector<DataPoint> points;
+    for (double t = 0.0; t < 3.0; t += 0.001) {
+        const bool low = (t >= 1.0 && t < 1.5) || t >= 2.0;
+        points.emplace_back(t, low ? 0.0f : 1.0f, 0);
+    }
+
+    std::vector<DataPoint> frame;
+    double triggerTime = 0.0;
+    engine.processBatch(std::vector<DataPoint>(points.begin(), points.begin() + 1600));
+    ASSERT_TRUE(engine.takeCapture(frame, triggerTime));
+    EXPECT_NEAR(triggerTime, 1.0, 0.0015);
+    EXPECT_EQ(engine.getState(), TriggerEngine::ARMED);
+
+    engine.processBatch(std::vector<DataPoint>(points.begin() + 1600, points.end()));
+    ASSERT_TRUE(engine.takeCapture(frame, triggerTime));
+    EXPECT_NEAR(triggerTime, 2.0, 0.0015);
+
+    // Staying low does not fire again
+    engine.processBatch(stepBatch(3.0, 4.0, 10.0));
+    EXPECT_FALSE(engine.hasNewCapture());
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "../voxel_grid.h"
+#include <cmath>
+#include <limits>
+
+class VoxelGridTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        grid.setResolution(0.1f);
+    }
+
+    VoxelGrid grid;
+    bool created = false;
+};
+
+TEST_F(VoxelGridTest, PointsInOneVoxelShareIt) {
+    const size_t first = grid.insert(0.01f, 0.02f, 0.03f, created);
+    EXPECT_TRUE(created);
+    EXPECT_EQ(first, 0u);
+
+    EXPECT_EQ(grid.insert(0.09f, 0.08f, 0.07f, created), first);
+    EXPECT_FALSE(created);
+    EXPECT_EQ(grid.size(), 1u);
+    EXPECT_EQ(grid.getCount(first), 2u);
+
+    EXPECT_EQ(grid.insert(0.11f, 0.02f, 0.03f, created), 1u);
+    EXPECT_TRUE(created);
+}
+
+TEST_F(VoxelGridTest, NegativeCoordinatesRoundDown) {
+    // -0.01 and 0.01 straddle the voxel boundary at zero
+    const size_t positive = grid.insert(0.01f, 0.0f, 0.0f, created);
+    const size_t negative = grid.insert(-0.01f, 0.0f, 0.0f, created);
+    EXPECT_NE(positive, negative);
+    EXPECT_EQ(grid.insert(-0.09f, 0.0f, 0.0f, created), negative);
+}
+
+TEST_F(VoxelGridTest, RunningMeanRepresentsAllPoints) {
+    grid.setMode(VoxelGrid::RUNNING_MEAN);
+    const size_t index = grid.insert(0.01f, 0.01f, 0.01f, created);
+    grid.insert(0.03f, 0.05f, 0.07f, created);
+
+    const float* position = grid.getPosition(index);
+    EXPECT_FLOAT_EQ(position[0], 0.02f);
+    EXPECT_FLOAT_EQ(position[1], 0.03f);
+    EXPECT_FLOAT_EQ(position[2], 0.04f);
+}
+
+TEST_F(VoxelGridTest, FirstPointKeepsItsPosition) {
+    grid.setMode(VoxelGrid::FIRST_POINT);
+    const size_t index = grid.insert(0.01f, 0.01f, 0.01f, created);
+    grid.insert(0.03f, 0.05f, 0.07f, created);
+
+    const float* position = grid.getPosition(index);
+    EXPECT_FLOAT_EQ(position[0], 0.01f);
+    EXPECT_FLOAT_EQ(position[1], 0.01f);
+    EXPECT_FLOAT_EQ(position[2], 0.01f);
+    EXPECT_EQ(grid.getCount(index), 2u);
+}
+
+TEST_F(VoxelGridTest, IndicesSurviveTableGrowth) {
+    // Far more voxels than the initial table holds
+    const int side = 30;
+    size_t expected = 0;
+    for (int x = 0; x < side; ++x) {
+        for (int y = 0; y < side; ++y) {
+            for (int z = 0; z < side; ++z) {
+                ASSERT_EQ(grid.insert(x * 0.1f + 0.05f, y * 0.1f + 0.05f, -z * 0.1f - 0.05f, created), expected++);
+                ASSERT_TRUE(created);
+            }
+        }
+    }
+
+    expected = 0;
+    for (int x = 0; x < side; ++x) {
+        for (int y = 0; y < side; ++y) {
+            for (int z = 0; z < side; ++z) {
+                ASSERT_EQ(grid.insert(x * 0.1f + 0.06f, y * 0.1f + 0.06f, -z * 0.1f - 0.06f, created), expected++);
+                ASSERT_FALSE(created);
+            }
+        }
+    }
+    EXPECT_EQ(grid.size(), static_cast<size_t>(side * side * side));
+}
+
+TEST_F(VoxelGridTest, DropsNewVoxelsBeyondTheLimit) {
+    grid.setMaxVoxels(2);
+    grid.insert(0.0f, 0.0f, 0.0f, created);
+    grid.insert(1.0f, 0.0f, 0.0f, created);
+
+    EXPECT_EQ(grid.insert(2.0f, 0.0f, 0.0f, created), VoxelGrid::npos);
+    EXPECT_FALSE(created);
+    EXPECT_EQ(grid.getDroppedCount(), 1u);
+
+    // Existing voxels still take points
+    EXPECT_EQ(grid.insert(1.01f, 0.0f, 0.0f, created), 1u);
+    EXPECT_EQ(grid.size(), 2u);
+}
+
+TEST_F(VoxelGridTest, RejectsNonFinitePoints) {
+    EXPECT_EQ(grid.insert(std::numeric_limits<float>::quiet_NaN(), 0.0f, 0.0f, created), VoxelGrid::npos);
+    EXPECT_EQ(grid.insert(0.0f, std::numeric_limits<float>::infinity(), 0.0f, created), VoxelGrid::npos);
+    EXPECT_EQ(grid.size(), 0u);
+}
+
+TEST_F(VoxelGridTest, ResolutionChangeClears) {
+    grid.insert(0.0f, 0.0f, 0.0f, created);
+    grid.setResolution(0.5f);
+    EXPECT_EQ(grid.size(), 0u);
+    EXPECT_FLOAT_EQ(grid.getResolution(), 0.5f);
+
+    grid.insert(0.1f, 0.1f, 0.1f, created);
+    EXPECT_EQ(grid.insert(0.4f, 0.4f, 0.4f, created), 0u);
+}
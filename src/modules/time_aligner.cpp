@@ -0,0 +1,310 @@
+#include "time_aligner.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace {
+const double kNegativeInfinity = -std::numeric_limits<double>::infinity();
+}
+
+TimeAligner::TimeAligner()
+    : m_capacity(4096)
+    , m_samplePeriod(0.01)
+    , m_interpolationMode(LINEAR_INTERPOLATION)
+    , m_latenessTolerance(0.05)
+    , m_mergedOutputEnabled(false)
+{
+    reset();
+}
+
+void TimeAligner::setChannels(const std::vector<int>& channels)
+{
+    m_channels = channels;
+    m_buffers.assign(m_channels.size(), ChannelBuffer());
+    for (auto& buffer : m_buffers) {
+        buffer.samples.resize(m_capacity);
+    }
+    reset();
+}
+
+void TimeAligner::setLookAheadCapacity(size_t samplesPerChannel)
+{
+    m_capacity = std::max<size_t>(2, samplesPerChannel);
+    setChannels(m_channels);
+}
+
+void TimeAligner::setSamplePeriod(double seconds)
+{
+    if (seconds > 0.0) {
+        m_samplePeriod = seconds;
+    }
+}
+
+void TimeAligner::setInterpolationMode(InterpolationMode mode)
+{
+    m_interpolationMode = mode;
+}
+
+void TimeAligner::setLatenessTolerance(double seconds)
+{
+    m_latenessTolerance = std::max(0.0, seconds);
+}
+
+void TimeAligner::setMergedOutputEnabled(bool enabled)
+{
+    m_mergedOutputEnabled = enabled;
+}
+
+void TimeAligner::reset()
+{
+    for (auto& buffer : m_buffers) {
+        buffer.head = 0;
+        buffer.size = 0;
+        buffer.mergeCursor = 0;
+        buffer.resampleCursor = 0;
+        buffer.hasData = false;
+        buffer.newestTimestamp = 0.0;
+    }
+
+    m_hasNextTick = false;
+    m_nextTick = 0.0;
+    m_lastTick = kNegativeInfinity;
+    m_lastMergedTimestamp = kNegativeInfinity;
+    m_forcedWatermark = kNegativeInfinity;
+    m_lateSamples = 0;
+    m_overflowSamples = 0;
+}
+
+void TimeAligner::push(const DataPoint& point)
+{
+    const int index = channelIndex(point.channel);
+    if (index < 0) {
+        return;
+    }
+
+    // Anything at or before already emitted output can no longer be placed
+    const double t = point.timestamp;
+    if (t <= m_lastTick || (m_mergedOutputEnabled && t < m_lastMergedTimestamp)) {
+        ++m_lateSamples;
+        return;
+    }
+
+    ChannelBuffer& buffer = m_buffers[index];
+    if (buffer.size == m_capacity) {
+        dropFront(buffer, 1);
+        ++m_overflowSamples;
+    }
+
+    insertSample(buffer, Sample{t, point.value});
+
+    if (!buffer.hasData || t > buffer.newestTimestamp) {
+        buffer.newestTimestamp = t;
+    }
+    buffer.hasData = true;
+
+    // A channel running far ahead must not wait forever for a stalled one
+    if (buffer.size >= m_capacity * 3 / 4) {
+        m_forcedWatermark = std::max(m_forcedWatermark, buffer.newestTimestamp - m_latenessTolerance);
+    }
+}
+
+void TimeAligner::pushBatch(const std::vector<DataPoint>& points)
+{
+    for (const auto& point : points) {
+        push(point);
+    }
+}
+
+double TimeAligner::getWatermark() const
+{
+    if (m_buffers.empty()) {
+        return kNegativeInfinity;
+    }
+
+    double watermark = std::numeric_limits<double>::infinity();
+    for (const auto& buffer : m_buffers) {
+        if (!buffer.hasData) {
+            watermark = kNegativeInfinity;
+            break;
+        }
+        watermark = std::min(watermark, buffer.newestTimestamp);
+    }
+
+    return std::max(watermark - m_latenessTolerance, m_forcedWatermark);
+}
+
+size_t TimeAligner::drainMerged(std::vector<DataPoint>& out)
+{
+    if (!m_mergedOutputEnabled) {
+        return 0;
+    }
+
+    const double watermark = getWatermark();
+    if (watermark == kNegativeInfinity) {
+        return 0;
+    }
+
+    using HeapEntry = std::pair<double, size_t>;
+    const auto later = std::greater<HeapEntry>();
+
+    m_mergeHeap.clear();
+    for (size_t c = 0; c < m_buffers.size(); ++c) {
+        const ChannelBuffer& buffer = m_buffers[c];
+        if (buffer.mergeCursor < buffer.size && buffer.at(buffer.mergeCursor).timestamp <= watermark) {
+            m_mergeHeap.emplace_back(buffer.at(buffer.mergeCursor).timestamp, c);
+        }
+    }
+    std::make_heap(m_mergeHeap.begin(), m_mergeHeap.end(), later);
+
+    size_t emitted = 0;
+    while (!m_mergeHeap.empty()) {
+        std::pop_heap(m_mergeHeap.begin(), m_mergeHeap.end(), later);
+        const size_t c = m_mergeHeap.back().second;
+        m_mergeHeap.pop_back();
+
+        ChannelBuffer& buffer = m_buffers[c];
+        const Sample& sample = buffer.at(buffer.mergeCursor);
+        out.emplace_back(sample.timestamp, sample.value, m_channels[c]);
+        m_lastMergedTimestamp = sample.timestamp;
+        ++buffer.mergeCursor;
+        ++emitted;
+
+        if (buffer.mergeCursor < buffer.size && buffer.at(buffer.mergeCursor).timestamp <= watermark) {
+            m_mergeHeap.emplace_back(buffer.at(buffer.mergeCursor).timestamp, c);
+            std::push_heap(m_mergeHeap.begin(), m_mergeHeap.end(), later);
+        }
+    }
+
+    for (auto& buffer : m_buffers) {
+        trimConsumed(buffer);
+    }
+
+    return emitted;
+}
+
+size_t TimeAligner::drainAligned(std::vector<double>& timestamps, std::vector<float>& values)
+{
+    if (m_buffers.empty()) {
+        return 0;
+    }
+
+    const double watermark = getWatermark();
+    if (watermark == kNegativeInfinity) {
+        return 0;
+    }
+
+    // Start the common clock at the first tick covered by any channel, and
+    // skip ahead over stretches where no channel has data at all
+    double earliest = std::numeric_limits<double>::infinity();
+    bool anyCovered = false;
+    for (const auto& buffer : m_buffers) {
+        if (buffer.size == 0) {
+            continue;
+        }
+        const double first = buffer.at(buffer.resampleCursor).timestamp;
+        earliest = std::min(earliest, first);
+        if (m_hasNextTick && first <= m_nextTick) {
+            anyCovered = true;
+        }
+    }
+    if (earliest == std::numeric_limits<double>::infinity()) {
+        return 0;
+    }
+    if (!m_hasNextTick || !anyCovered) {
+        const double firstTick = std::ceil(earliest / m_samplePeriod) * m_samplePeriod;
+        m_nextTick = m_hasNextTick ? std::max(m_nextTick, firstTick) : firstTick;
+        m_hasNextTick = true;
+    }
+
+    size_t emitted = 0;
+    while (m_nextTick <= watermark) {
+        timestamps.push_back(m_nextTick);
+        for (auto& buffer : m_buffers) {
+            values.push_back(valueAt(buffer, m_nextTick));
+        }
+        m_lastTick = m_nextTick;
+        m_nextTick += m_samplePeriod;
+        ++emitted;
+    }
+
+    for (auto& buffer : m_buffers) {
+        trimConsumed(buffer);
+    }
+
+    return emitted;
+}
+
+int TimeAligner::channelIndex(int channel) const
+{
+    for (size_t i = 0; i < m_channels.size(); ++i) {
+        if (m_channels[i] == channel) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void TimeAligner::insertSample(ChannelBuffer& buffer, const Sample& sample)
+{
+    // Samples mostly arrive in order, so this rarely shifts more than one slot
+    size_t position = buffer.size;
+    ++buffer.size;
+    while (position > 0 && buffer.at(position - 1).timestamp > sample.timestamp) {
+        buffer.at(position) = buffer.at(position - 1);
+        --position;
+    }
+    buffer.at(position) = sample;
+}
+
+void TimeAligner::dropFront(ChannelBuffer& buffer, size_t count)
+{
+    count = std::min(count, buffer.size);
+    buffer.head = (buffer.head + count) % buffer.samples.size();
+    buffer.size -= count;
+    buffer.mergeCursor = buffer.mergeCursor > count ? buffer.mergeCursor - count : 0;
+    buffer.resampleCursor = buffer.resampleCursor > count ? buffer.resampleCursor - count : 0;
+}
+
+void TimeAligner::trimConsumed(ChannelBuffer& buffer)
+{
+    // Keep everything one of the active outputs still needs. The sample at
+    // the resample cursor is kept as the left bracket of the next tick.
+    size_t consumed = buffer.size;
+    if (m_mergedOutputEnabled) {
+        consumed = std::min(consumed, buffer.mergeCursor);
+    }
+    if (m_hasNextTick) {
+        consumed = std::min(consumed, buffer.resampleCursor);
+    }
+    else {
+        consumed = m_mergedOutputEnabled ? consumed : 0;
+    }
+    dropFront(buffer, consumed);
+}
+
+float TimeAligner::valueAt(ChannelBuffer& buffer, double t) const
+{
+    if (buffer.size == 0) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+
+    size_t cursor = buffer.resampleCursor;
+    while (cursor + 1 < buffer.size && buffer.at(cursor + 1).timestamp <= t) {
+        ++cursor;
+    }
+    buffer.resampleCursor = cursor;
+
+    const Sample& before = buffer.at(cursor);
+    if (before.timestamp > t) {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+
+    if (m_interpolationMode == LINEAR_INTERPOLATION && cursor + 1 < buffer.size) {
+        const Sample& after = buffer.at(cursor + 1);
+        const double fraction = (t - before.timestamp) / (after.timestamp - before.timestamp);
+        return static_cast<float>(before.value + (after.value - before.value) * fraction);
+    }
+
+    return before.value;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "data_point.h"
+
+// Aligns samples from channels with independent clocks and rates.
+//
+// Incoming samples are held in a bounded look-ahead buffer per channel. The
+// watermark (the newest time that every channel has reached, minus the
+// lateness tolerance) decides how far output can be produced:
+//  - drainMerged() emits raw samples of all channels in timestamp order
+//    (streaming k-way merge)
+//  - drainAligned() emits frames on a common clock with one interpolated
+//    value per channel
+// Samples that arrive older than what has already been emitted are dropped.
+class TimeAligner
+{
+public:
+    enum InterpolationMode {
+        LINEAR_INTERPOLATION,
+        HOLD_INTERPOLATION
+    };
+
+    TimeAligner();
+
+    // Configuration (resets all buffered state)
+    void setChannels(const std::vector<int>& channels);
+    void setLookAheadCapacity(size_t samplesPerChannel);
+
+    // Configuration (takes effect for the next emitted output)
+    void setSamplePeriod(double seconds);
+    void setInterpolationMode(InterpolationMode mode);
+    void setLatenessTolerance(double seconds);
+    void setMergedOutputEnabled(bool enabled);
+
+    const std::vector<int>& getChannels() const { return m_channels; }
+    size_t getChannelCount() const { return m_channels.size(); }
+    double getSamplePeriod() const { return m_samplePeriod; }
+    InterpolationMode getInterpolationMode() const { return m_interpolationMode; }
+    double getLatenessTolerance() const { return m_latenessTolerance; }
+
+    void reset();
+
+    // Input
+    void push(const DataPoint& point);
+    void pushBatch(const std::vector<DataPoint>& points);
+
+    // Output, appended to the given containers. Returns the number of
+    // samples/frames emitted. Aligned values are stored row-major with
+    // getChannelCount() values per frame; NaN marks a channel without data.
+    size_t drainMerged(std::vector<DataPoint>& out);
+    size_t drainAligned(std::vector<double>& timestamps, std::vector<float>& values);
+
+    // Diagnostics
+    double getWatermark() const;
+    uint64_t getLateSampleCount() const { return m_lateSamples; }
+    uint64_t getOverflowSampleCount() const { return m_overflowSamples; }
+
+private:
+    struct Sample {
+        double timestamp;
+        float value;
+    };
+
+    // Fixed-capacity ring of samples ordered by timestamp
+    struct ChannelBuffer {
+        std::vector<Sample> samples;
+        size_t head = 0;
+        size_t size = 0;
+        size_t mergeCursor = 0;     // Next sample to emit from drainMerged()
+        size_t resampleCursor = 0;  // Newest sample at or before the next tick
+        bool hasData = false;
+        double newestTimestamp = 0.0;
+
+        const Sample& at(size_t i) const { return samples[(head + i) % samples.size()]; }
+        Sample& at(size_t i) { return samples[(head + i) % samples.size()]; }
+    };
+
+    int channelIndex(int channel) const;
+    void insertSample(ChannelBuffer& buffer, const Sample& sample);
+    void dropFront(ChannelBuffer& buffer, size_t count);
+    void trimConsumed(ChannelBuffer& buffer);
+    float valueAt(ChannelBuffer& buffer, double t) const;
+
+    std::vector<int> m_channels;
+    std::vector<ChannelBuffer> m_buffers;
+    size_t m_capacity;
+
+    double m_samplePeriod;
+    InterpolationMode m_interpolationMode;
+    double m_latenessTolerance;
+    bool m_mergedOutputEnabled;
+
+    // Progress
+    bool m_hasNextTick;
+    double m_nextTick;
+    double m_lastTick;
+    double m_lastMergedTimestamp;
+    double m_forcedWatermark;
+
+    // Scratch heap for the k-way merge, reused between calls
+    std::vector<std::pair<double, size_t>> m_mergeHeap;
+
+    uint64_t m_lateSamples;
+    uint64_t m_overflowSamples;
+};
@@ -0,0 +1,159 @@
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Tracer::s_dumpRequested(false);
+
+namespace {
+
+const size_t kEventCapacity = 1 << 16;  // Per thread, a power of two
+
+struct Event {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> begin{0};
+    std::atomic<uint64_t> end{0};
+};
+
+// Ring written by its thread only. The count is published after the
+// event, so readers see complete events and can tell which ones the
+// writer may have overwritten while they were copying.
+struct ThreadBuffer {
+    explicit ThreadBuffer(int id)
+        : id(id)
+        , events(kEventCapacity)
+    {
+    }
+
+    int id;
+    std::atomic<const char*> name{nullptr};
+    std::vector<Event> events;
+    std::atomic<uint64_t> count{0};
+};
+
+// Buffers are never freed, so zones of finished threads stay dumpable
+std::mutex& registryMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<std::unique_ptr<ThreadBuffer>>& registry()
+{
+    static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    return buffers;
+}
+
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+ThreadBuffer& threadBuffer()
+{
+    if (!t_buffer) {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        auto& buffers = registry();
+        buffers.push_back(std::make_unique<ThreadBuffer>(static_cast<int>(buffers.size()) + 1));
+        t_buffer = buffers.back().get();
+    }
+    return *t_buffer;
+}
+
+const std::chrono::steady_clock::time_point kEpoch = std::chrono::steady_clock::now();
+
+struct CopiedEvent {
+    const char* name;
+    uint64_t begin;
+    uint64_t end;
+};
+
+void writeEscaped(FILE* file, const char* text)
+{
+    for (; *text; ++text) {
+        if (*text == '"' || *text == '\\') {
+            std::fputc('\\', file);
+        }
+        std::fputc(*text, file);
+    }
+}
+
+} // namespace
+
+uint64_t Tracer::now()
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - kEpoch).count());
+}
+
+void Tracer::record(const char* name, uint64_t begin, uint64_t end)
+{
+    ThreadBuffer& buffer = threadBuffer();
+    const uint64_t index = buffer.count.load(std::memory_order_relaxed);
+    Event& event = buffer.events[index & (kEventCapacity - 1)];
+    event.name.store(name, std::memory_order_relaxed);
+    event.begin.store(begin, std::memory_order_relaxed);
+    event.end.store(end, std::memory_order_relaxed);
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::setThreadName(const char* name)
+{
+    threadBuffer().name.store(name, std::memory_order_relaxed);
+}
+
+bool Tracer::writeChromeTrace(const std::string& path)
+{
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+    bool first = true;
+
+    std::lock_guard<std::mutex> lock(registryMutex());
+    std::vector<CopiedEvent> copied;
+    for (const auto& buffer : registry()) {
+        const uint64_t countBefore = buffer->count.load(std::memory_order_acquire);
+        const uint64_t firstIndex = countBefore > kEventCapacity ? countBefore - kEventCapacity : 0;
+
+        copied.clear();
+        for (uint64_t index = firstIndex; index < countBefore; ++index) {
+            const Event& event = buffer->events[index & (kEventCapacity - 1)];
+            copied.push_back({event.name.load(std::memory_order_relaxed),
+                              event.begin.load(std::memory_order_relaxed),
+                              event.end.load(std::memory_order_relaxed)});
+        }
+
+        // Drop the oldest events if the writer wrapped onto them meanwhile
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t countAfter = buffer->count.load(std::memory_order_relaxed);
+        const uint64_t safeIndex = countAfter > kEventCapacity ? countAfter - kEventCapacity + 1 : 0;
+        const size_t skip = static_cast<size_t>(std::min<uint64_t>(copied.size(), safeIndex > firstIndex ? safeIndex - firstIndex : 0));
+
+        const char* threadName = buffer->name.load(std::memory_order_relaxed);
+        if (threadName) {
+            std::fprintf(file, "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":\"",
+                         first ? "" : ",\n", buffer->id);
+            writeEscaped(file, threadName);
+            std::fputs("\"}}", file);
+            first = false;
+        }
+
+        for (size_t i = skip; i < copied.size(); ++i) {
+            const CopiedEvent& event = copied[i];
+            if (!event.name) {
+                continue;
+            }
+            std::fprintf(file, "%s{\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"name\":\"", first ? "" : ",\n", buffer->id);
+            writeEscaped(file, event.name);
+            std::fprintf(file, "\",\"ts\":%.3f,\"dur\":%.3f}", event.begin * 1e-3,
+                         (event.end > event.begin ? event.end - event.begin : 0) * 1e-3);
+            first = false;
+        }
+    }
+
+    std::fputs("\n]}\n", file);
+    return std::fclose(file) == 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Scoped trace zones for finding where frame time goes.
+//
+//   void DataReceiver::onDataReady()
+//   {
+//       TRACE_ZONE("DataReceiver::onDataReady");
+//       ...
+//
+// Each thread records completed zones into its own fixed-size ring; the
+// hot path is two clock reads and a few relaxed stores, with no locks or
+// allocation. writeChromeTrace() saves whatever the rings hold in the
+// Chrome trace-event format, which chrome://tracing and Perfetto open.
+//
+// Builds without ENABLE_TRACING compile TRACE_ZONE to nothing.
+class Tracer
+{
+public:
+    // Shown instead of the thread number in trace viewers
+    static void setThreadName(const char* name);
+
+    // Writes all buffered zones of all threads as trace-event JSON
+    static bool writeChromeTrace(const std::string& path);
+
+    // Async-signal-safe dump request, e.g. from a SIGUSR1 handler; the UI
+    // polls takeDumpRequest() and writes the trace
+    static void requestDump() { s_dumpRequested.store(true, std::memory_order_relaxed); }
+    static bool takeDumpRequest() { return s_dumpRequested.exchange(false, std::memory_order_relaxed); }
+
+    // Nanoseconds on the steady clock
+    static uint64_t now();
+
+    // Zone names must outlive the trace, i.e. be string literals
+    static void record(const char* name, uint64_t begin, uint64_t end);
+
+private:
+    static std::atomic<bool> s_dumpRequested;
+};
+
+class TraceZone
+{
+public:
+    explicit TraceZone(const char* name)
+        : m_name(name)
+        , m_begin(Tracer::now())
+    {
+    }
+
+    ~TraceZone() { Tracer::record(m_name, m_begin, Tracer::now()); }
+
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+    const char* m_name;
+    uint64_t m_begin;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_TRACING
+#define TRACE_ZONE(name) TraceZone TRACE_CONCAT(traceZone, __LINE__)(name)
+#else
+#define TRACE_ZONE(name) do {} while (0)
+#endif
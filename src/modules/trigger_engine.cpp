@@ -0,0 +1,260 @@
+#include "trigger_engine.h"
+#include <algorithm>
+
+namespace {
+const size_t kScanBlock = 16;
+
+// Index of the first value at or above the threshold, or end. Each block
+// is reduced without branches so the compiler can vectorize the compare.
+size_t findFirstAtOrAbove(const float* values, size_t begin, size_t end, float threshold)
+{
+    size_t i = begin;
+    for (; i + kScanBlock <= end; i += kScanBlock) {
+        int hit = 0;
+        for (size_t j = 0; j < kScanBlock; ++j) {
+            hit |= values[i + j] >= threshold;
+        }
+        if (hit) {
+            break;
+        }
+    }
+    for (; i < end; ++i) {
+        if (values[i] >= threshold) {
+            return i;
+        }
+    }
+    return end;
+}
+
+// Index of the first value below the threshold, or end
+size_t findFirstBelow(const float* values, size_t begin, size_t end, float threshold)
+{
+    size_t i = begin;
+    for (; i + kScanBlock <= end; i += kScanBlock) {
+        int hit = 0;
+        for (size_t j = 0; j < kScanBlock; ++j) {
+            hit |= values[i + j] < threshold;
+        }
+        if (hit) {
+            break;
+        }
+    }
+    for (; i < end; ++i) {
+        if (values[i] < threshold) {
+            return i;
+        }
+    }
+    return end;
+}
+}
+
+TriggerEngine::TriggerEngine()
+    : m_state(IDLE)
+    , m_edgeArmed(false)
+    , m_historyHead(0)
+    , m_historySize(0)
+    , m_captureTriggerTime(0.0)
+    , m_completedTriggerTime(0.0)
+    , m_hasNewCapture(false)
+{
+    setHistoryCapacity(65536);
+}
+
+void TriggerEngine::setSettings(const Settings& settings)
+{
+    m_settings = settings;
+    m_settings.hysteresis = std::max(0.0f, m_settings.hysteresis);
+    m_settings.preTriggerTime = std::max(0.0, m_settings.preTriggerTime);
+    m_settings.postTriggerTime = std::max(0.0, m_settings.postTriggerTime);
+
+    if (m_state != IDLE) {
+        arm();
+    }
+}
+
+void TriggerEngine::setHistoryCapacity(size_t samples)
+{
+    m_history.assign(std::max<size_t>(1, samples), DataPoint());
+    m_historyHead = 0;
+    m_historySize = 0;
+}
+
+void TriggerEngine::arm()
+{
+    m_state = ARMED;
+    // Edge triggers need to see the signal on the far side of the level first
+    m_edgeArmed = m_settings.type == LEVEL;
+    m_capture.clear();
+}
+
+void TriggerEngine::disarm()
+{
+    m_state = IDLE;
+    m_capture.clear();
+    m_historySize = 0;
+}
+
+void TriggerEngine::clearHistory()
+{
+    m_historyHead = 0;
+    m_historySize = 0;
+    m_completed.clear();
+    m_hasNewCapture = false;
+    if (m_state == ARMED || m_state == CAPTURING) {
+        arm();
+    } else {
+        m_capture.clear();
+    }
+}
+
+void TriggerEngine::processBatch(const std::vector<DataPoint>& points)
+{
+    size_t i = 0;
+    const size_t count = points.size();
+
+    while (i < count) {
+        switch (m_state) {
+        case IDLE:
+            return;
+
+        case STOPPED:
+            // Keep history fresh so a re-arm has its pre-trigger window
+            for (; i < count; ++i) {
+                pushHistory(points[i]);
+            }
+            break;
+
+        case ARMED:
+        {
+            const size_t triggerIndex = findTrigger(points, i);
+            for (; i < triggerIndex; ++i) {
+                pushHistory(points[i]);
+            }
+            if (triggerIndex < count) {
+                startCapture(points[triggerIndex]);
+                pushHistory(points[triggerIndex]);
+                ++i;
+            }
+        }
+        break;
+
+        case CAPTURING:
+        {
+            const double captureEnd = m_captureTriggerTime + m_settings.postTriggerTime;
+            for (; i < count && points[i].timestamp <= captureEnd; ++i) {
+                m_capture.push_back(points[i]);
+                pushHistory(points[i]);
+            }
+            if (i < count) {
+                finishCapture();
+            }
+        }
+        break;
+        }
+    }
+}
+
+bool TriggerEngine::takeCapture(std::vector<DataPoint>& frame, double& triggerTime)
+{
+    if (!m_hasNewCapture) {
+        return false;
+    }
+
+    // Swap so both buffers keep their capacity for the next capture
+    frame.swap(m_completed);
+    m_completed.clear();
+    triggerTime = m_completedTriggerTime;
+    m_hasNewCapture = false;
+    return true;
+}
+
+void TriggerEngine::pushHistory(const DataPoint& point)
+{
+    const size_t capacity = m_history.size();
+    m_history[(m_historyHead + m_historySize) % capacity] = point;
+    if (m_historySize < capacity) {
+        ++m_historySize;
+    }
+    else {
+        m_historyHead = (m_historyHead + 1) % capacity;
+    }
+}
+
+size_t TriggerEngine::findTrigger(const std::vector<DataPoint>& points, size_t begin)
+{
+    const size_t count = points.size();
+    const float sign = m_settings.type == FALLING_EDGE ? -1.0f : 1.0f;
+    const float level = sign * m_settings.level;
+    const float rearmLevel = level - m_settings.hysteresis;
+
+    // Gather the trigger channel into a contiguous array
+    m_scanValues.clear();
+    m_scanIndices.clear();
+    for (size_t i = begin; i < count; ++i) {
+        if (points[i].channel == m_settings.channel) {
+            m_scanValues.push_back(sign * points[i].value);
+            m_scanIndices.push_back(i);
+        }
+    }
+
+    const float* values = m_scanValues.data();
+    const size_t scanCount = m_scanValues.size();
+    size_t k = 0;
+    while (k < scanCount) {
+        if (!m_edgeArmed) {
+            k = findFirstBelow(values, k, scanCount, rearmLevel);
+            if (k == scanCount) {
+                break;
+            }
+            m_edgeArmed = true;
+            ++k;
+        }
+        else {
+            k = findFirstAtOrAbove(values, k, scanCount, level);
+            if (k == scanCount) {
+                break;
+            }
+            m_edgeArmed = false;
+            return m_scanIndices[k];
+        }
+    }
+
+    return count;
+}
+
+void TriggerEngine::startCapture(const DataPoint& triggerPoint)
+{
+    m_captureTriggerTime = triggerPoint.timestamp;
+    m_capture.clear();
+
+    // Copy the pre-trigger window out of the history ring
+    const size_t capacity = m_history.size();
+    const double windowStart = m_captureTriggerTime - m_settings.preTriggerTime;
+    size_t first = m_historySize;
+    while (first > 0 && m_history[(m_historyHead + first - 1) % capacity].timestamp >= windowStart) {
+        --first;
+    }
+    for (size_t i = first; i < m_historySize; ++i) {
+        m_capture.push_back(m_history[(m_historyHead + i) % capacity]);
+    }
+
+    m_capture.push_back(triggerPoint);
+    m_state = CAPTURING;
+}
+
+void TriggerEngine::finishCapture()
+{
+    m_completed.swap(m_capture);
+    m_capture.clear();
+    m_completedTriggerTime = m_captureTriggerTime;
+    m_hasNewCapture = true;
+
+    if (m_settings.mode == NORMAL_MODE) {
+        // Edge triggers still need the signal back across the level; a
+        // level trigger fires again right away
+        m_state = ARMED;
+        m_edgeArmed = m_settings.type == LEVEL;
+    } else {
+        m_state = STOPPED;
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "data_point.h"
+
+// Oscilloscope-style trigger on one channel of the incoming stream.
+//
+// All samples pass through a ring buffer of recent history. When the
+// trigger condition is met, the pre-trigger part of the window is copied
+// out of the ring, the post-trigger part is collected as it arrives, and
+// the completed frame is handed over through takeCapture().
+//
+// The trigger channel is scanned in fixed-size blocks with branch-free
+// comparisons, so batches where nothing happens cost one pass over the
+// values.
+class TriggerEngine
+{
+public:
+    enum Mode {
+        NORMAL_MODE,      // Re-arm after every capture
+        SINGLE_SHOT_MODE  // Stop after the first capture until armed again
+    };
+
+    enum Type {
+        RISING_EDGE,      // Fire when crossing the level upwards
+        FALLING_EDGE,     // Fire when crossing the level downwards
+        LEVEL             // Fire whenever the value is at or above the level
+    };
+
+    enum State {
+        IDLE,
+        ARMED,
+        CAPTURING,
+        STOPPED
+    };
+
+    struct Settings {
+        int channel = 0;
+        Mode mode = NORMAL_MODE;
+        Type type = RISING_EDGE;
+        float level = 0.0f;
+        float hysteresis = 0.1f;     // Distance from the level needed to re-arm
+        double preTriggerTime = 0.1; // Seconds kept before the trigger
+        double postTriggerTime = 0.4; // Seconds collected after the trigger
+    };
+
+    TriggerEngine();
+
+    void setSettings(const Settings& settings);
+    const Settings& getSettings() const { return m_settings; }
+    void setHistoryCapacity(size_t samples);
+
+    void arm();
+    void disarm();
+    State getState() const { return m_state; }
+
+    // Drops buffered history and captures, e.g. when timestamps switch to
+    // another clock. An armed or capturing trigger starts over armed; a
+    // stopped one stays stopped.
+    void clearHistory();
+
+    void processBatch(const std::vector<DataPoint>& points);
+
+    // Completed captures
+    bool hasNewCapture() const { return m_hasNewCapture; }
+    bool takeCapture(std::vector<DataPoint>& frame, double& triggerTime);
+
+private:
+    void pushHistory(const DataPoint& point);
+    size_t findTrigger(const std::vector<DataPoint>& points, size_t begin);
+    void startCapture(const DataPoint& triggerPoint);
+    void finishCapture();
+
+    Settings m_settings;
+    State m_state;
+    bool m_edgeArmed;
+
+    // History ring of all channels
+    std::vector<DataPoint> m_history;
+    size_t m_historyHead;
+    size_t m_historySize;
+
+    // Trigger channel values of the current batch, sign-adjusted so every
+    // trigger type becomes "at or above the level"
+    std::vector<float> m_scanValues;
+    std::vector<size_t> m_scanIndices;
+
+    // Capture in progress and last completed capture
+    std::vector<DataPoint> m_capture;
+    double m_captureTriggerTime;
+    std::vector<DataPoint> m_completed;
+    double m_completedTriggerTime;
+    bool m_hasNewCapture;
+};
@@ -0,0 +1,139 @@
+#include "voxel_grid.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+const uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+const size_t kInitialTableSize = 1024;
+
+int32_t quantize(float value, float inverseResolution)
+{
+    const double cell = std::floor(static_cast<double>(value) * inverseResolution);
+    const double limit = static_cast<double>(std::numeric_limits<int32_t>::max());
+    return static_cast<int32_t>(std::clamp(cell, -limit, limit));
+}
+}
+
+VoxelGrid::VoxelGrid()
+    : m_resolution(0.01f)
+    , m_inverseResolution(100.0f)
+    , m_mode(RUNNING_MEAN)
+    , m_maxVoxels(std::numeric_limits<uint32_t>::max() - 1)
+    , m_tableMask(0)
+    , m_droppedPoints(0)
+{
+    clear();
+}
+
+void VoxelGrid::setResolution(float voxelSize)
+{
+    if (voxelSize > 0.0f) {
+        m_resolution = voxelSize;
+        m_inverseResolution = 1.0f / voxelSize;
+        clear();
+    }
+}
+
+void VoxelGrid::setMode(Mode mode)
+{
+    m_mode = mode;
+}
+
+void VoxelGrid::setMaxVoxels(size_t maxVoxels)
+{
+    m_maxVoxels = std::min<size_t>(maxVoxels, std::numeric_limits<uint32_t>::max() - 1);
+}
+
+void VoxelGrid::clear()
+{
+    m_table.assign(kInitialTableSize, Slot{0, 0, 0, kEmpty});
+    m_tableMask = kInitialTableSize - 1;
+    m_positions.clear();
+    m_sums.clear();
+    m_counts.clear();
+    m_droppedPoints = 0;
+}
+
+size_t VoxelGrid::insert(float x, float y, float z, bool& created)
+{
+    created = false;
+    if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z)) {
+        return npos;
+    }
+
+    const int32_t ix = quantize(x, m_inverseResolution);
+    const int32_t iy = quantize(y, m_inverseResolution);
+    const int32_t iz = quantize(z, m_inverseResolution);
+
+    size_t position = hash(ix, iy, iz) & m_tableMask;
+    while (m_table[position].index != kEmpty) {
+        Slot& slot = m_table[position];
+        if (slot.ix == ix && slot.iy == iy && slot.iz == iz) {
+            const size_t index = slot.index;
+            ++m_counts[index];
+            if (m_mode == RUNNING_MEAN) {
+                double* sum = &m_sums[index * 3];
+                sum[0] += x;
+                sum[1] += y;
+                sum[2] += z;
+                const double inverseCount = 1.0 / m_counts[index];
+                float* representative = &m_positions[index * 3];
+                representative[0] = static_cast<float>(sum[0] * inverseCount);
+                representative[1] = static_cast<float>(sum[1] * inverseCount);
+                representative[2] = static_cast<float>(sum[2] * inverseCount);
+            }
+            return index;
+        }
+        position = (position + 1) & m_tableMask;
+    }
+
+    if (m_counts.size() >= m_maxVoxels) {
+        ++m_droppedPoints;
+        return npos;
+    }
+
+    const size_t index = m_counts.size();
+    m_table[position] = Slot{ix, iy, iz, static_cast<uint32_t>(index)};
+    m_positions.insert(m_positions.end(), {x, y, z});
+    m_sums.insert(m_sums.end(), {static_cast<double>(x), static_cast<double>(y), static_cast<double>(z)});
+    m_counts.push_back(1);
+    created = true;
+
+    // Keep the load factor at or below one half
+    if (m_counts.size() * 2 > m_table.size()) {
+        rehash(m_table.size() * 2);
+    }
+
+    return index;
+}
+
+uint64_t VoxelGrid::hash(int32_t ix, int32_t iy, int32_t iz)
+{
+    uint64_t h = static_cast<uint64_t>(static_cast<uint32_t>(ix)) * 0x9E3779B97F4A7C15ull;
+    h ^= static_cast<uint64_t>(static_cast<uint32_t>(iy)) * 0xC2B2AE3D27D4EB4Full;
+    h ^= static_cast<uint64_t>(static_cast<uint32_t>(iz)) * 0x165667B19E3779F9ull;
+    // Finalizer from MurmurHash3 to spread the bits over the mask
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return h;
+}
+
+void VoxelGrid::rehash(size_t tableSize)
+{
+    std::vector<Slot> oldTable(tableSize, Slot{0, 0, 0, kEmpty});
+    oldTable.swap(m_table);
+    m_tableMask = tableSize - 1;
+
+    for (const Slot& slot : oldTable) {
+        if (slot.index == kEmpty) {
+            continue;
+        }
+        size_t position = hash(slot.ix, slot.iy, slot.iz) & m_tableMask;
+        while (m_table[position].index != kEmpty) {
+            position = (position + 1) & m_tableMask;
+        }
+        m_table[position] = slot;
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Voxel-hash downsampling of 3D points.
+//
+// Points are quantized to voxels of a configurable size and looked up in
+// an open-addressing hash map (linear probing, power-of-two table grown at
+// half load), so each insert is O(1) amortized. Each voxel keeps one
+// representative position: either the first point that landed in it or
+// the running mean of all of them. Voxels are numbered densely in creation
+// order, which lets callers keep a parallel array (e.g. vertex slots).
+class VoxelGrid
+{
+public:
+    enum Mode {
+        FIRST_POINT,
+        RUNNING_MEAN
+    };
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    VoxelGrid();
+
+    void setResolution(float voxelSize);
+    void setMode(Mode mode);
+    void setMaxVoxels(size_t maxVoxels);
+    float getResolution() const { return m_resolution; }
+    Mode getMode() const { return m_mode; }
+
+    void clear();
+
+    // Adds a point and returns the index of its voxel; created is set when
+    // the voxel is new. Returns npos when a new voxel would exceed the limit.
+    size_t insert(float x, float y, float z, bool& created);
+
+    size_t size() const { return m_counts.size(); }
+    const float* getPosition(size_t index) const { return &m_positions[index * 3]; }
+    uint32_t getCount(size_t index) const { return m_counts[index]; }
+    uint64_t getDroppedCount() const { return m_droppedPoints; }
+
+private:
+    struct Slot {
+        int32_t ix;
+        int32_t iy;
+        int32_t iz;
+        uint32_t index;  // kEmpty for unused slots
+    };
+
+    static uint64_t hash(int32_t ix, int32_t iy, int32_t iz);
+    void rehash(size_t tableSize);
+
+    float m_resolution;
+    float m_inverseResolution;
+    Mode m_mode;
+    size_t m_maxVoxels;
+
+    std::vector<Slot> m_table;
+    size_t m_tableMask;
+
+    // Per voxel, indexed by voxel number
+    std::vector<float> m_positions;  // Representative xyz
+    std::vector<double> m_sums;      // Running sums for the mean
+    std::vector<uint32_t> m_counts;
+
+    uint64_t m_droppedPoints;
+};